@@ -0,0 +1,172 @@
+#include "shell.h"
+
+/**
+ * ahead_sig - takes the state of the directories in PATH
+ * @path: the value of PATH
+ * Return: a hash of the inode and modification time of each directory,
+ * which changes when a command is added to one or removed from it; 0
+ * when PATH has a relative directory, whose commands depend on the
+ * working directory, and nothing is to be looked up ahead
+ */
+static unsigned long ahead_sig(const char *path)
+{
+	unsigned long sig = 5381;
+	char dir[PATH_MAX];
+	const char *end;
+	struct stat st;
+	size_t n;
+
+	for (; ; path = end + 1)
+	{
+		end = strchr(path, ':');
+		n = end != NULL ? (size_t)(end - path) : strlen(path);
+		if (n == 0 || *path != '/' || n >= sizeof(dir))
+			return (0);
+		memcpy(dir, path, n);
+		dir[n] = '\0';
+		if (stat(dir, &st) == 0)
+			sig = sig * 33 + st.st_ino * 31 +
+				st.st_mtim.tv_sec * 7 + st.st_mtim.tv_nsec;
+		if (end == NULL)
+			return (sig != 0 ? sig : 1);
+	}
+}
+
+/**
+ * ahead_find - looks up a command in PATH before it is run
+ * @name: the command
+ * @path: the value of PATH
+ * Return: its full path, now in the lookup cache, or NULL
+ *
+ * Unlike cmd_lookup this gives up on a file of that name that is there
+ * but not executable, as the command running may be about to make it so;
+ * what else would change the result changes ahead_sig, taken before the
+ * first lookup that ahead_check has not yet seen through.
+ */
+static const char *ahead_find(const char *name, const char *path)
+{
+	char full[PATH_MAX];
+	const char *end;
+	int n;
+
+	if (g_sh.cmdpath == NULL || strcmp(g_sh.cmdpath, path) != 0)
+		return (NULL);
+	if (!g_sh.ahead.added && (g_sh.ahead.sig = ahead_sig(path)) == 0)
+		return (NULL);
+	for (; ; path = end + 1)
+	{
+		end = strchr(path, ':');
+		end = end != NULL ? end : path + strlen(path);
+		n = snprintf(full, sizeof(full), "%.*s/%s", (int)(end - path),
+			path, name);
+		if (n <= 0 || (size_t)n >= sizeof(full))
+			return (NULL);
+		if (access(full, X_OK) == 0)
+		{
+			g_sh.ahead.added = 1;
+			g_sh.ahead.until = g_sh.ahead.done + 1;
+			jc_add(name, g_sh.cmdpath, full);
+			return (cmd_add(name, full));
+		}
+		if (errno != ENOENT || *end == '\0')
+			return (NULL);
+	}
+}
+
+/**
+ * ahead_node - looks up the commands of a command ahead of time
+ * @a: the look-ahead stage
+ * @n: the command, or a part of it
+ * @path: the value of PATH
+ *
+ * Only command names that need no expansion are looked up, so nothing a
+ * command before them sets can change what they are. Each binary found
+ * is read into the page cache in the background with posix_fadvise.
+ */
+static void ahead_node(ahead_t *a, node_t *n, const char *path)
+{
+	hent_t *e;
+	const char *w, *full;
+	int i, fd;
+
+	for (i = 0; i < n->nkids; i++)
+		ahead_node(a, n->kids[i], path);
+	if (n->type != N_CMD)
+		return;
+	for (i = 0; i < n->nwords && assign_len(n->words[i]) > 0; i++)
+		;
+	w = i < n->nwords ? n->words[i] : NULL;
+	if (w == NULL || strpbrk(w, "$`'\"\\*?[~/") != NULL ||
+		cmd_inproc(w) || alias_lookup(w) != NULL)
+		return;
+	e = ht_find(&g_sh.cmds, w);
+	full = e != NULL ? e->val : ahead_find(w, path);
+	if (full == NULL || ht_find(&a->seen, full) != NULL ||
+		ht_insert(&a->seen, full) == NULL)
+		return;
+	fd = open(full, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return;
+	posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+	close(fd);
+}
+
+/**
+ * ahead_run - works ahead on the next commands of the script
+ *
+ * Runs while an external command does, between its start and the wait,
+ * so the work costs no time. Commands worked on for an earlier value of
+ * PATH are worked on again.
+ */
+void ahead_run(void)
+{
+	ahead_t *a = &g_sh.ahead;
+	const char *path = var_get("PATH");
+	unsigned int ph, end;
+	node_t *n;
+
+	if (a->lines == 0 || a->next >= a->n || path == NULL)
+		return;
+	ph = ht_hash(path);
+	if (ph != a->ph || a->done < a->next)
+		a->done = a->next;
+	a->ph = ph;
+	end = a->next + a->lines < a->n ? a->next + a->lines : a->n;
+	if (a->done >= end || ahead_check())
+		return;
+	for (; a->done < end; a->done++)
+	{
+		n = a->kids != NULL ? a->kids[a->done] : cache_node(a->c,
+			a->done);
+		if (n != NULL)
+			ahead_node(a, n, path);
+		if (n != NULL && a->kids == NULL)
+			node_free(n);
+	}
+}
+
+/**
+ * ahead_check - drops what was looked up ahead once it may be stale
+ * Return: 1 when it was dropped, 0 otherwise
+ *
+ * Runs whenever an external command finishes, until every command looked
+ * up ahead has been started. When a directory in PATH gained or lost a
+ * command, the lookup cache is emptied and the lookups are done again.
+ */
+int ahead_check(void)
+{
+	ahead_t *a = &g_sh.ahead;
+	const char *path = var_get("PATH");
+
+	if (!a->added)
+		return (0);
+	if (path == NULL || ahead_sig(path) != a->sig)
+	{
+		cmd_clear();
+		a->added = 0;
+		a->done = a->next;
+		return (1);
+	}
+	a->added = a->next < a->until;
+	return (0);
+}
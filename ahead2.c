@@ -0,0 +1,23 @@
+#include "shell.h"
+
+/**
+ * ahead_at - tells the --lookahead stage where a script has got to
+ * @kids: its top level commands, NULL when it runs compiled
+ * @c: its compiled form, NULL when it was parsed
+ * @n: number of top level commands, 0 once the script is done
+ * @next: the first top level command not started yet
+ */
+void ahead_at(node_t **kids, struct cache_s *c, unsigned int n,
+unsigned int next)
+{
+	ahead_t *a = &g_sh.ahead;
+
+	if (a->lines == 0)
+		return;
+	if (kids != a->kids || c != a->c || n != a->n)
+		a->done = a->until = 0;
+	a->kids = kids;
+	a->c = c;
+	a->n = n;
+	a->next = next;
+}
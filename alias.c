@@ -0,0 +1,126 @@
+#include "shell.h"
+
+/**
+ * alias_free - releases an alias
+ * @a: the alias, may be NULL
+ */
+static void alias_free(alias_t *a)
+{
+	int i;
+
+	if (a == NULL)
+		return;
+	for (i = 0; i < a->nwords; i++)
+		free(a->words[i]);
+	free(a->words);
+	free(a->value);
+	free(a);
+}
+
+/**
+ * alias_set - defines or replaces an alias from a name=value argument
+ * @arg: the argument
+ * Return: 0 on success, -1 if the value is not a plain list of words
+ */
+int alias_set(char *arg)
+{
+	char *eq = strchr(arg, '=');
+	alias_t *a = calloc(1, sizeof(*a));
+	node_t words = {N_CMD, 0, 0, 0, NULL, 0, NULL};
+	hent_t *e;
+
+	*eq = '\0';
+	if (a == NULL || split_words(eq + 1, &words) != 0 ||
+		words.nwords == 0 || (a->value = strdup(eq + 1)) == NULL ||
+		(e = ht_insert(&g_sh.aliases, arg)) == NULL)
+	{
+		*eq = '=';
+		while (words.nwords > 0)
+			free(words.words[--words.nwords]);
+		free(words.words);
+		alias_free(a);
+		return (-1);
+	}
+	*eq = '=';
+	a->nwords = words.nwords;
+	a->words = words.words;
+	alias_free(e->val);
+	e->val = a;
+	return (0);
+}
+
+/**
+ * alias_lookup - finds an alias by name
+ * @name: the name
+ * Return: the alias, or NULL
+ */
+alias_t *alias_lookup(const char *name)
+{
+	hent_t *e = ht_find(&g_sh.aliases, name);
+
+	return (e != NULL ? e->val : NULL);
+}
+
+/**
+ * handle_alias - handles the built-in "alias" command
+ * @args: array of arguments for the command
+ * @shell_name: the name of the shell (e.g., "sh")
+ * @command_count: the count of commands entered since shell execution
+ * Return: 0 on success, 1 if any alias could not be found or defined
+ */
+int handle_alias(char *args[], const char *shell_name, int command_count)
+{
+	unsigned int i;
+	hent_t *e;
+	int status = 0;
+
+	for (i = 0; args[1] == NULL && i < g_sh.aliases.nb; i++)
+		for (e = g_sh.aliases.b[i]; e != NULL; e = e->next)
+			alias_print(e->key, e->val);
+	for (; *++args != NULL;)
+	{
+		e = strchr(*args, '=') ? NULL : ht_find(&g_sh.aliases, *args);
+		if (e != NULL)
+			alias_print(e->key, e->val);
+		else if (strchr(*args, '=') == NULL || alias_set(*args) != 0)
+		{
+			fprintf(stderr, "%s: %d: alias: %s %s\n", shell_name,
+				command_count, *args, strchr(*args, '=') ?
+				"is not a simple command" : "not found");
+			status = 1;
+		}
+	}
+	return (status);
+}
+
+/**
+ * handle_unalias - handles the built-in "unalias" command
+ * @args: array of arguments for the command
+ * @shell_name: the name of the shell (e.g., "sh")
+ * @command_count: the count of commands entered since shell execution
+ * Return: 0 on success, 1 if any alias was not found
+ */
+int handle_unalias(char *args[], const char *shell_name, int command_count)
+{
+	unsigned int i;
+	int status = 0;
+
+	if (args[1] != NULL && strcmp(args[1], "-a") == 0)
+	{
+		for (i = 0; i < g_sh.aliases.nb; i++)
+			while (g_sh.aliases.b[i] != NULL)
+				alias_free(ht_remove(&g_sh.aliases,
+					g_sh.aliases.b[i]->key));
+		return (0);
+	}
+	for (; *++args != NULL;)
+		if (ht_find(&g_sh.aliases, *args) != NULL)
+			alias_free(ht_remove(&g_sh.aliases, *args));
+		else
+		{
+			fprintf(stderr, "%s: %d: unalias: %s not found\n",
+				shell_name, command_count, *args);
+			status = 1;
+		}
+	return (status);
+}
@@ -0,0 +1,83 @@
+#include "shell.h"
+
+/**
+ * alias_print - prints an alias in a form that can be read back
+ * @name: name of the alias
+ * @a: the alias
+ */
+void alias_print(const char *name, alias_t *a)
+{
+	const char *v;
+
+	printf("%s='", name);
+	for (v = a->value; *v; v++)
+		if (*v == '\'')
+			printf("'\\''");
+		else
+			putchar(*v);
+	printf("'\n");
+}
+
+/**
+ * alias_chain - finds the aliases that apply to a command name
+ * @name: the command name
+ * @chain: filled in with the aliases, outermost first
+ * Return: number of aliases in @chain
+ *
+ * Expansion repeats while the first word names another alias, but never
+ * expands the same alias twice, so "alias ls='ls -F'" terminates.
+ */
+static int alias_chain(const char *name, alias_t *chain[8])
+{
+	const char *seen[8];
+	int k, j;
+
+	for (k = 0; k < 8; k++)
+	{
+		for (j = 0; j < k && strcmp(name, seen[j]) != 0; j++)
+			;
+		if (j < k)
+			break;
+		chain[k] = alias_lookup(name);
+		if (chain[k] == NULL)
+			break;
+		seen[k] = name;
+		name = chain[k]->words[0];
+	}
+	return (k);
+}
+
+/**
+ * alias_expand - replaces an aliased command name by the alias words
+ * @args: the argument vector of a command
+ * Return: @args when no alias applies, else a new vector allocated in one
+ * block with copies of the alias words, or NULL on failure
+ */
+char **alias_expand(char *args[])
+{
+	alias_t *chain[8];
+	char **nv, *p;
+	int k = alias_chain(args[0], chain), i, j, n, argc;
+	size_t size;
+
+	if (k == 0)
+		return (args);
+	for (argc = 1; args[argc] != NULL; argc++)
+		;
+	for (n = argc, size = 0, j = 0; j < k; j++)
+		for (n += chain[j]->nwords - 1, i = 0; i < chain[j]->nwords;)
+			size += strlen(chain[j]->words[i++]) + 1;
+	nv = malloc((n + 1) * sizeof(char *) + size);
+	if (nv == NULL)
+		return (NULL);
+	p = (char *)(nv + n + 1);
+	for (n = 0, j = k - 1; j >= 0; j--)
+		for (i = j == k - 1 ? 0 : 1; i < chain[j]->nwords; i++)
+		{
+			nv[n++] = strcpy(p, chain[j]->words[i]);
+			p += strlen(p) + 1;
+		}
+	for (i = 1; i <= argc; i++)
+		nv[n++] = args[i];
+	return (nv);
+}
@@ -0,0 +1,128 @@
+#include "shell.h"
+
+/**
+ * shell_opt - applies a long option that takes a value
+ * @opt: the option
+ * @arg: its value, NULL when it is missing
+ * @shell_name: name of the shell
+ * Return: 0 on success, -1 on failure
+ */
+static int shell_opt(const char *opt, const char *arg, const char *shell_name)
+{
+	static const char *const known[] = {"--metrics", "--trace-events",
+		"--audit", "--audit-full", "--record", "--replay",
+		"--replay-exec", "--lookahead", NULL};
+	int i;
+
+	for (i = 0; known[i] != NULL && strcmp(opt, known[i]) != 0; i++)
+		;
+	if (known[i] == NULL || arg == NULL)
+	{
+		fprintf(stderr, "%s: 0: %s: %s\n", shell_name, opt, known[i] ==
+			NULL ? "unknown option" : "requires an argument");
+		return (-1);
+	}
+	if (strcmp(opt, "--metrics") == 0)
+		return (metrics_open(arg, shell_name));
+	if (strcmp(opt, "--trace-events") == 0)
+		return (trace_open(arg, shell_name));
+	if (strcmp(opt, "--audit") == 0)
+		return (audit_open(arg, shell_name));
+	if (strcmp(opt, "--audit-full") == 0)
+		return (audit_policy(arg, shell_name));
+	if (strcmp(opt, "--record") == 0)
+		return (rec_open(arg, REC_RECORD, shell_name));
+	if (strcmp(opt, "--replay") == 0)
+		return (rec_open(arg, REC_REPLAY, shell_name));
+	if (strcmp(opt, "--replay-exec") == 0)
+		return (g_sh.rec.exec = arg, 0);
+	if (*arg == '\0' || strlen(arg) > 3 || check_for_non_digit(arg))
+	{
+		fprintf(stderr, "%s: 0: %s: %s: invalid number of lines\n",
+			shell_name, opt, arg);
+		return (-1);
+	}
+	g_sh.ahead.lines = atoi(arg) < AHEAD_MAX ? atoi(arg) : AHEAD_MAX;
+	return (0);
+}
+
+/**
+ * shell_opts - handles the long options before the script or -c
+ * @argc: number of arguments
+ * @argv: the arguments
+ * @shell_name: name of the shell
+ * Return: index of the first argument after the options, -1 on error
+ */
+static int shell_opts(int argc, char *argv[], const char *shell_name)
+{
+	int i;
+
+	for (i = 1; i < argc && strncmp(argv[i], "--", 2) == 0; i++)
+		if (argv[i][2] == '\0')
+			return (i + 1);
+		else if (strcmp(argv[i], "--startup-profile") == 0)
+			g_sh.profile = 1;
+		else if (shell_opt(argv[i], i + 1 < argc ? argv[i + 1] : NULL,
+			shell_name) != 0)
+			return (-1);
+		else
+			i++;
+	return (i);
+}
+
+/**
+ * shell_args - handles the command line of the shell
+ * @argc: number of arguments
+ * @argv: the arguments
+ * @shell_name: name of the shell
+ * Return: exit status of the script or -c string, -1 to read commands
+ * from standard input
+ *
+ * Usage: hsh [--startup-profile] [--metrics file] [--trace-events file]
+ * [--audit file [--audit-full drop|block]]
+ * [--record file | --replay file [--replay-exec command]]
+ * [--lookahead lines] [--]
+ * [-c string [name [args...]] | script [args...] | -j N script...]
+ * The first two forms exec their last command in place of the shell
+ * when it is external, so a one command -c costs a single process; -j
+ * runs the scripts side by side, see run_jobs. The rc file runs first,
+ * with $0 the shell and no positional parameters. --replay runs the
+ * input of the recording instead of any given here.
+ */
+int shell_args(int argc, char *argv[], const char *shell_name)
+{
+	int i = shell_opts(argc, argv, shell_name), c;
+
+	if (i < 0)
+		return (2);
+	if (i < argc && strcmp(argv[i], "-j") == 0)
+		return (jobs_args(argc - i - 1, argv + i + 1, shell_name));
+	c = i < argc && strcmp(argv[i], "-c") == 0;
+	g_sh.arg0 = argv[0];
+	g_sh.params = argv + argc;
+	g_sh.nparams = 0;
+	if (c && i + 1 >= argc)
+	{
+		fprintf(stderr, "%s: 0: -c requires an argument\n", shell_name);
+		return (2);
+	}
+	rc_load(shell_name, i == argc && isatty(STDIN_FILENO));
+	if (i + 2 * c < argc)
+	{
+		g_sh.arg0 = argv[i + 2 * c];
+		g_sh.params = argv + i + 2 * c + 1;
+		g_sh.nparams = argc - i - 2 * c - 1;
+	}
+	g_sh.rec.fed = 0;
+	if (g_sh.rec.on == REC_REPLAY)
+		return (rec_replay(shell_name));
+	if (i == argc)
+		return (-1);
+	prof_mark("ready");
+	prof_report();
+	g_sh.tail = 1;
+	if (c)
+		rec_input('c', argv[i + 1], strlen(argv[i + 1]));
+	return (c ? run_string(argv[i + 1], shell_name) :
+		run_script(argv[i], shell_name));
+}
@@ -0,0 +1,122 @@
+#include "shell.h"
+
+/**
+ * audit_drain - writes out everything in the ring
+ * @a: the audit log
+ * @reported: records dropped so far that the log already mentions
+ *
+ * Called by the writer thread only. Dropped records are noted in the
+ * log by a line of their own.
+ */
+static void audit_drain(audit_t *a, unsigned long *reported)
+{
+	unsigned long h = __atomic_load_n(&a->head, __ATOMIC_ACQUIRE);
+	unsigned long t = a->tail, d;
+	size_t off, n;
+	ssize_t w;
+
+	while (t != h)
+	{
+		off = t & (AUDIT_RING - 1);
+		n = h - t < AUDIT_RING - off ? h - t : AUDIT_RING - off;
+		w = write(a->fd, a->ring + off, n);
+		if (w < 0 && errno == EINTR)
+			continue;
+		t += w > 0 ? (size_t)w : n;
+	}
+	__atomic_store_n(&a->tail, t, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&a->space, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&a->blocked, __ATOMIC_SEQ_CST))
+		audit_futex(&a->space, FUTEX_WAKE_PRIVATE, 1, NULL);
+	d = __atomic_load_n(&a->dropped, __ATOMIC_RELAXED);
+	if (d != *reported)
+		dprintf(a->fd, "{\"dropped\":%lu}\n", d - *reported);
+	*reported = d;
+}
+
+/**
+ * audit_thread - the writer thread
+ * @arg: the audit log
+ * Return: NULL
+ */
+static void *audit_thread(void *arg)
+{
+	audit_t *a = arg;
+	struct timespec nap = {0, 200000000};
+	unsigned long reported = 0;
+	int w;
+
+	for (;;)
+	{
+		w = __atomic_load_n(&a->wake, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&a->head, __ATOMIC_SEQ_CST) != a->tail ||
+			__atomic_load_n(&a->dropped, __ATOMIC_RELAXED) !=
+			reported)
+			audit_drain(a, &reported);
+		else if (__atomic_load_n(&a->stop, __ATOMIC_SEQ_CST))
+			return (NULL);
+		else
+			audit_futex(&a->wake, FUTEX_WAIT_PRIVATE, w, &nap);
+	}
+}
+
+/**
+ * audit_open - starts the audit log of --audit
+ * @file: the log, appended to
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 on failure
+ *
+ * The writer runs with every signal blocked, so they keep going to the
+ * shell.
+ */
+int audit_open(const char *file, const char *shell_name)
+{
+	audit_t *a = &g_sh.audit;
+	sigset_t all, old;
+
+	a->fd = open(file, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+	a->ring = a->fd >= 0 ? malloc(AUDIT_RING) : NULL;
+	audit_cwd();
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	errno = a->ring != NULL ? pthread_create(&a->thread, NULL,
+		audit_thread, a) : errno;
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (a->ring == NULL || errno != 0)
+	{
+		fprintf(stderr, "%s: 0: --audit: %s: %s\n", shell_name, file,
+			strerror(errno));
+		return (-1);
+	}
+	a->pid = getpid();
+	a->on = 1;
+	atexit(audit_close);
+	return (0);
+}
+
+/**
+ * audit_close - waits for the writer to log every record, then stops it
+ *
+ * Registered with atexit; forked children, which have no writer, skip it.
+ */
+void audit_close(void)
+{
+	audit_t *a = &g_sh.audit;
+
+	if (!a->on || a->pid != getpid())
+		return;
+	__atomic_store_n(&a->stop, 1, __ATOMIC_SEQ_CST);
+	audit_wake(a);
+	pthread_join(a->thread, NULL);
+	close(a->fd);
+	a->on = 0;
+}
+
+/**
+ * audit_cwd - notes the working directory for the records that follow
+ */
+void audit_cwd(void)
+{
+	if (getcwd(g_sh.audit.cwd, sizeof(g_sh.audit.cwd)) == NULL)
+		strcpy(g_sh.audit.cwd, "");
+}
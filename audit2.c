@@ -0,0 +1,131 @@
+#include "shell.h"
+
+/**
+ * audit_futex - waits on or wakes a futex of the audit ring
+ * @word: the futex
+ * @op: FUTEX_WAIT_PRIVATE or FUTEX_WAKE_PRIVATE
+ * @val: value @word must still hold to wait, or number of waiters to wake
+ * @ts: longest wait, NULL for none
+ * Return: as for the futex system call
+ */
+long audit_futex(int *word, int op, int val, const struct timespec *ts)
+{
+	return (syscall(SYS_futex, word, op, val, ts, NULL, 0));
+}
+
+/**
+ * audit_wake - wakes the writer thread
+ * @a: the audit log
+ */
+void audit_wake(audit_t *a)
+{
+	__atomic_add_fetch(&a->wake, 1, __ATOMIC_SEQ_CST);
+	audit_futex(&a->wake, FUTEX_WAKE_PRIVATE, 1, NULL);
+}
+
+/**
+ * audit_push - puts a record in the ring
+ * @a: the audit log
+ * @s: the record
+ * @len: its length
+ *
+ * When the ring is full the record is dropped and counted, or with
+ * --audit-full block the shell waits for the writer to make room. A
+ * forked child of the shell appends its records to the log itself.
+ */
+static void audit_push(audit_t *a, const char *s, size_t len)
+{
+	unsigned long h = a->head, t;
+	size_t off = h & (AUDIT_RING - 1), n;
+	int sp;
+
+	if (a->direct)
+	{
+		if (write(a->fd, s, len) != (ssize_t)len)
+			a->dropped++;
+		return;
+	}
+	while (len > AUDIT_RING - (h - (t = __atomic_load_n(&a->tail,
+		__ATOMIC_SEQ_CST))))
+	{
+		if (!a->block || len > AUDIT_RING)
+		{
+			__atomic_add_fetch(&a->dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		__atomic_store_n(&a->blocked, 1, __ATOMIC_SEQ_CST);
+		sp = __atomic_load_n(&a->space, __ATOMIC_SEQ_CST);
+		if (len > AUDIT_RING - (h - __atomic_load_n(&a->tail,
+			__ATOMIC_SEQ_CST)))
+		{
+			audit_wake(a);
+			audit_futex(&a->space, FUTEX_WAIT_PRIVATE, sp, NULL);
+		}
+		__atomic_store_n(&a->blocked, 0, __ATOMIC_SEQ_CST);
+	}
+	n = len < AUDIT_RING - off ? len : AUDIT_RING - off;
+	memcpy(a->ring + off, s, n);
+	memcpy(a->ring, s + n, len - n);
+	__atomic_store_n(&a->head, h + len, __ATOMIC_RELEASE);
+	if (h - t <= AUDIT_RING / 2 && h + len - t > AUDIT_RING / 2)
+		audit_wake(a);
+}
+
+/**
+ * audit_policy - handles --audit-full
+ * @arg: "drop" or "block"
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 on an unknown policy
+ */
+int audit_policy(const char *arg, const char *shell_name)
+{
+	if (strcmp(arg, "drop") != 0 && strcmp(arg, "block") != 0)
+	{
+		fprintf(stderr, "%s: 0: --audit-full: %s: expected drop or "
+			"block\n", shell_name, arg);
+		return (-1);
+	}
+	g_sh.audit.block = *arg == 'b';
+	return (0);
+}
+
+/**
+ * audit_cmd - logs a simple command that has finished
+ * @args: its arguments
+ * @status: its exit status
+ * @us: how long it ran, in microseconds
+ * @line: line number it was on
+ *
+ * A record holds the start time in UTC, the working directory, argv, the
+ * path of the external command it ran or null, the exit status, the
+ * duration and the line number.
+ */
+void audit_cmd(char *args[], int status, unsigned long us, int line)
+{
+	audit_t *a = &g_sh.audit;
+	struct timespec ts;
+	struct tm tm;
+	char tbuf[32];
+	unsigned long start;
+	time_t sec;
+	int i, r;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	start = ts.tv_sec * 1000000UL + ts.tv_nsec / 1000 - us;
+	sec = start / 1000000;
+	strftime(tbuf, sizeof(tbuf), "%Y-%m-%dT%H:%M:%S", gmtime_r(&sec, &tm));
+	a->rec.len = 0;
+	r = wbuf_printf(&a->rec, "{\"time\":\"%s.%06luZ\",\"cwd\":", tbuf,
+		start % 1000000) | json_put(&a->rec, a->cwd);
+	r |= wbuf_put(&a->rec, ",\"argv\":[", 9);
+	for (i = 0; args[i] != NULL; i++)
+		r |= (i > 0 ? wbuf_putc(&a->rec, ',') : 0) |
+			json_put(&a->rec, args[i]);
+	r |= wbuf_put(&a->rec, "],\"path\":", 9);
+	r |= g_sh.spawned != NULL ? json_put(&a->rec, g_sh.spawned) :
+		wbuf_put(&a->rec, "null", 4);
+	r |= wbuf_printf(&a->rec, ",\"status\":%d,\"duration_us\":%lu,"
+		"\"command_count\":%d}\n", status, us, line);
+	if (r == 0)
+		audit_push(a, a->rec.s, a->rec.len);
+}
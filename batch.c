@@ -0,0 +1,173 @@
+#include "shell.h"
+
+/**
+ * batch_opts - parses the options of batch
+ * @args: the arguments of batch
+ * @sep: set to NUL for -0
+ * @jobs: set to the number given with -P, the number of CPUs for 0
+ * Return: index of the command, -1 on a usage error
+ */
+static int batch_opts(char *args[], int *sep, int *jobs)
+{
+	int i;
+
+	for (i = 1; args[i] != NULL && args[i][0] == '-'; i++)
+		if (strcmp(args[i], "--") == 0)
+		{
+			i++;
+			break;
+		}
+		else if (strcmp(args[i], "-0") == 0)
+			*sep = '\0';
+		else if (strcmp(args[i], "-P") == 0 && args[i + 1] != NULL &&
+			*args[i + 1] != '\0' &&
+			!check_for_non_digit(args[i + 1]))
+			*jobs = atoi(args[++i]);
+		else
+			return (-1);
+	if (*jobs <= 0)
+		*jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	*jobs = *jobs < 1 ? 1 : *jobs > 1024 ? 1024 : *jobs;
+	return (args[i] != NULL ? i : -1);
+}
+
+/**
+ * batch_room - works out how many bytes of items a command line can take
+ * @fixed: the command and its fixed arguments
+ * Return: the room left
+ *
+ * The kernel's limit, ARG_MAX, covers the arguments and the environment
+ * together, each string with its NUL and pointer. What the environment
+ * and the fixed words take is counted as it is now, and 2048 bytes are
+ * kept for the program name and alignment, as xargs does.
+ */
+static size_t batch_room(char **fixed)
+{
+	long max = sysconf(_SC_ARG_MAX);
+	size_t used = 2048 + 2 * sizeof(char *);
+	char **p;
+
+	for (p = environ; *p != NULL; p++)
+		used += strlen(*p) + 1 + sizeof(char *);
+	for (p = fixed; *p != NULL; p++)
+		used += strlen(*p) + 1 + sizeof(char *);
+	if (max < 0 || (size_t)max < used + 4096)
+		return (4096);
+	return (max - used);
+}
+
+/**
+ * batch_feed - splits a block of input into items
+ * @b: the batch state
+ * @part: the item the previous block ended in the middle of
+ * @p: the block
+ * @n: its length
+ * @sep: byte between items
+ * Return: 0 on success, -1 once no more batches are to start
+ *
+ * Empty items are skipped.
+ */
+static int batch_feed(batch_t *b, wbuf_t *part, const char *p, size_t n,
+int sep)
+{
+	const char *end = p + n, *q;
+
+	for (; p < end; p = q + 1)
+	{
+		q = memchr(p, sep, end - p);
+		if (q == NULL)
+			return (wbuf_put(part, p, end - p));
+		if (part->len > 0)
+		{
+			if (wbuf_put(part, p, q - p) != 0 ||
+				batch_add(b, part->s, part->len) != 0)
+				return (-1);
+			part->len = 0;
+		}
+		else if (q > p && batch_add(b, p, q - p) != 0)
+			return (-1);
+	}
+	return (0);
+}
+
+/**
+ * batch_init - sets up the state of the batch builtin
+ * @b: the state
+ * @fixed: the command and its fixed arguments
+ * @jobs: most batches to run at once
+ * Return: 0 on success, -1 on failure; the path is NULL when the command
+ * was not found
+ */
+static int batch_init(batch_t *b, char **fixed, int jobs)
+{
+	memset(b, 0, sizeof(*b));
+	b->path = fixed[0];
+	if (strchr(fixed[0], '/') == NULL)
+		b->path = cmd_lookup(fixed[0]);
+	while (fixed[b->nfixed] != NULL)
+		b->nfixed++;
+	b->argv = malloc((b->nfixed + 1) * sizeof(*b->argv));
+	b->jobs = malloc(jobs * sizeof(*b->jobs));
+	if (b->argv == NULL || b->jobs == NULL)
+		return (-1);
+	memcpy(b->argv, fixed, b->nfixed * sizeof(*b->argv));
+	b->room = batch_room(fixed);
+	b->maxjobs = jobs;
+	return (0);
+}
+
+/**
+ * handle_batch - handles the built-in "batch" command
+ * @args: "batch", its options, then the command and its fixed arguments
+ * @shell_name: the name of the shell
+ * @command_count: line number, for messages
+ * Return: 0 when every batch succeeded, as for xargs otherwise, 2 on a
+ * usage error
+ *
+ * Usage: batch [-0] [-P jobs] command [arg ...]
+ * Reads items from standard input, one per line or NUL separated with
+ * -0, and runs the command on as many of them at a time as fit on its
+ * command line. Nothing runs when there are no items. Each command gets
+ * /dev/null as its standard input, and starts with the settings of any
+ * prefix builtin batch runs under, such as limit.
+ */
+int handle_batch(char *args[], const char *shell_name, int command_count)
+{
+	static char buf[RB_BLOCK];
+	int sep = '\n', jobs = 1, i = batch_opts(args, &sep, &jobs);
+	wbuf_t part = {NULL, 0, 0};
+	redir_t r;
+	batch_t b;
+	ssize_t n;
+
+	if (i < 0)
+	{
+		fprintf(stderr, "%s: %d: batch: usage: batch [-0] [-P jobs] "
+			"command [arg ...]\n", shell_name, command_count);
+		return (2);
+	}
+	if (batch_init(&b, args + i, jobs) != 0)
+		b.path = NULL, b.status = 1;
+	else if (b.path == NULL)
+	{
+		fprintf(stderr, "%s: %d: batch: %s: not found\n", shell_name,
+			command_count, args[i]);
+		b.status = 127;
+	}
+	b.shell_name = shell_name, b.line = command_count;
+	read_sync();
+	r.n = 1, r.fd[0] = 0, r.own = 1;
+	r.src[0] = open("/dev/null", O_RDONLY | O_CLOEXEC);
+	g_sh.redir = r.src[0] >= 0 ? &r : NULL;
+	while (b.path != NULL && (n = read(0, buf, sizeof(buf))) != 0)
+		if (n < 0 ? errno != EINTR : batch_feed(&b, &part, buf, n,
+			sep) != 0)
+			break;
+	if (b.path != NULL && (part.len == 0 ||
+		batch_add(&b, part.s, part.len) == 0))
+		batch_run(&b);
+	g_sh.redir = NULL;
+	redir_close(&r);
+	free(part.s);
+	return (batch_finish(&b));
+}
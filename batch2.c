@@ -0,0 +1,142 @@
+#include "shell.h"
+
+/**
+ * batch_wait - waits for one of the running batches
+ * @b: the batch state
+ * Return: 0 when a child was reaped, -1 when none is left
+ *
+ * A batch that fails makes the status 123, one that runs out of time 124
+ * and one killed by a signal 125, as with xargs and timeout. A command
+ * that could not be run at all gives 126 or 127, which stops the batches
+ * not started yet.
+ */
+int batch_wait(batch_t *b)
+{
+	pid_t pid = b->njobs == 1 ? b->jobs[0] : -1;
+	int st, i;
+
+	if (b->njobs == 0)
+		return (-1);
+	st = spawn_wait(&pid, &g_sh.spawn);
+	if (st < 0)
+	{
+		b->njobs = 0;
+		return (-1);
+	}
+	for (i = 0; i < b->njobs && b->jobs[i] != pid; i++)
+		;
+	if (i == b->njobs)
+		return (0);
+	b->jobs[i] = b->jobs[--b->njobs];
+	METRIC_ADD(jobs, -1);
+	st = b->timed == 0 ? st : b->timed == 1 ? 124 : 137;
+	trace_end("proc", b->argv[0], pid, st);
+	if (st == 126 || st == 127)
+		b->status = st;
+	else if (b->timed != 0 && b->status < 124)
+		b->status = 124;
+	else if (st > 128 && b->status < 125)
+		b->status = 125;
+	else if (st != 0 && b->status == 0)
+		b->status = 123;
+	return (0);
+}
+
+/**
+ * batch_run - starts the command on the items of the batch
+ * @b: the batch state
+ * Return: 0 on success, -1 once no more batches are to start
+ *
+ * Up to -P batches run at the same time; the oldest of them is waited for
+ * before another starts. A timeout set by the timeout prefix is watched
+ * on each batch, which then run one at a time. Under place -r, each batch
+ * goes to the next CPU or node in turn.
+ */
+int batch_run(batch_t *b)
+{
+	char **argv = b->argv + b->nfixed;
+	spawn_t sp;
+	pid_t pid;
+	int i;
+
+	for (i = 0; i < b->n; i++)
+		argv[i] = b->items.s + b->offs[i];
+	argv[i] = NULL;
+	while (b->njobs >= b->maxjobs && batch_wait(b) == 0)
+		;
+	if (b->status >= 126)
+		return (-1);
+	if (b->n == 0)
+		return (0);
+	METRIC_ADD(externals, 1);
+	sp = g_sh.spawn;
+	place_next(&sp);
+	pid = spawn_start(b->path, b->argv, &sp, b->shell_name, b->line);
+	b->n = 0;
+	b->used = 0;
+	b->items.len = 0;
+	if (pid < 0)
+		return (-1);
+	b->jobs[b->njobs++] = pid;
+	if (sp.timeout_ms == 0)
+		return (0);
+	b->timed = spawn_watch(pid, &sp, b->shell_name, b->line);
+	while (batch_wait(b) == 0)
+		;
+	b->timed = 0;
+	return (0);
+}
+
+/**
+ * batch_add - adds an item to the batch, first starting the batch when
+ * the item would take its command line past the room left
+ * @b: the batch state
+ * @s: the item
+ * @len: its length
+ * Return: 0 on success, -1 on failure or once no more batches are to
+ * start
+ *
+ * An item costs its bytes, a NUL and a pointer, as in the kernel's count.
+ */
+int batch_add(batch_t *b, const char *s, size_t len)
+{
+	size_t cost = len + 1 + sizeof(char *);
+	void *p;
+
+	if (b->n > 0 && b->used + cost > b->room && batch_run(b) != 0)
+		return (-1);
+	if (b->n == b->cap)
+	{
+		p = realloc(b->offs, (b->cap * 2 + 1024) * sizeof(*b->offs));
+		if (p == NULL)
+			return (-1);
+		b->offs = p;
+		p = realloc(b->argv, (b->nfixed + b->cap * 2 + 1025) *
+			sizeof(*b->argv));
+		if (p == NULL)
+			return (-1);
+		b->argv = p;
+		b->cap = b->cap * 2 + 1024;
+	}
+	b->offs[b->n++] = b->items.len;
+	b->used += cost;
+	if (wbuf_put(&b->items, s, len) != 0 || wbuf_putc(&b->items, 0) != 0)
+		return (-1);
+	return (0);
+}
+
+/**
+ * batch_finish - waits for the batches still running and frees the state
+ * @b: the batch state
+ * Return: the status of the batch builtin
+ */
+int batch_finish(batch_t *b)
+{
+	while (batch_wait(b) == 0)
+		;
+	free(b->items.s);
+	free(b->offs);
+	free(b->argv);
+	free(b->jobs);
+	return (b->status);
+}
@@ -0,0 +1,102 @@
+#include "shell.h"
+
+/**
+ * cbuf_rec - appends a 32-bit word to the record area
+ * @b: the buffer
+ * @v: the value
+ * Return: 0 on success, -1 on failure
+ */
+int cbuf_rec(cbuf_t *b, unsigned int v)
+{
+	unsigned int *p, cap = b->rcap ? b->rcap * 2 : 256;
+
+	if (b->nrecs == b->rcap)
+	{
+		p = realloc(b->recs, cap * sizeof(*p));
+		if (p == NULL)
+			return (-1);
+		b->recs = p;
+		b->rcap = cap;
+	}
+	b->recs[b->nrecs++] = v;
+	return (0);
+}
+
+/**
+ * cbuf_rehash - doubles the string table and reinserts every string
+ * @b: the buffer
+ * Return: 0 on success, -1 on failure
+ *
+ * Strings are stored back to back, so the table is rebuilt by walking the
+ * string area rather than the old table.
+ */
+static int cbuf_rehash(cbuf_t *b)
+{
+	unsigned int cap = b->hcap ? b->hcap * 2 : 1024, off, h, i;
+	unsigned int *t = calloc(cap, sizeof(*t));
+	const char *s;
+
+	if (t == NULL)
+		return (-1);
+	for (off = 0; off < b->slen; off += strlen(b->strs + off) + 1)
+	{
+		for (h = 2166136261u, s = b->strs + off; *s; s++)
+			h = (h ^ (unsigned char)*s) * 16777619u;
+		for (i = h & (cap - 1); t[i] != 0; i = (i + 1) & (cap - 1))
+			;
+		t[i] = off + 1;
+	}
+	free(b->hash);
+	b->hash = t;
+	b->hcap = cap;
+	return (0);
+}
+
+/**
+ * cbuf_str - stores a string once and returns its offset
+ * @b: the buffer
+ * @s: the string
+ * Return: offset of the string in the string area, or -1 on failure
+ */
+long cbuf_str(cbuf_t *b, const char *s)
+{
+	unsigned int h = 2166136261u, i, len = strlen(s) + 1, cap, mask;
+	const char *p;
+	char *n;
+
+	if (2 * (b->hused + 1) > b->hcap && cbuf_rehash(b) != 0)
+		return (-1);
+	for (p = s; *p; p++)
+		h = (h ^ (unsigned char)*p) * 16777619u;
+	mask = b->hcap - 1;
+	for (i = h & mask; b->hash[i] != 0; i = (i + 1) & mask)
+		if (strcmp(b->strs + b->hash[i] - 1, s) == 0)
+			return (b->hash[i] - 1);
+	for (cap = b->scap ? b->scap : 4096; cap < b->slen + len; cap *= 2)
+		;
+	if (cap != b->scap)
+	{
+		n = realloc(b->strs, cap);
+		if (n == NULL)
+			return (-1);
+		b->strs = n;
+		b->scap = cap;
+	}
+	memcpy(b->strs + b->slen, s, len);
+	b->hash[i] = b->slen + 1;
+	b->hused++;
+	b->slen += len;
+	return (b->slen - len);
+}
+
+/**
+ * cbuf_free - releases a serialisation buffer
+ * @b: the buffer
+ */
+void cbuf_free(cbuf_t *b)
+{
+	free(b->recs);
+	free(b->strs);
+	free(b->hash);
+	memset(b, 0, sizeof(*b));
+}
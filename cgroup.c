@@ -0,0 +1,176 @@
+#include "shell.h"
+
+/**
+ * cg_root - finds the cgroup v2 directory new leaves are created in
+ * @out: buffer for the path
+ * @size: size of @out
+ * Return: 0 on success, -1 without a cgroup v2 hierarchy
+ *
+ * $HSH_CGROUP names a delegated subtree; otherwise the shell's own
+ * cgroup is used, wherever the cgroup2 file system is mounted.
+ */
+static int cg_root(char *out, size_t size)
+{
+	const char *env = getenv("HSH_CGROUP");
+	char line[PATH_MAX + 256], mnt[PATH_MAX], own[PATH_MAX];
+	FILE *fp;
+	int r;
+
+	if (env != NULL && *env != '\0')
+	{
+		r = snprintf(out, size, "%s", env);
+		return (r > 0 && (size_t)r < size ? 0 : -1);
+	}
+	fp = fopen("/proc/self/mountinfo", "re");
+	mnt[0] = '\0';
+	own[0] = '\0';
+	while (fp != NULL && fgets(line, sizeof(line), fp) != NULL)
+		if (strstr(line, " - cgroup2 ") != NULL &&
+			sscanf(line, "%*s %*s %*s %*s %4095s", mnt) == 1)
+			break;
+	if (fp != NULL)
+		fclose(fp);
+	fp = fopen("/proc/self/cgroup", "re");
+	while (fp != NULL && fgets(line, sizeof(line), fp) != NULL)
+		if (strncmp(line, "0::", 3) == 0)
+			sscanf(line + 3, "%4095s", own);
+	if (fp != NULL)
+		fclose(fp);
+	if (mnt[0] == '\0' || own[0] == '\0')
+		return (-1);
+	r = snprintf(out, size, "%s%s", mnt, strcmp(own, "/") ? own : "");
+	return (r > 0 && (size_t)r < size ? 0 : -1);
+}
+
+/**
+ * cg_put - writes a value to a cgroup file
+ * @dfd: the cgroup directory
+ * @name: the file
+ * @v: the value
+ * Return: 0 on success, -1 on failure
+ */
+static int cg_put(int dfd, const char *name, const char *v)
+{
+	int fd = openat(dfd, name, O_WRONLY | O_CLOEXEC), r;
+
+	if (fd < 0)
+		return (-1);
+	r = write(fd, v, strlen(v)) == (ssize_t)strlen(v) ? 0 : -1;
+	close(fd);
+	return (r);
+}
+
+/**
+ * cg_get - reads a number from a cgroup file
+ * @dfd: the cgroup directory
+ * @name: the file
+ * @key: for flat keyed files, the key of the value; NULL otherwise
+ * Return: the value, -1 if it cannot be read
+ */
+static long cg_get(int dfd, const char *name, const char *key)
+{
+	char buf[4096], *p = buf;
+	int fd = openat(dfd, name, O_RDONLY | O_CLOEXEC);
+	ssize_t n = fd >= 0 ? read(fd, buf, sizeof(buf) - 1) : -1;
+
+	if (fd >= 0)
+		close(fd);
+	if (n <= 0)
+		return (-1);
+	buf[n] = '\0';
+	if (key != NULL)
+	{
+		for (; p != NULL && strncmp(p, key, strlen(key)) != 0;
+			p = strchr(p, '\n') ? strchr(p, '\n') + 1 : NULL)
+			;
+		p = p != NULL ? p + strlen(key) : NULL;
+	}
+	return (p != NULL && (*p == ' ' || key == NULL) ? strtol(p, NULL, 10) :
+		-1);
+}
+
+/**
+ * cg_create - creates the cgroup leaf for the requested limits
+ * @sp: the settings; @fallback gets the limits the leaf cannot enforce
+ * Return: 0 when a leaf was created, -1 otherwise
+ *
+ * The controllers needed are enabled in the parent first; that fails
+ * when the parent holds processes itself, and the limits then fall back
+ * to rlimits in the child.
+ */
+int cg_create(spawn_t *sp)
+{
+	static int seq;
+	char root[PATH_MAX], leaf[PATH_MAX + 64], v[32];
+	int fd, i;
+	const char *ctl[] = {"+memory", "+cpu", "+pids", "+io"};
+	const char *file[] = {"memory.max", "cpu.weight", "pids.max",
+		"io.weight"};
+	long val[4];
+
+	sp->fallback = sp->lim;
+	val[0] = sp->mem, val[1] = sp->cpu_weight;
+	val[2] = sp->pids, val[3] = sp->io_weight;
+	if (cg_root(root, sizeof(root)) != 0)
+		return (-1);
+	sprintf(leaf, "%s/hsh-%d-%d", root, (int)getpid(), seq++);
+	fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	for (i = 0; fd >= 0 && i < 4; i++)
+		if (sp->lim & (1 << i))
+			cg_put(fd, "cgroup.subtree_control", ctl[i]);
+	if (fd >= 0)
+		close(fd);
+	if (mkdir(leaf, 0755) != 0)
+		return (-1);
+	sp->cgfd = open(leaf, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	sp->cgroup = sp->cgfd >= 0 ? strdup(leaf) : NULL;
+	if (sp->cgroup == NULL)
+	{
+		if (sp->cgfd >= 0)
+			close(sp->cgfd);
+		rmdir(leaf);
+		return (-1);
+	}
+	for (i = 0; i < 4; i++)
+	{
+		sprintf(v, "%ld", val[i]);
+		if ((sp->lim & (1 << i)) && cg_put(sp->cgfd, file[i], v) == 0)
+			sp->fallback &= ~(1 << i);
+	}
+	return (0);
+}
+
+/**
+ * cg_finish - reports the peak usage of a limited command and removes its
+ * cgroup leaf
+ * @sp: the settings
+ * @shell_name: name of the shell, for the report
+ * @line: line number, for the report
+ *
+ * Figures the leaf does not keep, or misses because a nested limit ran
+ * the command in a leaf of its own, come from the rusage of the children.
+ */
+void cg_finish(spawn_t *sp, const char *shell_name, int line)
+{
+	long peak = -1, cpu = -1, pids = -1;
+
+	if (sp->cgroup != NULL)
+	{
+		peak = cg_get(sp->cgfd, "memory.peak", NULL);
+		cpu = cg_get(sp->cgfd, "cpu.stat", "usage_usec");
+		pids = cg_get(sp->cgfd, "pids.peak", NULL);
+	}
+	peak = peak > sp->maxrss * 1024 ? peak : sp->maxrss * 1024;
+	cpu = cpu > sp->cpu_us ? cpu : sp->cpu_us;
+	fprintf(stderr, "%s: %d: limit: peak memory %.1fM, cpu %.3fs",
+		shell_name, line, peak / 1048576.0, cpu / 1e6);
+	if (pids >= 0)
+		fprintf(stderr, ", peak pids %ld", pids);
+	fprintf(stderr, "\n");
+	if (sp->cgroup == NULL)
+		return;
+	close(sp->cgfd);
+	rmdir(sp->cgroup);
+	free(sp->cgroup);
+	sp->cgroup = NULL;
+}
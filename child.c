@@ -0,0 +1,79 @@
+#include "shell.h"
+
+/**
+ * shell_child - prepares a forked copy of the shell to run commands
+ *
+ * The copy has no thread draining the --audit ring, so it writes its
+ * records out directly, and it leaves --trace-events to the shell. Any
+ * pending redirections belong to the parent's command, and a pipeline
+ * stage the parent runs may have left SIGPIPE ignored. Pipes the read
+ * builtin reads ahead on belong to the parent's loops, and records of
+ * --record not yet written are the parent's to write.
+ */
+static void shell_child(void)
+{
+	g_sh.audit.direct = g_sh.audit.on;
+	g_sh.trace = NULL;
+	g_sh.redir = NULL;
+	g_sh.rbuf.nown = 0;
+	g_sh.rbuf.pos = g_sh.rbuf.len = 0;
+	g_sh.rec.buf.len = 0;
+	signal(SIGPIPE, SIG_DFL);
+}
+
+/**
+ * shell_fork - forks a copy of the shell to run commands
+ * Return: as for fork; the child is ready to run commands, and is to
+ * leave with shell_exit
+ *
+ * What a child does is never seen by snap_pure, so an rc file that forks,
+ * as for X=$(cat file), is not snapshotted.
+ */
+pid_t shell_fork(void)
+{
+	pid_t pid;
+
+	fflush(NULL);
+	read_sync();
+	if (g_sh.snap > 0)
+		g_sh.snap = -1;
+	pid = fork();
+	if (pid == 0)
+		shell_child();
+	else if (pid < 0)
+		fprintf(stderr, "Fork failed\n");
+	else
+		METRIC_ADD(jobs, 1);
+	return (pid);
+}
+
+/**
+ * wait_status - waits for a child of the shell
+ * @pid: the child
+ * Return: its exit status, 128 plus the signal number if it was killed
+ */
+int wait_status(pid_t pid)
+{
+	int status;
+
+	while (waitpid(pid, &status, 0) < 0)
+		if (errno != EINTR)
+			return (1);
+	METRIC_ADD(jobs, -1);
+	return (WIFSIGNALED(status) ? 128 + WTERMSIG(status) :
+		WEXITSTATUS(status));
+}
+
+/**
+ * shell_exit - leaves a forked copy of the shell
+ * @status: its exit status
+ *
+ * Gives back input the read builtin took ahead and flushes output, but
+ * runs none of the atexit handlers, which belong to the parent.
+ */
+void shell_exit(int status)
+{
+	read_sync();
+	fflush(NULL);
+	_exit(status & 0xff);
+}
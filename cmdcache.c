@@ -0,0 +1,119 @@
+#include "shell.h"
+
+/**
+ * cmd_clear - empties the command lookup cache
+ */
+void cmd_clear(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < g_sh.cmds.nb; i++)
+		while (g_sh.cmds.b[i] != NULL)
+			free(ht_remove(&g_sh.cmds, g_sh.cmds.b[i]->key));
+	free(g_sh.cmdpath);
+	g_sh.cmdpath = NULL;
+}
+
+/**
+ * cmd_add - remembers where a command was found
+ * @name: the command
+ * @path: its full path
+ * Return: the cached path, or NULL on failure
+ */
+const char *cmd_add(const char *name, const char *path)
+{
+	hent_t *e = ht_insert(&g_sh.cmds, name);
+	char *copy = e != NULL ? strdup(path) : NULL;
+
+	if (copy == NULL)
+		return (NULL);
+	free(e->val);
+	e->val = copy;
+	return (copy);
+}
+
+/**
+ * cmd_lookup - finds a command in PATH, remembering where it was
+ * @name: the command, without a "/"
+ * Return: its full path, or NULL if it is not in PATH
+ *
+ * The cache is dropped whenever PATH changes. Entries are not checked
+ * again, so a command that moved is found once its cached path fails to
+ * exec. Under -j a miss first asks the cache the scripts share, and what
+ * a search finds is added there for the others, unless it depends on the
+ * working directory: found through, or after, a relative or empty entry.
+ */
+const char *cmd_lookup(const char *name)
+{
+	const char *path = var_get("PATH"), *dir, *end;
+	char full[PATH_MAX];
+	hent_t *e;
+	int n, rel = 0;
+
+	path = path != NULL ? path : "";
+	if (g_sh.cmdpath == NULL || strcmp(g_sh.cmdpath, path) != 0)
+	{
+		cmd_clear();
+		g_sh.cmdpath = strdup(path);
+	}
+	METRIC_ADD(lookups, 1);
+	e = ht_find(&g_sh.cmds, name);
+	METRIC_ADD(hits, e != NULL);
+	if (e != NULL)
+		return (e->val);
+	dir = jc_find(name, path);
+	if (dir != NULL)
+		return (cmd_add(name, dir));
+	for (dir = path; ; dir = end + 1)
+	{
+		end = strchr(dir, ':');
+		end = end != NULL ? end : dir + strlen(dir);
+		rel |= *dir != '/';
+		n = snprintf(full, sizeof(full), "%.*s%s%s", (int)(end - dir),
+			dir, end > dir ? "/" : "", name);
+		if (n > 0 && (size_t)n < sizeof(full) &&
+			access(full, X_OK) == 0)
+		{
+			if (!rel)
+				jc_add(name, path, full);
+			return (cmd_add(name, full));
+		}
+		if (*end == '\0')
+			return (NULL);
+	}
+}
+
+/**
+ * handle_hash - handles the built-in "hash" command
+ * @args: "hash" and the commands to look up, or "-r"
+ * @shell_name: the name of the shell
+ * @command_count: line number, for messages
+ * Return: 0 on success, 1 if a command was not found
+ *
+ * Without arguments the cached paths are listed; -r empties the cache.
+ * An rc file can name the commands it expects to be run so that they are
+ * part of its startup snapshot.
+ */
+int handle_hash(char *args[], const char *shell_name, int command_count)
+{
+	unsigned int i;
+	hent_t *e;
+	int status = 0;
+
+	if (args[1] != NULL && strcmp(args[1], "-r") == 0)
+	{
+		cmd_clear();
+		return (0);
+	}
+	for (i = 0; args[1] == NULL && i < g_sh.cmds.nb; i++)
+		for (e = g_sh.cmds.b[i]; e != NULL; e = e->next)
+			printf("%s\n", (char *)e->val);
+	for (; *++args != NULL;)
+		if (strchr(*args, '/') == NULL && cmd_lookup(*args) == NULL)
+		{
+			fprintf(stderr, "%s: %d: hash: %s: not found\n",
+				shell_name, command_count, *args);
+			status = 1;
+		}
+	return (status);
+}
@@ -0,0 +1,147 @@
+#include "shell.h"
+
+static trie_t trie;
+static compdir_t *dirs;
+static int ndirs;
+static char *lastpath;
+
+/**
+ * comp_drop - takes the executables of a directory out of the trie
+ * @d: the directory, left to be scanned again
+ */
+static void comp_drop(compdir_t *d)
+{
+	char *e;
+
+	for (e = d->ls.ents; e != NULL && e < d->ls.ents + d->ls.len;
+		e += strlen(e + 1) + 2)
+		trie_add(&trie, e + 1, -1);
+	free(d->ls.ents);
+	memset(&d->ls, 0, sizeof(d->ls));
+	d->ls.racy = 1;
+}
+
+/**
+ * comp_scan - adds the executables of a directory to the trie
+ * @d: the directory, with no executables recorded
+ * @st: stat of the directory taken before the scan
+ *
+ * The names come from dir_list; only regular files with an execute bit,
+ * directly or through a symbolic link, are kept.
+ */
+static void comp_scan(compdir_t *d, struct stat *st)
+{
+	dirlist_t *l = dir_list(d->path);
+	struct stat fst;
+	wbuf_t w;
+	char *e;
+	int fd = l != NULL ? open(d->path, O_RDONLY | O_DIRECTORY |
+		O_CLOEXEC) : -1;
+
+	memset(&w, 0, sizeof(w));
+	for (e = fd >= 0 ? l->ents : NULL; e != NULL && e < l->ents + l->len;
+		e += strlen(e + 1) + 2)
+		if (*e != DT_DIR && fstatat(fd, e + 1, &fst, 0) == 0 &&
+			S_ISREG(fst.st_mode) && (fst.st_mode & 0111) &&
+			wbuf_put(&w, e, strlen(e + 1) + 2) == 0)
+			trie_add(&trie, e + 1, 1);
+	if (fd >= 0)
+		close(fd);
+	d->ls.ents = w.s;
+	d->ls.len = w.len;
+	d->ls.dev = st->st_dev;
+	d->ls.ino = st->st_ino;
+	d->ls.mtim = st->st_mtim;
+	d->ls.ctim = st->st_ctim;
+	d->ls.racy = l == NULL || l->racy;
+}
+
+/**
+ * comp_path - follows a change of PATH
+ * @path: the new value of PATH
+ *
+ * Directories still in PATH keep what was scanned from them; only the
+ * ones that were dropped or added touch the trie.
+ */
+static void comp_path(const char *path)
+{
+	compdir_t *nd = calloc(strlen(path) + 2, sizeof(*nd));
+	const char *p = path, *q;
+	int n = 0, j;
+
+	if (nd == NULL)
+		return;
+	for (; ; p = q + 1, n++)
+	{
+		q = strchr(p, ':');
+		q = q != NULL ? q : p + strlen(p);
+		nd[n].path = q > p ? strndup(p, q - p) : strdup(".");
+		nd[n].ls.racy = 1;
+		for (j = 0; nd[n].path != NULL && j < ndirs; j++)
+			if (dirs[j].path != NULL &&
+				strcmp(dirs[j].path, nd[n].path) == 0)
+			{
+				nd[n].ls = dirs[j].ls;
+				free(dirs[j].path);
+				dirs[j].path = NULL;
+				break;
+			}
+		if (*q == '\0')
+			break;
+	}
+	for (j = 0; j < ndirs; j++)
+		if (dirs[j].path != NULL)
+		{
+			comp_drop(&dirs[j]);
+			free(dirs[j].path);
+		}
+	free(dirs);
+	dirs = nd;
+	ndirs = n + 1;
+	free(lastpath);
+	lastpath = strdup(path);
+}
+
+/**
+ * comp_sync - brings the completion trie up to date
+ * Return: the trie
+ *
+ * The trie is built on first use; afterwards only directories whose
+ * times changed since they were scanned are read again, so a completion
+ * costs one stat per PATH entry.
+ */
+trie_t *comp_sync(void)
+{
+	const char *path = var_get("PATH");
+	char name[64], *p;
+	struct stat st;
+	int i;
+
+	if (trie.len == 0)
+		for (p = BUILTINS; *p; p += *p == ':')
+		{
+			for (i = 0; *p && *p != ':'; p++)
+				name[i++] = *p;
+			name[i] = '\0';
+			trie_add(&trie, name, 1);
+		}
+	if (path == NULL)
+		path = "";
+	if (lastpath == NULL || strcmp(lastpath, path) != 0)
+		comp_path(path);
+	for (i = 0; i < ndirs; i++)
+	{
+		if (dirs[i].path == NULL || stat(dirs[i].path, &st) != 0)
+		{
+			if (dirs[i].ls.ents != NULL)
+				comp_drop(&dirs[i]);
+			continue;
+		}
+		if (!dir_fresh(&dirs[i].ls, &st))
+		{
+			comp_drop(&dirs[i]);
+			comp_scan(&dirs[i], &st);
+		}
+	}
+	return (&trie);
+}
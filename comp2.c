@@ -0,0 +1,113 @@
+#include "shell.h"
+
+/**
+ * comp_cmds - completes a command name from the trie
+ * @word: the partial name
+ * @c: receives the candidates
+ * Return: number of candidates
+ *
+ * The common prefix is found by walking down single-child nodes, so its
+ * cost depends on the length of the name, not on the number of commands.
+ */
+int comp_cmds(const char *word, cands_t *c)
+{
+	trie_t *t = comp_sync();
+	wbuf_t name;
+	int at = trie_find(t, word, strlen(word));
+
+	memset(c, 0, sizeof(*c));
+	memset(&name, 0, sizeof(name));
+	if (at < 0 || wbuf_put(&name, word, strlen(word)) != 0)
+		return (0);
+	at = trie_lcp(t, at, &name);
+	c->lcp = strdup(name.s);
+	c->unique = t->n[at].nterm > 0 && t->n[at].nsub == t->n[at].nterm;
+	c->n = trie_collect(t, at, &name, &c->text, LE_MAXLIST + 1);
+	c->more = c->n > LE_MAXLIST;
+	c->n -= c->more;
+	free(name.s);
+	return (c->n);
+}
+
+/**
+ * comp_common - shortens the common prefix to fit a new candidate
+ * @c: the candidates
+ * @s: the new candidate
+ */
+static void comp_common(cands_t *c, const char *s)
+{
+	size_t i;
+
+	if (c->lcp == NULL)
+	{
+		c->lcp = strdup(s);
+		return;
+	}
+	for (i = 0; c->lcp[i] && c->lcp[i] == s[i]; i++)
+		;
+	c->lcp[i] = '\0';
+}
+
+/**
+ * comp_entry - adds a directory entry as a file name candidate
+ * @c: the candidates
+ * @word: the partial path
+ * @dir: the directory part of @word, to stat symbolic links
+ * @e: the entry, a d_type byte then the name
+ */
+static void comp_entry(cands_t *c, const char *word, const char *dir,
+char *e)
+{
+	struct stat st;
+	char path[PATH_MAX];
+	int isdir = *e == DT_DIR;
+	size_t at = c->text.len;
+
+	if ((*e == DT_LNK || *e == DT_UNKNOWN) &&
+		snprintf(path, sizeof(path), "%s/%s", dir, e + 1) <
+		(int)sizeof(path) && stat(path, &st) == 0)
+		isdir = S_ISDIR(st.st_mode);
+	if (wbuf_put(&c->text, word, c->skip) != 0 ||
+		wbuf_put(&c->text, e + 1, strlen(e + 1)) != 0 ||
+		(isdir && wbuf_putc(&c->text, '/') != 0) ||
+		wbuf_putc(&c->text, '\0') != 0)
+	{
+		c->text.len = at;
+		return;
+	}
+	comp_common(c, c->text.s + at);
+	c->n++;
+}
+
+/**
+ * comp_files - completes a file name
+ * @word: the partial path
+ * @c: receives the candidates, with directories ending in "/"
+ * Return: number of candidates
+ *
+ * Hidden files are only offered when the partial name starts with ".".
+ */
+int comp_files(const char *word, cands_t *c)
+{
+	const char *slash = strrchr(word, '/'), *base;
+	char *dir, *e;
+	dirlist_t *d;
+
+	memset(c, 0, sizeof(*c));
+	base = slash != NULL ? slash + 1 : word;
+	c->skip = base - word;
+	if (slash == NULL)
+		dir = strdup(".");
+	else
+		dir = slash == word ? strdup("/") : strndup(word, slash - word);
+	d = dir != NULL ? dir_list(dir) : NULL;
+	for (e = d ? d->ents : NULL; e != NULL && e < d->ents + d->len;
+		e += strlen(e + 1) + 2)
+		if (strncmp(e + 1, base, strlen(base)) == 0 &&
+			(e[1] != '.' || *base == '.'))
+			comp_entry(c, word, dir, e);
+	free(dir);
+	c->unique = c->n == 1;
+	c->more = c->n > LE_MAXLIST;
+	return (c->n);
+}
@@ -0,0 +1,166 @@
+#include "shell.h"
+
+/**
+ * coproc_find - looks up a running coprocess
+ * @name: the NAME it was started as
+ * Return: the coprocess, or NULL
+ */
+static coproc_t *coproc_find(const char *name)
+{
+	int i;
+
+	for (i = 0; i < g_sh.ncoproc; i++)
+		if (strcmp(g_sh.coproc[i].name, name) == 0)
+			return (&g_sh.coproc[i]);
+	return (NULL);
+}
+
+/**
+ * coproc_start - starts a coprocess with pipes to both ends of it
+ * @c: receives the coprocess
+ * @cmd: the command and its arguments
+ * @shell_name: name of the shell
+ * @line: line number, for messages
+ * Return: 0 on success, -1 on failure with errno set
+ *
+ * The command runs in a forked copy of the shell as its tail, so an
+ * external command replaces the copy, and builtins and functions work
+ * too. The shell's ends of the pipes are kept at 10 and above, close on
+ * exec, so no other command holds them open.
+ */
+static int coproc_start(coproc_t *c, char **cmd, const char *shell_name,
+int line)
+{
+	int to[2], from[2], i;
+	pid_t pid;
+
+	if (pipe2(to, O_CLOEXEC) != 0)
+		return (-1);
+	if (pipe2(from, O_CLOEXEC) != 0)
+	{
+		close(to[0]);
+		close(to[1]);
+		return (-1);
+	}
+	pid = shell_fork();
+	if (pid == 0)
+	{
+		for (i = 0; i < g_sh.ncoproc; i++)
+			close(g_sh.coproc[i].rfd), close(g_sh.coproc[i].wfd);
+		g_sh.ncoproc = 0;
+		close(to[1]);
+		close(from[0]);
+		if (dup2(to[0], 0) < 0 || dup2(from[1], 1) < 0)
+			_exit(126);
+		close(to[0]);
+		close(from[1]);
+		g_sh.tail = 1;
+		shell_exit(chK(cmd, shell_name, line, 0, NULL));
+	}
+	close(to[0]);
+	close(from[1]);
+	c->pid = pid;
+	c->owner = getpid();
+	c->wfd = fcntl(to[1], F_DUPFD_CLOEXEC, 10);
+	c->rfd = fcntl(from[0], F_DUPFD_CLOEXEC, 10);
+	close(to[1]);
+	close(from[0]);
+	if (pid > 0 && c->wfd >= 0 && c->rfd >= 0)
+		return (0);
+	coproc_close(c);
+	return (-1);
+}
+
+/**
+ * coproc_close - closes the pipes of a coprocess and reaps it
+ * @c: the coprocess
+ *
+ * Closing its input is the signal to finish. One that is still running
+ * COPROC_GRACE_MS later is sent SIGTERM. Forked copies of the shell only
+ * close their copies of the pipes, leaving the child to the shell.
+ */
+void coproc_close(coproc_t *c)
+{
+	struct pollfd pf;
+
+	if (c->wfd >= 0)
+		close(c->wfd);
+	if (c->rfd >= 0)
+		close(c->rfd);
+	if (c->pid > 0 && c->owner == getpid())
+	{
+		pf.fd = syscall(SYS_pidfd_open, c->pid, 0);
+		pf.events = POLLIN;
+		if (pf.fd < 0 || poll(&pf, 1, COPROC_GRACE_MS) != 1)
+			kill(c->pid, SIGTERM);
+		if (pf.fd >= 0)
+			close(pf.fd);
+		wait_status(c->pid);
+	}
+	free(c->name);
+	c->name = NULL;
+}
+
+/**
+ * coproc_reap - closes and reaps every coprocess as the shell exits
+ */
+void coproc_reap(void)
+{
+	while (g_sh.ncoproc > 0)
+		coproc_close(&g_sh.coproc[--g_sh.ncoproc]);
+}
+
+/**
+ * handle_coproc - handles the built-in "coproc" command
+ * @args: "coproc", NAME, then the command and its arguments
+ * @shell_name: the name of the shell
+ * @command_count: line number, for messages
+ * Return: 0 when the coprocess started, 1 if it could not, 2 on a usage
+ * error
+ *
+ * The command runs alongside the shell, reading what is written to
+ * $NAME_W and writing what can be read from $NAME_R, as in
+ * printf '1+2\n' >&$NAME_W; read -r sum <&$NAME_R. Its process id is
+ * $NAME_PID. Starting NAME again first closes and reaps the previous one.
+ */
+int handle_coproc(char *args[], const char *shell_name, int command_count)
+{
+	static const char *const suffix[] = {"_R", "_W", "_PID"};
+	static int registered;
+	char var[256], num[24];
+	coproc_t *c;
+	int i;
+
+	if (args[1] == NULL || args[2] == NULL || !is_name(args[1]) ||
+		strlen(args[1]) > sizeof(var) - 8)
+	{
+		fprintf(stderr, "%s: %d: coproc: usage: coproc NAME command "
+			"[arg ...]\n", shell_name, command_count);
+		return (2);
+	}
+	c = coproc_find(args[1]);
+	if (c != NULL)
+	{
+		coproc_close(c);
+		*c = g_sh.coproc[--g_sh.ncoproc];
+	}
+	c = g_sh.ncoproc < COPROC_MAX ? &g_sh.coproc[g_sh.ncoproc] : NULL;
+	if (c == NULL || (c->name = strdup(args[1])) == NULL ||
+		coproc_start(c, args + 2, shell_name, command_count) != 0)
+	{
+		if (c != NULL)
+			free(c->name), c->name = NULL;
+		fprintf(stderr, "%s: %d: coproc: cannot start %s\n", shell_name,
+			command_count, args[2]);
+		return (1);
+	}
+	g_sh.ncoproc++;
+	registered = registered || atexit(coproc_reap) == 0;
+	for (i = 0; i < 3; i++)
+	{
+		sprintf(var, "%s%s", args[1], suffix[i]);
+		sprintf(num, "%d", i == 0 ? c->rfd : i == 1 ? c->wfd : c->pid);
+		var_set(var, num, 0);
+	}
+	return (0);
+}
@@ -1,39 +1,35 @@
 #include "shell.h"
 
+state_t g_sh;
+
 /**
  * execute_command - function to execute a command
+ * @path: where the command was found
  * @args: array of arguments for the command
  * @shell_name: the name of the shell (e.g., "sh")
  * @command_count: the count of commands entered since shell execution
- * Return: 0 on success, -1 on failure
+ * Return: exit status of the command, -1 on failure
+ *
+ * The command starts with the settings of any prefix builtin it runs
+ * under, such as limit. A script for this shell started with none of
+ * them runs without an exec, see script_exec, unless under --record,
+ * which records it as a single command. --replay only stands in for it.
  */
-int execute_command(char *args[], const char *shell_name, int command_count)
+int execute_command(const char *path, char *args[], const char *shell_name,
+int command_count)
 {
-	int status;
-	pid_t pid = fork();
-
-	UNUSED(shell_name);
-	UNUSED(command_count);
-
-	if (pid < 0)
-	{
-		fprintf(stderr, "Fork failed\n");
-		return (-1);
-	}
-	else if (pid == 0)
-	{
-		execvp(args[0], args);
-		exit(EXIT_FAILURE);
-	}
+	spawn_t *sp = &g_sh.spawn;
+	int stage = REC_STAGE(REC_EXEC), status;
+
+	g_sh.spawned = path;
+	if (g_sh.rec.on == REC_REPLAY)
+		status = rec_stub(args, sp, shell_name, command_count);
+	else if (sp->lim == 0 && sp->place == 0 && sp->timeout_ms == 0 &&
+		!g_sh.rec.on && shebang_self(path))
+		status = script_exec(path, args, shell_name);
 	else
-	{
-		wait(&status);
-		if (WIFEXITED(status))
-		{
-			return (WEXITSTATUS(status));
-		}
-	}
-
+		status = spawn_cmd(path, args, sp, shell_name, command_count);
+	REC_STAGE(stage);
 	return (status);
 }
 
@@ -47,42 +43,21 @@ int execute_command(char *args[], const char *shell_name, int command_count)
  */
 int search_n_exec_cmd(char *args[], const char *shell_name, int command_count)
 {
-	char path[MAX_LENGTH], full_path[MAX_LENGTH];
-	char *path_token, *path_env;
-	int found = 0, status = 0;
-	struct stat st;
-
-	path_env = getenv("PATH");
-	strcpy(path, path_env);
-	path_token = strtok(path, ":");
-
-	if (stat(args[0], &st) != 0)
-		while (path_token != NULL)
-		{
-			strcpy(full_path, path_token);
-			strcat(full_path, "/");
-			strcat(full_path, args[0]);
-			if (access(full_path, X_OK) == 0)
-			{
-				found = 1;
-				status = execute_command(args, shell_name, command_count);
-				break;
-			}
-			path_token = strtok(NULL, ":");
-		}
-	else
+	const char *path = args[0];
+	int stage = REC_STAGE(REC_LOOKUP);
+
+	if (strchr(path, '/') == NULL)
+		path = cmd_lookup(path);
+	else if (access(path, F_OK) != 0)
+		path = NULL;
+	REC_STAGE(stage);
+	if (path == NULL)
 	{
-		found = 1;
-		status = execute_command(args, shell_name, command_count);
-	}
-
-	if (!found)
-	{
-		status = 127;
 		fprintf(stderr, "%s: %d: %s: not found\n",
 				shell_name, command_count, args[0]);
+		return (127);
 	}
-	return (status);
+	return (execute_command(path, args, shell_name, command_count));
 }
 
 /**
@@ -142,42 +117,51 @@ int status, char *input)
 
 /**
  * main - entry point of the shell program
+ * @argc: number of arguments
+ * @argv: arguments, see shell_args
  * Return: 0 if successful
  */
 
-int main(void)
+int main(int argc, char *argv[])
 {
-	char *input = NULL, *args[MAX_LENGTH];
-	size_t n = 0;
-	int command_count = 0, status = 0;
+	int status = 0;
 	const char *shell_name;
+	source_t src;
+	wbuf_t rec;
+	node_t *cmd;
 
+	prof_mark("start");
 	shell_name = get_shell_name();
+	vars_import();
+	prof_mark("environment");
+	g_sh.pid = getpid();
+	status = shell_args(argc, argv, shell_name);
+	if (status >= 0)
+		exit(status);
+	status = 0;
 
+	repl_init(&src, &rec);
+	g_sh.interactive = isatty(STDIN_FILENO) == 1;
+	prof_mark("first prompt");
+	prof_report();
 	while (1)
 	{
-		command_count++;
 		if (isatty(STDIN_FILENO) == 1)
-			printf("$ ");
-		if (getline(&input, &n, stdin) == -1)
+			src.ps = "$ ";
+		cmd = parse_command(&src);
+		if (cmd == NULL)
 		{
 			if (isatty(STDIN_FILENO) == 1)
 				printf("\n");
 			break;
 		}
-		input[strcspn(input, "\n")] = '\0';
-
-		tokenize_input(input, args);
-		if (args == NULL || args[0] == NULL)
-			continue;
-
-		status = chK(args, shell_name, command_count, status,
-		input);
-		/*if (strchr(args[0], '/') == NULL) */
-		/*status = search_n_exec_cmd(args, shell_name, command_count);*/
-		/*else */
-		/*	execute_command(args, shell_name, command_count); */
+
+		status = repl_exec(cmd, &src, shell_name, status);
+		if (cmd->type == N_SYNERR && isatty(STDIN_FILENO) != 1)
+			break;
+		node_free(cmd);
 	}
-	free(input);
+	free(src.line);
+	free(rec.s);
 	exit(status);
 }
@@ -0,0 +1,70 @@
+#include "shell.h"
+
+/**
+ * exec_node - executes a parsed tree node
+ * @n: the node
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from, freed on exit
+ * Return: exit status of the last command executed
+ */
+int exec_node(node_t *n, const char *shell_name, int status, char *input)
+{
+	int i, tail = g_sh.tail;
+
+	if (n == NULL)
+		return (status);
+	switch (n->type)
+	{
+	case N_LIST:
+		for (i = 0; i < n->nkids && !g_sh.returning; i++)
+		{
+			g_sh.tail = tail && i + 1 == n->nkids;
+			status = exec_node(n->kids[i], shell_name, status,
+				input);
+		}
+		g_sh.tail = tail;
+		break;
+	case N_CMD:
+		status = exec_simple(n, shell_name, status, input);
+		break;
+	case N_PIPE:
+		status = exec_pipe(n, shell_name, status, input);
+		break;
+	case N_SUBSHELL:
+		status = exec_subshell(n, shell_name, status, input);
+		break;
+	case N_WHILE:
+		status = exec_while(n, shell_name, status, input);
+		break;
+	case N_FUNC:
+		status = func_define(n->words[0], n->kids[0]) == 0 ? 0 : 1;
+		break;
+	case N_SYNERR:
+		fprintf(stderr, "%s: %d: Syntax error: %s\n",
+			shell_name, n->line, n->words[0]);
+		status = 2;
+		break;
+	}
+	if (status != 0 && g_sh.snap > 0)
+		g_sh.snap = -1;
+	return (status);
+}
+
+/**
+ * exec_top - executes a top level command list
+ * @n: the command list
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the last command executed
+ *
+ * State that only lives for one command list, such as the directory
+ * listings read by pathname expansion, is dropped afterwards.
+ */
+int exec_top(node_t *n, const char *shell_name, int status, char *input)
+{
+	status = exec_node(n, shell_name, status, input);
+	glob_cache_clear();
+	return (status);
+}
@@ -0,0 +1,157 @@
+#include "shell.h"
+
+/**
+ * var_save - records the value of a variable before it is assigned
+ * @word: the NAME=value word assigning it
+ * @save: receives a copy of the value, or an exported of -1 when the
+ * variable is unset
+ */
+void var_save(const char *word, var_t *save)
+{
+	char name[256];
+	size_t n = assign_len(word);
+	var_t *v = NULL;
+
+	if (n < sizeof(name))
+	{
+		memcpy(name, word, n);
+		name[n] = '\0';
+		v = var_lookup(name);
+	}
+	save->value = v != NULL ? strdup(v->value) : NULL;
+	save->exported = v != NULL ? v->exported : -1;
+}
+
+/**
+ * assign_apply - performs the assignments of a command
+ * @words: the words of the command
+ * @vals: the expanded value of each assignment
+ * @nassign: number of assignments
+ * @save: when not NULL, receives the previous values so the assignments
+ * can be undone, and the variables are exported for the command
+ * Return: 0 on success, 1 on failure
+ */
+static int assign_apply(char **words, char **vals, int nassign, var_t *save)
+{
+	char name[256];
+	size_t n;
+	int i;
+
+	for (i = 0; i < nassign; i++)
+	{
+		n = assign_len(words[i]);
+		if (n >= sizeof(name))
+			return (1);
+		memcpy(name, words[i], n);
+		name[n] = '\0';
+		if (save != NULL)
+			var_save(words[i], &save[i]);
+		if (var_set(name, vals[i], save != NULL) != 0)
+			return (1);
+	}
+	return (0);
+}
+
+/**
+ * assign_restore - undoes assignments
+ * @words: the assignment words
+ * @save: the values saved by var_save
+ * @nassign: number of assignments
+ */
+void assign_restore(char **words, var_t *save, int nassign)
+{
+	char name[256];
+	size_t n;
+	int i;
+
+	for (i = nassign - 1; i >= 0; i--)
+	{
+		n = assign_len(words[i]);
+		if (n >= sizeof(name))
+			continue;
+		memcpy(name, words[i], n);
+		name[n] = '\0';
+		var_unset(name);
+		if (save[i].exported >= 0 && save[i].value != NULL)
+			var_set(name, save[i].value, save[i].exported);
+		free(save[i].value);
+	}
+}
+
+/**
+ * exec_run - performs the assignments of a command and runs it
+ * @n: the N_CMD node
+ * @argv: the assignment values followed by the expanded command
+ * @nassign: number of assignments
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the command
+ */
+static int exec_run(node_t *n, char **argv, int nassign,
+const char *shell_name, int status, char *input)
+{
+	var_t *save;
+
+	if (argv[nassign] == NULL)
+		return (assign_apply(n->words, argv, nassign, NULL));
+	save = nassign > 0 ? calloc(nassign, sizeof(*save)) : NULL;
+	if (nassign > 0 && (save == NULL ||
+		assign_apply(n->words, argv, nassign, save) != 0))
+		status = 1;
+	else
+		status = stats_run(argv + nassign, shell_name, n->line,
+			status, input);
+	if (save != NULL)
+		assign_restore(n->words, save, nassign);
+	free(save);
+	return (status);
+}
+
+/**
+ * exec_simple - expands and runs a simple command
+ * @n: the N_CMD node
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the command
+ *
+ * Leading NAME=value words set shell variables when no command follows,
+ * and otherwise only apply, exported, for the duration of the command.
+ * Redirections are opened first and handed to the command in
+ * g_sh.redir; with no command they only create or open their files, and
+ * the status is that of the last command substitution.
+ */
+int exec_simple(node_t *n, const char *shell_name, int status, char *input)
+{
+	expand_t *x = expand_get(status, shell_name, n->line);
+	redir_t r, *outer = g_sh.redir;
+	char **argv;
+	int nassign, nredir, stage;
+
+	for (nassign = 0; nassign < n->nwords &&
+		assign_len(n->words[nassign]) > 0; nassign++)
+		;
+	stage = REC_STAGE(REC_EXPAND);
+	nredir = x != NULL ? redir_expand(x, n) : 0;
+	argv = x != NULL ? expand_words(x, n->words, n->nwords, nassign) : NULL;
+	REC_STAGE(stage);
+	r.n = 0;
+	if (argv == NULL)
+		status = x != NULL && x->err == 2 ? 2 : 1;
+	else if (nredir > 0 && redir_open(&r, n, argv, shell_name) != 0)
+		status = 1;
+	else
+	{
+		g_sh.redir = nredir > 0 ? &r : NULL;
+		status = exec_run(n, argv + nredir, nassign, shell_name,
+			status, input);
+		g_sh.redir = outer;
+		if (argv[nredir + nassign] == NULL && status == 0 &&
+			x->subst > 0)
+			status = x->subst;
+	}
+	redir_close(&r);
+	expand_put(x);
+	return (status);
+}
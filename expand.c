@@ -0,0 +1,105 @@
+#include "shell.h"
+
+/**
+ * unquote_to - copies a word into @out with quotes and escapes removed
+ * @word: the word as read by the lexer
+ * @out: destination, at least as long as @word
+ * Return: number of bytes written, not counting the terminating NUL
+ */
+static size_t unquote_to(const char *word, char *out)
+{
+	size_t n = 0;
+	int q = 0;
+
+	for (; *word; word++)
+	{
+		if (q != '"' && (*word == '\'' || *word == '"') &&
+			(!q || q == *word))
+			q = q ? 0 : *word;
+		else if (q == '"' && *word == '"')
+			q = 0;
+		else if (*word == '\\' && q != '\'' && word[1] != '\0' &&
+			(!q || strchr("$`\"\\\n", word[1])))
+			out[n++] = *++word;
+		else
+			out[n++] = *word;
+	}
+	out[n] = '\0';
+	return (n);
+}
+
+/**
+ * unquote - removes quotes and escapes from a word
+ * @word: the word as read by the lexer
+ * Return: malloc'd result, or NULL on failure
+ */
+char *unquote(const char *word)
+{
+	char *out = malloc(strlen(word) + 1);
+
+	if (out != NULL)
+		unquote_to(word, out);
+	return (out);
+}
+
+/**
+ * split_words - splits a string into words with quotes removed
+ * @s: the string
+ * @n: node the words are appended to
+ * Return: 0 on success, -1 if @s holds anything but plain words
+ */
+int split_words(const char *s, node_t *n)
+{
+	source_t src;
+	token_t t;
+	char *w;
+
+	src_init(&src, s, strlen(s), NULL);
+	while (lex_token(&src, &t) == T_WORD)
+	{
+		w = unquote(t.word);
+		free(t.word);
+		if (w == NULL || node_add_word(n, w) != 0)
+		{
+			free(w);
+			return (-1);
+		}
+	}
+	if (t.type == T_REDIR)
+		free(t.word);
+	return (t.type == T_EOF ? 0 : -1);
+}
+
+/**
+ * expand_words - expands the words of a command in a single pass
+ * @x: the expansion buffer, from expand_get
+ * @words: the words as read by the lexer
+ * @nwords: number of words
+ * @nassign: number of leading NAME=value words, whose values are expanded
+ * into exactly one field each without splitting
+ * Return: NULL terminated fields, the assignment values first, pointing
+ * into @x; NULL on failure. Fields already in @x, such as the operands of
+ * redirections, come before them.
+ *
+ * Expansions are written straight into the field buffer of @x, so no
+ * intermediate strings are built for parameter values.
+ */
+char **expand_words(expand_t *x, char **words, int nwords, int nassign)
+{
+	const char *w;
+	int i, pre = x->nfields;
+
+	for (i = 0; i < nwords && !x->err; i++)
+	{
+		w = words[i];
+		x->nosplit = i < nassign;
+		if (x->nosplit)
+			w += assign_len(w) + 1;
+		x->quoted = x->nosplit;
+		x_span(x, w, w + strlen(w), 0);
+		if (x->quoted)
+			x_field(x);
+		x_break(x);
+	}
+	return (x->err ? NULL : x_finish(x, pre + nassign));
+}
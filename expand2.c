@@ -0,0 +1,154 @@
+#include "shell.h"
+
+/**
+ * x_field - starts a new field unless one is already being written
+ * @x: the expansion buffer
+ * Return: 0 on success, -1 on failure
+ */
+int x_field(expand_t *x)
+{
+	size_t *offs;
+	unsigned char *fl;
+	int cap;
+
+	if (x->open)
+		return (0);
+	if (x->nfields == x->fcap)
+	{
+		cap = x->fcap ? x->fcap * 2 : 32;
+		offs = realloc(x->offs, cap * sizeof(*offs));
+		if (offs != NULL)
+			x->offs = offs;
+		fl = offs != NULL ? realloc(x->fflags, cap) : NULL;
+		if (fl == NULL)
+			return (-1);
+		x->fflags = fl;
+		x->fcap = cap;
+	}
+	x->fflags[x->nfields] = 0;
+	x->offs[x->nfields++] = x->buf.len;
+	x->open = 1;
+	return (0);
+}
+
+/**
+ * x_putc - appends an unquoted byte to the current field
+ * @x: the expansion buffer
+ * @c: the byte
+ * Return: 0 on success, -1 on failure
+ *
+ * An unquoted "*", "?" or "[" marks the field for pathname expansion.
+ */
+int x_putc(expand_t *x, int c)
+{
+	if (x_field(x) != 0 || wbuf_putc(&x->buf, c) != 0)
+	{
+		x->err = 1;
+		return (-1);
+	}
+	if (c == '*' || c == '?' || c == '[')
+		x->fflags[x->nfields - 1] |= XF_GLOB;
+	return (0);
+}
+
+/**
+ * x_break - ends the current field, if any
+ * @x: the expansion buffer
+ */
+void x_break(expand_t *x)
+{
+	if (!x->open)
+		return;
+	if (wbuf_putc(&x->buf, '\0') != 0)
+		x->err = 1;
+	x->open = 0;
+}
+
+/**
+ * x_value - appends the result of an expansion, splitting it on $IFS
+ * @x: the expansion buffer
+ * @v: the value
+ * @len: length of @v
+ * @quoted: nonzero when the expansion was quoted and must not be split
+ *
+ * IFS white space separates fields; any other IFS byte ends a field and
+ * may leave an empty one behind. Quoted values keep their glob characters
+ * literal.
+ */
+void x_value(expand_t *x, const char *v, size_t len, int quoted)
+{
+	size_t i = 0;
+
+	quoted |= x->nosplit;
+	while (quoted && i < len && v[i] != '*' && v[i] != '?' &&
+		v[i] != '[' && v[i] != '\\')
+		i++;
+	if (quoted && i == len)
+	{
+		if (x_field(x) != 0 || wbuf_put(&x->buf, v, len) != 0)
+			x->err = 1;
+		return;
+	}
+	for (i = 0; i < len; i++)
+		if (quoted || v[i] == '\\')
+			x_putq(x, v[i]);
+		else if (x->ifs[(unsigned char)v[i]] == 0)
+			x_putc(x, v[i]);
+		else if (x->ifs[(unsigned char)v[i]] == 2)
+			x_break(x);
+		else
+		{
+			x_field(x);
+			x_break(x);
+		}
+}
+
+/**
+ * x_span - expands part of a word, removing quotes as it goes
+ * @x: the expansion buffer
+ * @p: start of the text
+ * @end: end of the text
+ * @dq: nonzero when the text is inside double quotes
+ * Return: @end
+ *
+ * Literal text inside an unquoted ${...} is split like the value of the
+ * expansion it stands for. The body of a here-document is expanded as if
+ * double quoted, except that double quotes stay literal.
+ */
+const char *x_span(expand_t *x, const char *p, const char *end, int dq)
+{
+	while (p < end && !x->err)
+		if (*p == '\'' && !dq)
+		{
+			x->quoted = 1;
+			for (p++; p < end && *p != '\''; p++)
+				x_putq(x, *p);
+			p++;
+		}
+		else if (*p == '"' && !x->here)
+		{
+			if (!dq || !x->emptyat)
+				x->quoted = 1;
+			x->emptyat = 0;
+			dq = !dq;
+			p++;
+		}
+		else if (*p == '\\' && p + 1 < end && (!dq ||
+			strchr(x->here ? "$`\\\n" : "$`\"\\\n", p[1]) != NULL))
+		{
+			if (p[1] != '\n')
+				x_putq(x, p[1]);
+			p += 2;
+		}
+		else if (*p == '$')
+			p = x_param(x, p, end, dq);
+		else if (*p == '`')
+			p = x_subst(x, p, end, dq);
+		else if (x->inparam && !dq)
+			x_value(x, p++, 1, 0);
+		else if (dq || *p == '\\')
+			x_putq(x, *p++);
+		else
+			x_putc(x, *p++);
+	return (end);
+}
@@ -0,0 +1,146 @@
+#include "shell.h"
+
+/**
+ * x_lookup - finds the value of a parameter
+ * @x: the expansion buffer
+ * @name: start of the parameter name
+ * @len: length of the name
+ * @nb: scratch space for numeric values
+ * Return: the value, or NULL when the parameter is unset
+ */
+const char *x_lookup(expand_t *x, const char *name, size_t len,
+char nb[32])
+{
+	size_t i, idx = 0;
+
+	if (g_sh.snap > 0 && len == 1 && (*name == '$' || *name == '0'))
+		g_sh.snap = -1;
+	if (len == 1 && (*name == '?' || *name == '$' || *name == '#'))
+	{
+		sprintf(nb, "%d", *name == '?' ? x->status :
+			*name == '$' ? (int)g_sh.pid : g_sh.nparams);
+		return (nb);
+	}
+	if (len == 1 && (*name == '-' || *name == '!'))
+		return (*name == '-' ? "" : NULL);
+	for (i = 0; i < len && name[i] >= '0' && name[i] <= '9'; i++)
+		idx = idx * 10 + (name[i] - '0');
+	if (i == len && idx == 0)
+		return (g_sh.arg0);
+	if (i == len)
+		return (idx <= (size_t)g_sh.nparams ?
+			g_sh.params[idx - 1] : NULL);
+	return (var_getn(name, len));
+}
+
+/**
+ * x_special - expands $@ or $*
+ * @x: the expansion buffer
+ * @c: '@' or '*'
+ * @dq: nonzero inside double quotes
+ *
+ * "$@" gives one field per parameter, "$*" joins them with the first IFS
+ * byte, and unquoted both split every parameter.
+ */
+static void x_special(expand_t *x, int c, int dq)
+{
+	char sep;
+	int i;
+
+	if (dq && c == '@' && g_sh.nparams == 0 && !x->open)
+	{
+		x->quoted = 0;
+		x->emptyat = 1;
+	}
+	for (i = 0; i < g_sh.nparams; i++)
+	{
+		if (i > 0 && (!dq || c == '@') && !x->nosplit)
+		{
+			x_break(x);
+			if (dq)
+				x_field(x);
+		}
+		else if (i > 0 && x->ifs0 != 0)
+		{
+			sep = x->ifs0;
+			x_value(x, &sep, 1, 1);
+		}
+		x_value(x, g_sh.params[i], strlen(g_sh.params[i]), dq);
+	}
+}
+
+/**
+ * x_emit - appends the value of a parameter
+ * @x: the expansion buffer
+ * @name: start of the parameter name
+ * @len: length of the name
+ * @dq: nonzero inside double quotes
+ */
+void x_emit(expand_t *x, const char *name, size_t len, int dq)
+{
+	char nb[32];
+	const char *v;
+
+	if (len == 1 && (*name == '@' || *name == '*'))
+	{
+		x_special(x, *name, dq);
+		return;
+	}
+	v = x_lookup(x, name, len, nb);
+	if (v != NULL)
+		x_value(x, v, strlen(v), dq);
+}
+
+/**
+ * x_param - expands a parameter reference or $(...) starting with "$"
+ * @x: the expansion buffer
+ * @p: the "$"
+ * @end: end of the text
+ * @dq: nonzero inside double quotes
+ * Return: the position after the reference
+ */
+const char *x_param(expand_t *x, const char *p, const char *end, int dq)
+{
+	const char *q = p + 1;
+	size_t n = 0;
+
+	if (q < end && *q == '{')
+		return (x_brace(x, q + 1, end, dq));
+	if (q < end && *q == '(')
+		return (x_subst(x, q, end, dq));
+	if (q < end && *q != '\0' && strchr("?$#@*!-0123456789", *q) != NULL)
+		n = 1;
+	else
+		n = name_len(q, end);
+	if (n == 0)
+	{
+		x_putc(x, '$');
+		return (q);
+	}
+	x_emit(x, q, n, dq);
+	return (q + n);
+}
+
+/**
+ * x_close - finds the "}" closing a ${...} expansion
+ * @p: first byte after the "${"
+ * @end: end of the text
+ * Return: the closing brace, or @end when there is none
+ */
+const char *x_close(const char *p, const char *end)
+{
+	int depth = 1, q = 0;
+
+	for (; p < end; p++)
+		if (q != 0 && *p == q)
+			q = 0;
+		else if (*p == '\\' && q != '\'' && p + 1 < end)
+			p++;
+		else if (q == 0 && (*p == '\'' || *p == '"'))
+			q = *p;
+		else if (q == 0 && *p == '$' && p + 1 < end && p[1] == '{')
+			depth++, p++;
+		else if (q == 0 && *p == '}' && --depth == 0)
+			return (p);
+	return (end);
+}
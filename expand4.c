@@ -0,0 +1,151 @@
+#include "shell.h"
+
+/**
+ * x_name_len - measures the parameter name at the start of a ${...}
+ * @p: first byte of the name
+ * @end: the closing brace
+ * Return: length of the name, 0 if there is none
+ */
+static size_t x_name_len(const char *p, const char *end)
+{
+	size_t n = 0;
+
+	if (p < end && *p != '\0' && strchr("?$#@*!-", *p) != NULL)
+		return (1);
+	if (p < end && *p >= '0' && *p <= '9')
+	{
+		while (p + n < end && p[n] >= '0' && p[n] <= '9')
+			n++;
+		return (n);
+	}
+	return (name_len(p, end));
+}
+
+/**
+ * x_word - expands the word of a ${name-word} style expansion
+ * @x: the expansion buffer
+ * @p: start of the word
+ * @end: the closing brace
+ * @dq: nonzero inside double quotes
+ */
+static void x_word(expand_t *x, const char *p, const char *end, int dq)
+{
+	x->inparam++;
+	x_span(x, p, end, dq);
+	x->inparam--;
+}
+
+/**
+ * x_unset - handles := and :? on an unset or null parameter
+ * @x: the expansion buffer
+ * @name: start of the parameter name
+ * @n: length of the name
+ * @op: '=' or '?'
+ * @s: the expanded word
+ * @dq: nonzero inside double quotes
+ *
+ * As POSIX asks, a shell that is not interactive exits on :?.
+ */
+static void x_unset(expand_t *x, const char *name, size_t n, int op,
+const char *s, int dq)
+{
+	char key[256];
+
+	if (n < sizeof(key))
+	{
+		memcpy(key, name, n);
+		key[n] = '\0';
+	}
+	if (op == '=' && n < sizeof(key) && is_name(key))
+	{
+		var_set(key, s, 0);
+		x_value(x, s, strlen(s), dq);
+		return;
+	}
+	if (op == '=')
+		fprintf(stderr, "%s: %d: %.*s: cannot assign in this way\n",
+			x->shell_name, x->line, (int)n, name);
+	else
+		fprintf(stderr, "%s: %d: %.*s: %s\n", x->shell_name, x->line,
+			(int)n, name, *s != '\0' ? s : "parameter not set");
+	if (op == '?' && !g_sh.interactive)
+		exit(2);
+	x->err = 2;
+}
+
+/**
+ * x_op - applies one of the :- := :+ :? operators, with or without colon
+ * @x: the expansion buffer
+ * @name: start of the parameter name
+ * @n: length of the name
+ * @op: the operator
+ * @end: the closing brace
+ * @dq: nonzero inside double quotes
+ */
+static void x_op(expand_t *x, const char *name, size_t n, const char *op,
+const char *end, int dq)
+{
+	int colon = *op == ':', set;
+	const char *v;
+	char nb[32], *s;
+
+	op += colon;
+	if (*name == '@' || *name == '*')
+		v = g_sh.nparams > 0 ? "@" : NULL;
+	else
+		v = x_lookup(x, name, n, nb);
+	set = v != NULL && (!colon || *v != '\0');
+	if ((*op == '-' && !set) || (*op == '+' && set))
+		x_word(x, op + 1, end, dq);
+	else if ((*op == '=' || *op == '?') && !set)
+	{
+		s = expand_string(x, op + 1, end, dq);
+		if (s != NULL)
+			x_unset(x, name, n, *op, s, dq);
+		free(s);
+	}
+	else if (*op != '+')
+		x_emit(x, name, n, dq);
+}
+
+/**
+ * x_brace - expands a ${...} parameter expansion
+ * @x: the expansion buffer
+ * @p: first byte after the "${"
+ * @end: end of the text
+ * @dq: nonzero inside double quotes
+ * Return: the position after the closing brace
+ */
+const char *x_brace(expand_t *x, const char *p, const char *end, int dq)
+{
+	const char *close = x_close(p, end), *v, *op;
+	char nb[32];
+	size_t n;
+	int length = *p == '#' && p + 1 < close, ok;
+
+	p += length;
+	n = x_name_len(p, close);
+	op = p + n + (p + n < close && p[n] == ':');
+	ok = n > 0 && (p + n == close || (!length && op < close &&
+		*op != '\0' && strchr("-=+?", *op) != NULL));
+	if (!ok)
+	{
+		fprintf(stderr, "%s: %d: Bad substitution\n",
+			x->shell_name, x->line);
+		x->err = 2;
+	}
+	else if (length)
+	{
+		v = x_lookup(x, p, n, nb);
+		if (*p == '@' || *p == '*')
+			sprintf(nb, "%d", g_sh.nparams);
+		else
+			sprintf(nb, "%lu", v ? (unsigned long)strlen(v) : 0UL);
+		x_value(x, nb, strlen(nb), dq);
+	}
+	else if (p + n == close)
+		x_emit(x, p, n, dq);
+	else
+		x_op(x, p, n, p + n, close, dq);
+	return (close < end ? close + 1 : end);
+}
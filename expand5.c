@@ -0,0 +1,98 @@
+#include "shell.h"
+
+/**
+ * expand_get - hands out an expansion buffer for one command
+ * @status: value of $?
+ * @shell_name: name of the shell for diagnostics
+ * @line: line number for diagnostics
+ * Return: the buffer, or NULL on failure
+ *
+ * The buffers of previous commands are reused when they are free, so a
+ * steady stream of commands expands without allocating, even when command
+ * substitutions run commands in the middle of an expansion.
+ */
+expand_t *expand_get(int status, const char *shell_name, int line)
+{
+	expand_t *x = g_sh.nxfree > 0 ? g_sh.xfree[--g_sh.nxfree] : NULL;
+	const char *ifs = var_get("IFS");
+
+	if (x == NULL)
+		x = calloc(1, sizeof(*x));
+	if (x == NULL)
+		return (NULL);
+	x->buf.len = 0;
+	x->nfields = 0;
+	x->open = 0;
+	x->quoted = 0;
+	x->emptyat = 0;
+	x->inparam = 0;
+	x->nosplit = 0;
+	x->here = 0;
+	x->err = 0;
+	x->subst = -1;
+	x->status = status;
+	x->line = line;
+	x->shell_name = shell_name;
+	if (ifs == NULL)
+		ifs = " \t\n";
+	memset(x->ifs, 0, sizeof(x->ifs));
+	for (x->ifs0 = *ifs; *ifs; ifs++)
+		x->ifs[(unsigned char)*ifs] = strchr(" \t\n", *ifs) ? 2 : 1;
+	return (x);
+}
+
+/**
+ * expand_put - returns an expansion buffer once its command has finished
+ * @x: the buffer, may be NULL
+ */
+void expand_put(expand_t *x)
+{
+	if (x == NULL)
+		return;
+	if (g_sh.nxfree < XFREE_MAX)
+	{
+		g_sh.xfree[g_sh.nxfree++] = x;
+		return;
+	}
+	free(x->buf.s);
+	free(x->offs);
+	free(x->fflags);
+	free(x->outs);
+	free(x->argv);
+	free(x);
+}
+
+/**
+ * expand_string - expands text into a single string without splitting
+ * @x: the expansion buffer of the command, for $? and diagnostics
+ * @p: start of the text
+ * @end: end of the text
+ * @dq: nonzero inside double quotes
+ * Return: malloc'd result, or NULL on failure
+ */
+char *expand_string(expand_t *x, const char *p, const char *end, int dq)
+{
+	expand_t t;
+	char *s;
+	int i;
+
+	memset(&t, 0, sizeof(t));
+	t.status = x->status;
+	t.line = x->line;
+	t.shell_name = x->shell_name;
+	t.nosplit = 1;
+	x_field(&t);
+	x_span(&t, p, end, dq);
+	x_break(&t);
+	for (i = 0; i + 1 < t.nfields; i++)
+		t.buf.s[t.offs[i + 1] - 1] = ' ';
+	s = t.err || t.buf.s == NULL ? NULL : t.buf.s;
+	if (s == NULL)
+		free(t.buf.s);
+	else
+		unescape(s);
+	free(t.offs);
+	free(t.fflags);
+	x->err |= t.err;
+	return (s);
+}
@@ -0,0 +1,147 @@
+#include "shell.h"
+
+/**
+ * x_putq - appends a quoted byte to the current field
+ * @x: the expansion buffer
+ * @c: the byte
+ * Return: 0 on success, -1 on failure
+ *
+ * Glob characters and backslashes are escaped with a backslash so that
+ * pathname expansion takes them literally; unescape removes it again.
+ */
+int x_putq(expand_t *x, int c)
+{
+	if (c != '*' && c != '?' && c != '[' && c != '\\')
+	{
+		if (x_field(x) != 0 || wbuf_putc(&x->buf, c) != 0)
+			x->err = 1;
+		return (x->err ? -1 : 0);
+	}
+	if (x_field(x) != 0 || wbuf_putc(&x->buf, '\\') != 0 ||
+		wbuf_putc(&x->buf, c) != 0)
+	{
+		x->err = 1;
+		return (-1);
+	}
+	x->fflags[x->nfields - 1] |= XF_ESC;
+	return (0);
+}
+
+/**
+ * unescape - removes the backslash escapes of a field in place
+ * @s: the field
+ * Return: the new length of @s
+ */
+size_t unescape(char *s)
+{
+	char *d = s, *p = s;
+
+	for (; *p; p++)
+	{
+		if (*p == '\\' && p[1] != '\0')
+			p++;
+		*d++ = *p;
+	}
+	*d = '\0';
+	return (d - s);
+}
+
+/**
+ * x_out - records the offset of a final field
+ * @x: the expansion buffer
+ * @n: index of the field
+ * @off: offset of the field in the buffer
+ * Return: 0 on success, -1 on failure
+ */
+static int x_out(expand_t *x, int n, size_t off)
+{
+	size_t *outs;
+	int cap;
+
+	if (n + 1 >= x->ocap)
+	{
+		cap = x->ocap ? x->ocap * 2 : 32;
+		while (n + 1 >= cap)
+			cap *= 2;
+		outs = realloc(x->outs, cap * sizeof(*outs));
+		if (outs == NULL)
+			return (-1);
+		x->outs = outs;
+		x->ocap = cap;
+	}
+	x->outs[n] = off;
+	return (0);
+}
+
+/**
+ * x_glob - replaces a field by the pathnames it matches
+ * @x: the expansion buffer
+ * @i: index of the field
+ * @n: number of final fields so far
+ * Return: the new number of final fields, -1 on failure
+ *
+ * The matches are appended to the buffer; a pattern that matches nothing
+ * is kept as it is, without its escapes.
+ */
+static int x_glob(expand_t *x, int i, int n)
+{
+	wbuf_t store;
+	char **m, *pat = strdup(x->buf.s + x->offs[i]);
+	int k, count = 0;
+
+	memset(&store, 0, sizeof(store));
+	m = pat != NULL ? glob_expand(pat, &count, &store) : NULL;
+	free(pat);
+	if (count == 0)
+	{
+		free(m);
+		free(store.s);
+		unescape(x->buf.s + x->offs[i]);
+		return (x_out(x, n, x->offs[i]) ? -1 : n + 1);
+	}
+	for (k = 0; k < count && n >= 0; k++, n++)
+		if (x_out(x, n, x->buf.len) != 0 ||
+			wbuf_put(&x->buf, m[k], strlen(m[k]) + 1) != 0)
+			n = -2;
+	free(m);
+	free(store.s);
+	return (n);
+}
+
+/**
+ * x_finish - performs pathname expansion and builds the argument vector
+ * @x: the expansion buffer
+ * @nassign: number of leading assignment values, which are not expanded
+ * Return: the NULL terminated fields, or NULL on failure
+ */
+char **x_finish(expand_t *x, int nassign)
+{
+	char **argv;
+	int i, n = 0;
+
+	for (i = 0; i < x->nfields && n >= 0; i++)
+		if (i >= nassign && (x->fflags[i] & XF_GLOB))
+			n = x_glob(x, i, n);
+		else
+		{
+			if (x->fflags[i] & XF_ESC)
+				unescape(x->buf.s + x->offs[i]);
+			n = x_out(x, n, x->offs[i]) ? -1 : n + 1;
+		}
+	if (n >= 0 && n >= x->acap)
+	{
+		argv = realloc(x->argv, (n + 16) * sizeof(char *));
+		n = argv != NULL ? n : -1;
+		x->argv = argv != NULL ? argv : x->argv;
+		x->acap = argv != NULL ? n + 16 : x->acap;
+	}
+	if (n < 0)
+	{
+		x->err = 1;
+		return (NULL);
+	}
+	for (i = 0; i < n; i++)
+		x->argv[i] = x->buf.s + x->outs[i];
+	x->argv[i] = NULL;
+	return (x->argv);
+}
@@ -36,6 +36,8 @@ void handle_cd(char *args[], const char *shell_name, int command_count)
 	if (chdir(args[1]) != 0)
 		fprintf(stderr, "%s: %d: cd: can't cd to %s\n",
 				shell_name, command_count, args[1]);
+	else if (g_sh.audit.on)
+		audit_cwd();
 }
 
 
@@ -53,29 +55,88 @@ char *get_shell_name()
 }
 
 /**
- * chK - checks if first arg is an environ
- * @args: 2D array containing tokenized arguments
+ * chK_run - dispatches a command to a builtin, a function or PATH
+ * @av: the command, aliases expanded
  * @shell_name: name of shell executed
  * @command_count: count of commands entered
  * @status: variable storing last command exit status
  * @input: stores the command inputted by users
  * Return: exit status for present command
  */
-
-int chK(char *args[], const char *shell_name, int command_count,
+static int chK_run(char **av, const char *shell_name, int command_count,
 int status, char *input)
 {
+	const builtin_t *b;
+	shfunc_t *f = NULL;
+	int ext = 0;
 
-	if (strcmp(args[0], "exit") == 0)
-		status = exiT(args, shell_name, command_count, status, input);
-	else if (strcmp(args[0], "env") == 0)
+	if (strcmp(av[0], "exit") == 0)
+		status = exiT(av, shell_name, command_count, status, input);
+	else if (strcmp(av[0], "return") == 0)
+		status = handle_return(av, shell_name, command_count, status);
+	else if ((f = func_find(av[0])) != NULL)
+		status = func_call(f, av, shell_name, status, input);
+	else if (strcmp(av[0], "env") == 0)
 		status = handle_env(shell_name, command_count);
+	else if (strcmp(av[0], "cd") == 0)
+		handle_cd(av, shell_name, command_count);
+	else if (g_sh.rec.on == REC_REPLAY && rec_skip(av[0]))
+		status = rec_stub(av, NULL, shell_name, command_count);
+	else if ((b = builtin_find(av[0])) != NULL && b->fn != NULL)
+		status = b->fn(av, shell_name, command_count);
+	else if (b != NULL)
+		status = b->run(av, shell_name, command_count, status, input);
+	else
+	{
+		ext = 1;
+		status = search_n_exec_cmd(av, shell_name, command_count);
+	}
+	METRIC_ADD(builtins, f == NULL && !ext);
+	return (status);
+}
 
-	else if (strcmp(args[0], "cd") == 0)
-		handle_cd(args, shell_name, command_count);
+/**
+ * chK - expands aliases, then dispatches builtins, functions and commands
+ * @args: 2D array containing tokenized arguments
+ * @shell_name: name of shell executed
+ * @command_count: count of commands entered
+ * @status: variable storing last command exit status
+ * @input: stores the command inputted by users
+ * Return: exit status for present command
+ *
+ * Pending redirections are left to the child of an external command, and
+ * applied around anything that runs in the shell.
+ */
+int chK(char *args[], const char *shell_name, int command_count,
+int status, char *input)
+{
+	char **av = alias_expand(args);
+	redir_t *r = g_sh.redir;
 
+	if (av == NULL)
+		av = args;
+	if (g_sh.snap > 0)
+		snap_pure(av[0]);
+	if (r != NULL && cmd_inproc(av[0]))
+	{
+		g_sh.redir = NULL;
+		if (redir_apply(r) != 0)
+		{
+			fprintf(stderr, "%s: %d: %s\n", shell_name,
+				command_count, strerror(errno));
+			status = 1;
+		}
+		else
+		{
+			status = chK_run(av, shell_name, command_count, status,
+				input);
+			redir_restore(r);
+		}
+		g_sh.redir = r;
+	}
 	else
-		status = search_n_exec_cmd(args, shell_name, command_count);
-
+		status = chK_run(av, shell_name, command_count, status, input);
+	if (av != args)
+		free(av);
 	return (status);
 }
@@ -18,3 +18,40 @@ int check_for_non_digit(const char *str)
 	return (0);
 
 }
+
+/**
+ * name_len - measures the shell name at the start of a string
+ * @str: string to check
+ * @end: end of the string
+ * Return: length of the leading letter or underscore and the letters,
+ * digits and underscores after it, 0 if there is no name
+ */
+
+size_t name_len(const char *str, const char *end)
+{
+	size_t n = 0;
+
+	if (str >= end || !(*str == '_' || (*str >= 'a' && *str <= 'z') ||
+		(*str >= 'A' && *str <= 'Z')))
+		return (0);
+	while (str + n < end && (str[n] == '_' || (str[n] >= 'a' &&
+		str[n] <= 'z') || (str[n] >= 'A' && str[n] <= 'Z') ||
+		(str[n] >= '0' && str[n] <= '9')))
+		n++;
+
+	return (n);
+}
+
+/**
+ * is_name - checks if a string is a valid shell name
+ * @str: string to check
+ * Return: 1 if @str is a letter or underscore followed by letters,
+ * digits and underscores, else 0
+ */
+
+int is_name(const char *str)
+{
+	size_t len = strlen(str);
+
+	return (len > 0 && name_len(str, str + len) == len);
+}
@@ -0,0 +1,170 @@
+#include "shell.h"
+
+/**
+ * pat_named - adds a [:name:] character class to a bracket expression
+ * @p: the "[" that may start the class
+ * @set: the bitmap of the bracket expression
+ * Return: number of bytes the class takes, 0 when @p starts none
+ *
+ * The classes are those of POSIX, as the C locale defines them.
+ */
+static int pat_named(const char *p, unsigned char *set)
+{
+	static const char *const names[] = {"alnum", "alpha", "blank",
+		"cntrl", "digit", "graph", "lower", "print", "punct", "space",
+		"upper", "xdigit", NULL};
+	static int (*const is[])(int) = {isalnum, isalpha, isblank, iscntrl,
+		isdigit, isgraph, islower, isprint, ispunct, isspace, isupper,
+		isxdigit};
+	const char *end;
+	size_t n;
+	int k, i;
+
+	if (p[0] != '[' || p[1] != ':' || (end = strstr(p + 2, ":]")) == NULL)
+		return (0);
+	n = end - (p + 2);
+	for (k = 0; names[k] != NULL; k++)
+		if (strlen(names[k]) == n && strncmp(p + 2, names[k], n) == 0)
+			break;
+	if (names[k] == NULL)
+		return (0);
+	for (i = 1; i < 256; i++)
+		if (is[k](i))
+			set[i >> 3] |= 1 << (i & 7);
+	return (end + 2 - p);
+}
+
+/**
+ * pat_class - compiles a bracket expression
+ * @s: first byte after the "["
+ * @op: the operation to fill in
+ * Return: number of bytes used including the "]", 0 if it is not closed
+ *
+ * Ranges and character classes such as [:alpha:] may be mixed freely.
+ */
+static int pat_class(const char *s, gop_t *op)
+{
+	const char *p = s;
+	int neg = 0, lo, hi, i;
+
+	memset(op->set, 0, sizeof(op->set));
+	if (*p == '!' || *p == '^')
+		neg = *p++ != '\0';
+	do {
+		i = pat_named(p, op->set);
+		p += i;
+		if (i > 0)
+			continue;
+		if (*p == '\\' && p[1] != '\0')
+			p++;
+		if (*p == '\0')
+			return (0);
+		lo = (unsigned char)*p++;
+		hi = lo;
+		if (*p == '-' && p[1] != ']' && p[1] != '\0')
+		{
+			p += p[1] == '\\' && p[2] != '\0' ? 2 : 1;
+			hi = (unsigned char)*p++;
+		}
+		for (i = lo; i <= hi; i++)
+			op->set[i >> 3] |= 1 << (i & 7);
+	} while (*p != ']' && *p != '\0');
+	if (*p == '\0')
+		return (0);
+	for (i = 0; neg && i < (int)sizeof(op->set); i++)
+		op->set[i] = ~op->set[i];
+	op->type = G_SET;
+	return (p + 1 - s);
+}
+
+/**
+ * pat_compile - compiles one path component of a glob pattern
+ * @s: the component, with quoted bytes escaped by a backslash
+ * @ops: array for the operations
+ * @max: size of @ops
+ * Return: number of operations, -1 if @ops is too small
+ *
+ * Runs of "*" collapse into one G_STAR, and a "[" that is not closed
+ * stands for itself.
+ */
+int pat_compile(const char *s, gop_t *ops, int max)
+{
+	int n, k;
+
+	for (n = 0; *s != '\0' && n < max; n++)
+	{
+		ops[n].type = G_LIT;
+		k = *s == '[' ? pat_class(s + 1, &ops[n]) : 0;
+		if (k > 0)
+			s += k + 1;
+		else if (*s == '*')
+		{
+			ops[n].type = G_STAR;
+			while (*s == '*')
+				s++;
+		}
+		else if (*s == '?')
+		{
+			ops[n].type = G_ANY;
+			s++;
+		}
+		else
+		{
+			s += *s == '\\' && s[1] != '\0';
+			ops[n].c = *s++;
+		}
+	}
+	return (*s != '\0' ? -1 : n);
+}
+
+/**
+ * pat_match - matches a file name against a compiled component
+ * @ops: the operations
+ * @n: number of operations
+ * @name: the file name
+ * Return: 1 if @name matches, 0 otherwise
+ *
+ * Only the most recent "*" is ever backtracked to, which keeps the match
+ * linear for the usual patterns and quadratic at worst.
+ */
+int pat_match(const gop_t *ops, int n, const char *name)
+{
+	const unsigned char *s = (const unsigned char *)name, *back = NULL;
+	int i = 0, star = -1;
+
+	while (*s != '\0')
+		if (i < n && ops[i].type == G_STAR)
+		{
+			star = i++;
+			back = s;
+		}
+		else if (i < n && (ops[i].type == G_ANY ||
+			(ops[i].type == G_LIT && ops[i].c == *s) ||
+			(ops[i].type == G_SET &&
+			(ops[i].set[*s >> 3] & (1 << (*s & 7))))))
+		{
+			i++;
+			s++;
+		}
+		else if (star >= 0)
+		{
+			i = star + 1;
+			s = ++back;
+		}
+		else
+			return (0);
+	while (i < n && ops[i].type == G_STAR)
+		i++;
+	return (i == n);
+}
+
+/**
+ * glob_cmp - orders two matches
+ * @a: pointer to the first match
+ * @b: pointer to the second match
+ * Return: negative, zero or positive like strcmp
+ */
+int glob_cmp(const void *a, const void *b)
+{
+	return (strcmp(*(char * const *)a, *(char * const *)b));
+}
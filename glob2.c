@@ -0,0 +1,141 @@
+#include "shell.h"
+
+static htab_t dircache;
+
+/**
+ * dir_read - reads all entries of a directory with large getdents64 calls
+ * @fd: the open directory
+ * @d: the listing to fill in
+ * Return: 0 on success, -1 on failure
+ *
+ * "." and ".." are left out.
+ */
+static int dir_read(int fd, dirlist_t *d)
+{
+	static char *buf;
+	unsigned short reclen;
+	wbuf_t w;
+	long n, off;
+	char *e;
+
+	memset(&w, 0, sizeof(w));
+	if (buf == NULL)
+		buf = malloc(GLOB_DIRBUF);
+	if (buf == NULL)
+		return (-1);
+	while ((n = syscall(SYS_getdents64, fd, buf, GLOB_DIRBUF)) > 0)
+		for (off = 0; off < n; off += reclen)
+		{
+			e = buf + off;
+			memcpy(&reclen, e + 16, sizeof(reclen));
+			if (e[19] == '.' && (e[20] == '\0' ||
+				(e[20] == '.' && e[21] == '\0')))
+				continue;
+			if (wbuf_putc(&w, e[18]) != 0 ||
+				wbuf_put(&w, e + 19, strlen(e + 19) + 1) != 0)
+				n = -1;
+		}
+	if (n < 0)
+	{
+		free(w.s);
+		return (-1);
+	}
+	d->ents = w.s;
+	d->len = w.len;
+	return (0);
+}
+
+/**
+ * dir_fresh - tells whether a cached listing still matches its directory
+ * @d: the listing
+ * @st: current stat of the directory
+ * Return: 1 if the listing can be reused, 0 otherwise
+ */
+int dir_fresh(dirlist_t *d, struct stat *st)
+{
+	return (!d->racy && d->dev == st->st_dev && d->ino == st->st_ino &&
+		d->mtim.tv_sec == st->st_mtim.tv_sec &&
+		d->mtim.tv_nsec == st->st_mtim.tv_nsec &&
+		d->ctim.tv_sec == st->st_ctim.tv_sec &&
+		d->ctim.tv_nsec == st->st_ctim.tv_nsec);
+}
+
+/**
+ * dir_free - frees a listing
+ * @d: the listing, may be NULL
+ */
+static void dir_free(dirlist_t *d)
+{
+	if (d == NULL)
+		return;
+	free(d->ents);
+	free(d);
+}
+
+/**
+ * dir_list - lists a directory, reusing the listing taken earlier in the
+ * same command list while the directory has not changed
+ * @path: the directory
+ * Return: the listing, owned by the cache, or NULL on failure
+ *
+ * A directory modified within the last second may change again without
+ * its timestamps moving on coarse clocks, so its listing is not reused.
+ */
+dirlist_t *dir_list(const char *path)
+{
+	struct stat st;
+	hent_t *e;
+	dirlist_t *d;
+	int fd;
+
+	if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode))
+		return (NULL);
+	e = ht_insert(&dircache, path);
+	if (e == NULL || (e->val != NULL && dir_fresh(e->val, &st)))
+		return (e != NULL ? e->val : NULL);
+	dir_free(e->val);
+	e->val = NULL;
+	d = calloc(1, sizeof(*d));
+	fd = d != NULL ? open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC) : -1;
+	if (fd < 0 || dir_read(fd, d) != 0)
+	{
+		if (fd >= 0)
+			close(fd);
+		free(d);
+		return (NULL);
+	}
+	close(fd);
+	d->dev = st.st_dev;
+	d->ino = st.st_ino;
+	d->mtim = st.st_mtim;
+	d->ctim = st.st_ctim;
+	d->racy = st.st_mtim.tv_sec + 1 >= time(NULL) ||
+		st.st_ctim.tv_sec + 1 >= time(NULL);
+	e->val = d;
+	return (d);
+}
+
+/**
+ * glob_cache_clear - drops the directory listings once a command list
+ * has finished
+ */
+void glob_cache_clear(void)
+{
+	unsigned int i;
+	hent_t *e, *next;
+
+	if (dircache.n == 0)
+		return;
+	for (i = 0; i < dircache.nb; i++)
+	{
+		for (e = dircache.b[i]; e != NULL; e = next)
+		{
+			next = e->next;
+			dir_free(e->val);
+			free(e->key);
+			free(e);
+		}
+		dircache.b[i] = NULL;
+	}
+	dircache.n = 0;
+}
@@ -0,0 +1,176 @@
+#include "shell.h"
+
+static void glob_walk(gwalk_t *g, int i);
+
+/**
+ * glob_split - splits a pattern into path components and compiles them
+ * @g: the expansion state
+ * @p: the pattern after any leading "/", with quoted bytes escaped;
+ * cut up in place
+ * Return: 0 on success, -1 on failure
+ *
+ * Components without an unquoted glob character stay literal (nops -1)
+ * and are never matched against a directory listing. A trailing "/"
+ * leaves an empty last component, so only directories match.
+ */
+static int glob_split(gwalk_t *g, char *p)
+{
+	size_t n = 2, len;
+	char *q;
+	int i, meta;
+
+	for (q = p; *q; q++)
+		n += *q == '/';
+	g->comps = malloc(n * sizeof(*g->comps));
+	g->ops = calloc(n, sizeof(*g->ops));
+	g->nops = malloc(n * sizeof(*g->nops));
+	if (g->comps == NULL || g->ops == NULL || g->nops == NULL)
+		return (-1);
+	for (i = 0; ; i++)
+	{
+		g->comps[i] = p;
+		for (meta = 0; *p && *p != '/'; p++)
+			if (*p == '\\' && p[1] != '\0')
+				p++;
+			else
+				meta |= *p == '*' || *p == '?' || *p == '[';
+		len = p - g->comps[i];
+		g->nops[i] = -1;
+		g->ops[i] = meta ? malloc((len + 1) * sizeof(gop_t)) : NULL;
+		if (meta && g->ops[i] == NULL)
+			return (-1);
+		if (*p == '\0')
+			break;
+		for (*p++ = '\0'; *p == '/'; p++)
+			;
+	}
+	g->ncomps = i + 1;
+	for (i = 0; i < g->ncomps; i++)
+		if (g->ops[i] != NULL)
+			g->nops[i] = pat_compile(g->comps[i], g->ops[i],
+				strlen(g->comps[i]) + 1);
+	return (0);
+}
+
+/**
+ * glob_lit - appends a literal component to the current path
+ * @g: the expansion state
+ * @i: index of the component
+ * @base: length of the path before the component
+ *
+ * The existence of a literal last component is checked with lstat.
+ */
+static void glob_lit(gwalk_t *g, int i, size_t base)
+{
+	struct stat st;
+	size_t at = g->path.len;
+
+	if (wbuf_put(&g->path, g->comps[i], strlen(g->comps[i]) + 1) != 0)
+		return;
+	g->path.len = at + unescape(g->path.s + at);
+	if (i < g->ncomps - 1)
+		glob_walk(g, i + 1);
+	else if (lstat(g->path.s, &st) == 0 &&
+		wbuf_put(&g->out, g->path.s, g->path.len + 1) == 0)
+		g->nout++;
+	g->path.len = base;
+}
+
+/**
+ * glob_walk - matches the components from @i on below the current path
+ * @g: the expansion state
+ * @i: index of the component
+ *
+ * A listing is only read for components with glob characters.
+ */
+static void glob_walk(gwalk_t *g, int i)
+{
+	size_t base = g->path.len;
+	int last = i == g->ncomps - 1, dot;
+	dirlist_t *d;
+	char *e, *name;
+	struct stat st;
+
+	if (base > 0 && g->path.s[base - 1] != '/')
+		wbuf_putc(&g->path, '/');
+	if (g->nops[i] < 0)
+	{
+		glob_lit(g, i, base);
+		return;
+	}
+	d = dir_list(base > 0 ? g->path.s : ".");
+	dot = g->nops[i] > 0 && g->ops[i][0].type == G_LIT &&
+		g->ops[i][0].c == '.';
+	for (e = d ? d->ents : NULL; e != NULL && e < d->ents + d->len;
+		e = name + strlen(name) + 1)
+	{
+		name = e + 1;
+		if ((*name == '.' && !dot) ||
+			!pat_match(g->ops[i], g->nops[i], name))
+			continue;
+		g->path.len = base + (base > 0 && g->path.s[base - 1] != '/');
+		wbuf_put(&g->path, name, strlen(name) + 1);
+		g->path.len--;
+		if (last && wbuf_put(&g->out, g->path.s, g->path.len + 1) == 0)
+			g->nout++;
+		else if (!last && (*e == DT_DIR || ((*e == DT_LNK ||
+			*e == DT_UNKNOWN) && stat(g->path.s, &st) == 0 &&
+			S_ISDIR(st.st_mode))))
+			glob_walk(g, i + 1);
+	}
+	g->path.len = base;
+}
+
+/**
+ * glob_free - frees the compiled components of an expansion
+ * @g: the expansion state
+ */
+static void glob_free(gwalk_t *g)
+{
+	int i;
+
+	for (i = 0; g->ops != NULL && i < g->ncomps; i++)
+		free(g->ops[i]);
+	free(g->ops);
+	free(g->nops);
+	free(g->comps);
+	free(g->path.s);
+}
+
+/**
+ * glob_expand - expands a pathname pattern
+ * @pattern: the pattern, with quoted bytes escaped; cut up in place
+ * @count: receives the number of matches
+ * @store: receives the buffer holding the matches, to be freed by the
+ * caller even when nothing matched
+ * Return: malloc'd array of the matches in sorted order, or NULL
+ */
+char **glob_expand(char *pattern, int *count, wbuf_t *store)
+{
+	gwalk_t g;
+	char **m = NULL, *p;
+	int i;
+
+	memset(&g, 0, sizeof(g));
+	*count = 0;
+	if (*pattern == '/')
+		wbuf_put(&g.path, "/", 2);
+	g.path.len = g.path.s != NULL;
+	while (*pattern == '/')
+		pattern++;
+	if (glob_split(&g, pattern) == 0)
+		glob_walk(&g, 0);
+	if (g.nout > 0)
+		m = malloc(g.nout * sizeof(*m));
+	for (i = 0, p = g.out.s; m != NULL && i < g.nout; i++)
+	{
+		m[i] = p;
+		p += strlen(p) + 1;
+	}
+	if (m != NULL)
+		qsort(m, g.nout, sizeof(*m), glob_cmp);
+	*count = m != NULL ? g.nout : 0;
+	glob_free(&g);
+	*store = g.out;
+	return (m);
+}
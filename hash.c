@@ -0,0 +1,118 @@
+#include "shell.h"
+
+/**
+ * ht_hash - hashes a string (FNV-1a)
+ * @s: the string
+ * Return: the hash
+ */
+unsigned int ht_hash(const char *s)
+{
+	unsigned int h = 2166136261u;
+
+	while (*s)
+		h = (h ^ (unsigned char)*s++) * 16777619u;
+	return (h);
+}
+
+/**
+ * ht_grow - doubles the number of buckets of a table
+ * @t: the table
+ * Return: 0 on success, -1 on failure
+ */
+static int ht_grow(htab_t *t)
+{
+	unsigned int nb = t->nb ? t->nb * 2 : 16, i;
+	hent_t **b = calloc(nb, sizeof(*b)), *e, *next;
+
+	if (b == NULL)
+		return (-1);
+	for (i = 0; i < t->nb; i++)
+		for (e = t->b[i]; e != NULL; e = next)
+		{
+			next = e->next;
+			e->next = b[e->hash & (nb - 1)];
+			b[e->hash & (nb - 1)] = e;
+		}
+	free(t->b);
+	t->b = b;
+	t->nb = nb;
+	return (0);
+}
+
+/**
+ * ht_find - looks up a key
+ * @t: the table
+ * @key: the key
+ * Return: the entry, or NULL if @key is not in the table
+ */
+hent_t *ht_find(htab_t *t, const char *key)
+{
+	unsigned int h;
+	hent_t *e;
+
+	if (t->n == 0)
+		return (NULL);
+	h = ht_hash(key);
+	for (e = t->b[h & (t->nb - 1)]; e != NULL; e = e->next)
+		if (e->hash == h && strcmp(e->key, key) == 0)
+			return (e);
+	return (NULL);
+}
+
+/**
+ * ht_insert - looks up a key, adding an entry with a NULL value if missing
+ * @t: the table
+ * @key: the key, copied into a new entry
+ * Return: the entry, or NULL on failure
+ */
+hent_t *ht_insert(htab_t *t, const char *key)
+{
+	hent_t *e = ht_find(t, key);
+
+	if (e != NULL)
+		return (e);
+	if (t->n >= t->nb && ht_grow(t) != 0)
+		return (NULL);
+	e = malloc(sizeof(*e));
+	if (e == NULL)
+		return (NULL);
+	e->key = strdup(key);
+	if (e->key == NULL)
+	{
+		free(e);
+		return (NULL);
+	}
+	e->val = NULL;
+	e->hash = ht_hash(key);
+	e->next = t->b[e->hash & (t->nb - 1)];
+	t->b[e->hash & (t->nb - 1)] = e;
+	t->n++;
+	return (e);
+}
+
+/**
+ * ht_remove - removes a key
+ * @t: the table
+ * @key: the key
+ * Return: the value of the removed entry, or NULL if @key was missing
+ */
+void *ht_remove(htab_t *t, const char *key)
+{
+	unsigned int h = ht_hash(key);
+	hent_t **pe, *e;
+	void *val;
+
+	for (pe = t->nb ? &t->b[h & (t->nb - 1)] : NULL; pe && *pe;
+		pe = &(*pe)->next)
+		if ((*pe)->hash == h && strcmp((*pe)->key, key) == 0)
+		{
+			e = *pe;
+			*pe = e->next;
+			val = e->val;
+			free(e->key);
+			free(e);
+			t->n--;
+			return (val);
+		}
+	return (NULL);
+}
@@ -0,0 +1,141 @@
+#include "shell.h"
+
+/**
+ * hist_open - opens the history file on first use
+ * Return: 0 on success, -1 when there is no history
+ *
+ * The file is $HISTFILE, or ~/.hsh_history when that is unset. An empty
+ * HISTFILE, or a file that cannot be opened, keeps the history in an
+ * anonymous memory file for this shell only.
+ */
+static int hist_open(void)
+{
+	hist_t *h = &g_sh.hist;
+	const char *name = var_get("HISTFILE"), *home = var_get("HOME");
+	char path[PATH_MAX];
+
+	if (h->state != 0)
+		return (h->state > 0 ? 0 : -1);
+	h->fd = -1;
+	if (name == NULL && home != NULL &&
+		snprintf(path, sizeof(path), "%s/.hsh_history", home) <
+		(int)sizeof(path))
+		name = path;
+	if (name != NULL && *name != '\0')
+		h->fd = open(name, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC,
+			0600);
+	if (h->fd < 0)
+		h->fd = memfd_create("hsh_history", MFD_CLOEXEC);
+	h->state = h->fd >= 0 ? 1 : -1;
+	return (h->fd >= 0 ? 0 : -1);
+}
+
+/**
+ * hist_add - appends a record to the history
+ * @cmd: the command as typed
+ * @when: time the command started
+ * @ms: how long it ran, in milliseconds
+ * @status: its exit status
+ * Return: 0 on success or when the command is not kept, -1 on failure
+ *
+ * Blank commands are not kept. The record is built in memory and written
+ * with one write, so it lands in the file whole.
+ */
+int hist_add(const char *cmd, time_t when, long ms, int status)
+{
+	char head[80];
+	wbuf_t w;
+	int r;
+
+	if (cmd[strspn(cmd, " \t\n")] == '\0' || hist_open() != 0)
+		return (0);
+	memset(&w, 0, sizeof(w));
+	sprintf(head, "%ld;%ld;%d;", (long)when, ms, status);
+	wbuf_put(&w, head, strlen(head));
+	for (; *cmd; cmd++)
+		if (*cmd == '\n' && cmd[1] == '\0')
+			break;
+		else if (*cmd == '\n' || *cmd == '\\')
+		{
+			wbuf_putc(&w, '\\');
+			wbuf_putc(&w, *cmd == '\n' ? 'n' : '\\');
+		}
+		else
+			wbuf_putc(&w, *cmd);
+	r = wbuf_putc(&w, '\n') == 0 &&
+		write(g_sh.hist.fd, w.s, w.len) == (ssize_t)w.len ? 0 : -1;
+	free(w.s);
+	return (r);
+}
+
+/**
+ * hist_reset - forgets everything read from the history file
+ * @h: the history
+ */
+static void hist_reset(hist_t *h)
+{
+	unsigned int i;
+
+	if (h->map != NULL)
+		munmap(h->map, h->maplen);
+	for (i = 0; h->ix != NULL && i < (1U << HX_BITS); i++)
+		free(h->ix[i].d);
+	free(h->ix);
+	free(h->recs);
+	h->map = NULL;
+	h->maplen = 0;
+	h->size = 0;
+	h->recs = NULL;
+	h->nrecs = 0;
+	h->rcap = 0;
+	h->ix = NULL;
+	h->nix = 0;
+}
+
+/**
+ * hist_sync - picks up the records appended since the last call
+ * Return: 0 on success, -1 on failure
+ *
+ * Only the new tail of the file is mapped in and split into records, and
+ * only once the search index exists is it extended, so nothing is parsed
+ * until the history is first used. A record still being written, without
+ * its newline, is left for later.
+ */
+int hist_sync(void)
+{
+	hist_t *h = &g_sh.hist;
+	struct stat st;
+	size_t *r, len;
+	char *nl;
+
+	if (hist_open() != 0 || fstat(h->fd, &st) != 0)
+		return (-1);
+	if ((size_t)st.st_size < h->size)
+		hist_reset(h);
+	if ((size_t)st.st_size > h->maplen)
+	{
+		len = st.st_size + st.st_size / 2 + 4096;
+		if (h->map != NULL)
+			munmap(h->map, h->maplen);
+		h->map = mmap(NULL, len, PROT_READ, MAP_SHARED, h->fd, 0);
+		h->maplen = h->map != MAP_FAILED ? len : 0;
+		h->map = h->map != MAP_FAILED ? h->map : NULL;
+	}
+	while (h->map != NULL && h->size < (size_t)st.st_size &&
+		(nl = memchr(h->map + h->size, '\n', st.st_size - h->size)))
+	{
+		if (h->nrecs == h->rcap)
+		{
+			r = realloc(h->recs, (h->rcap * 2 + 1024) * sizeof(*r));
+			if (r == NULL)
+				return (-1);
+			h->recs = r;
+			h->rcap = h->rcap * 2 + 1024;
+		}
+		h->recs[h->nrecs++] = h->size;
+		h->size = nl + 1 - h->map;
+	}
+	if (h->ix != NULL)
+		hx_index(h);
+	return (h->map != NULL ? 0 : -1);
+}
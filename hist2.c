@@ -0,0 +1,67 @@
+#include "shell.h"
+
+/**
+ * hist_rec - finds the command of a record in the mapped file
+ * @i: the record, 0 for the oldest
+ * @len: receives the length of the command, still escaped
+ * Return: the start of the command
+ *
+ * A line without the three leading fields is taken as a bare command.
+ */
+const char *hist_rec(unsigned int i, size_t *len)
+{
+	hist_t *h = &g_sh.hist;
+	const char *p = h->map + h->recs[i], *end, *q;
+	int f;
+
+	end = i + 1 < h->nrecs ? h->map + h->recs[i + 1] - 1 :
+		h->map + h->size - 1;
+	for (q = p, f = 0; f < 3 && q != NULL; f++)
+		q = memchr(q, ';', end - q), q = q != NULL ? q + 1 : NULL;
+	if (q != NULL)
+		p = q;
+	*len = end - p;
+	return (p);
+}
+
+/**
+ * hist_text - decodes the command of a record
+ * @i: the record, 0 for the oldest
+ * Return: the command, valid until the next call, or NULL on failure
+ */
+const char *hist_text(unsigned int i)
+{
+	wbuf_t *t = &g_sh.hist.text;
+	const char *p;
+	size_t len, k;
+
+	if (i >= g_sh.hist.nrecs)
+		return (NULL);
+	p = hist_rec(i, &len);
+	t->len = 0;
+	if (wbuf_grow(t, len) != 0)
+		return (NULL);
+	for (k = 0; k < len; k++)
+		if (p[k] == '\\' && k + 1 < len)
+		{
+			k++;
+			t->s[t->len++] = p[k] == 'n' ? '\n' : p[k];
+		}
+		else
+			t->s[t->len++] = p[k];
+	t->s[t->len] = '\0';
+	return (t->s);
+}
+
+/**
+ * hist_get - gives a recent command
+ * @back: how far back to go, 1 for the newest
+ * Return: the command, valid until the next call, or NULL past the oldest
+ */
+const char *hist_get(int back)
+{
+	if (back < 1 || hist_sync() != 0 || (unsigned int)back >
+		g_sh.hist.nrecs)
+		return (NULL);
+	return (hist_text(g_sh.hist.nrecs - back));
+}
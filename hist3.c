@@ -0,0 +1,149 @@
+#include "shell.h"
+
+/**
+ * hx_key - hashes a trigram to its posting list
+ * @p: the three bytes
+ * Return: index of the posting list
+ */
+static unsigned int hx_key(const char *p)
+{
+	unsigned int t = ((unsigned char)p[0] << 16) |
+		((unsigned char)p[1] << 8) | (unsigned char)p[2];
+
+	return ((t * 2654435761U) >> (32 - HX_BITS));
+}
+
+/**
+ * hx_put - adds a record to a posting list once
+ * @b: the posting list
+ * @id: the record, never lower than the last one added
+ * Return: 0 on success, -1 on failure
+ */
+static int hx_put(hpost_t *b, unsigned int id)
+{
+	unsigned int d = id + 1 - b->last, cap;
+	unsigned char *n;
+
+	if (b->last == id + 1)
+		return (0);
+	if (b->len + 5 > b->cap)
+	{
+		cap = b->cap ? b->cap * 2 : 16;
+		n = realloc(b->d, cap);
+		if (n == NULL)
+			return (-1);
+		b->d = n;
+		b->cap = cap;
+	}
+	for (; d >= 0x80; d >>= 7)
+		b->d[b->len++] = (d & 0x7f) | 0x80;
+	b->d[b->len++] = d;
+	b->last = id + 1;
+	b->n++;
+	return (0);
+}
+
+/**
+ * hx_index - adds the records not yet indexed to the search index
+ * @h: the history, with @ix allocated
+ */
+void hx_index(hist_t *h)
+{
+	const char *p;
+	size_t len, k;
+
+	for (; h->nix < h->nrecs; h->nix++)
+	{
+		p = hist_rec(h->nix, &len);
+		for (k = 0; k + 2 < len; k++)
+			hx_put(&h->ix[hx_key(p + k)], h->nix);
+	}
+}
+
+/**
+ * hx_match - finds the newest record holding a string through the index
+ * @q: the escaped string, at least three bytes
+ * @len: length of @q
+ * @before: only records older than this one are considered
+ * Return: the record, or -1 when none matches
+ *
+ * Every record holding @q holds all of its trigrams, so only the records
+ * of the shortest posting list need to be looked at.
+ */
+static int hx_match(const char *q, size_t len, int before)
+{
+	hpost_t *b = NULL, *c;
+	unsigned int *ids, i = 0, v, id = 0, k;
+	const char *p;
+	size_t j, rlen;
+	int sh, r = -1;
+
+	for (j = 0; j + 2 < len; j++)
+	{
+		c = &g_sh.hist.ix[hx_key(q + j)];
+		b = b == NULL || c->n < b->n ? c : b;
+	}
+	ids = b->n > 0 ? malloc(b->n * sizeof(*ids)) : NULL;
+	for (k = 0; ids != NULL && k < b->n; k++)
+	{
+		for (v = 0, sh = 0; b->d[i] & 0x80; sh += 7)
+			v |= (b->d[i++] & 0x7f) << sh;
+		v |= b->d[i++] << sh;
+		id += v;
+		ids[k] = id - 1;
+	}
+	for (k = b->n; ids != NULL && r < 0 && k-- > 0;)
+	{
+		p = (int)ids[k] < before ? hist_rec(ids[k], &rlen) : NULL;
+		if (p != NULL && memmem(p, rlen, q, len) != NULL)
+			r = ids[k];
+	}
+	free(ids);
+	return (r);
+}
+
+/**
+ * hist_search - finds the newest record holding a string
+ * @q: the string
+ * @before: only records older than this one are considered, -1 for all
+ * Return: the record, or -1 when none matches
+ *
+ * Queries of three bytes or more go through the trigram index, which is
+ * built on the first such search; shorter ones scan back from the newest
+ * record and usually stop early.
+ */
+int hist_search(const char *q, int before)
+{
+	hist_t *h = &g_sh.hist;
+	const char *p;
+	size_t len;
+	wbuf_t e;
+	int r = -1;
+
+	memset(&e, 0, sizeof(e));
+	for (wbuf_put(&e, "", 0); *q; q++)
+		if (*q == '\n' || *q == '\\')
+			wbuf_put(&e, *q == '\n' ? "\\n" : "\\\\", 2);
+		else
+			wbuf_putc(&e, *q);
+	if (e.s != NULL && hist_sync() == 0)
+	{
+		if (before < 0 || (unsigned int)before > h->nrecs)
+			before = h->nrecs;
+		if (e.len >= 3 && h->ix == NULL)
+			h->ix = calloc(1U << HX_BITS, sizeof(*h->ix));
+		if (e.len >= 3 && h->ix != NULL)
+		{
+			hx_index(h);
+			r = hx_match(e.s, e.len, before);
+		}
+		while (r < 0 && (e.len < 3 || h->ix == NULL) && before-- > 0)
+		{
+			p = hist_rec(before, &len);
+			if (memmem(p, len, e.s, e.len) != NULL)
+				r = before;
+		}
+	}
+	free(e.s);
+	return (r);
+}
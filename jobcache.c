@@ -0,0 +1,82 @@
+#include "shell.h"
+
+/**
+ * jc_open - creates the lookup cache the scripts of -j share
+ *
+ * The cache is shared memory mapped before the scripts are forked, so a
+ * command one of them found in PATH is not searched for by the others.
+ * Without it each script only has its own cache.
+ */
+void jc_open(void)
+{
+	void *m = mmap(NULL, JC_SLOTS * sizeof(jcent_t),
+		PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	g_sh.jcache = m != MAP_FAILED ? m : NULL;
+}
+
+/**
+ * jc_find - looks up a command in the shared lookup cache
+ * @name: the command
+ * @path: the value of PATH it is looked up with
+ * Return: where it was found, or NULL
+ *
+ * Slots are taken in order from the hash of @name, and never freed, so
+ * the first free one ends the search.
+ */
+const char *jc_find(const char *name, const char *path)
+{
+	unsigned int h, ph, i, state;
+	jcent_t *e;
+
+	if (g_sh.jcache == NULL || strlen(name) >= JC_NAME)
+		return (NULL);
+	h = ht_hash(name);
+	ph = ht_hash(path);
+	for (i = 0; i < JC_PROBE; i++)
+	{
+		e = &g_sh.jcache[(h + i) & (JC_SLOTS - 1)];
+		state = __atomic_load_n(&e->state, __ATOMIC_ACQUIRE);
+		if (state == 0)
+			return (NULL);
+		if (state == 2 && e->hash == h && e->pathhash == ph &&
+			strcmp(e->name, name) == 0)
+			return (e->path);
+	}
+	return (NULL);
+}
+
+/**
+ * jc_add - adds a command to the shared lookup cache
+ * @name: the command
+ * @path: the value of PATH it was found with
+ * @full: where it was found
+ *
+ * A script claims a free slot, fills it and only then marks it ready, so
+ * the others never see half of one and no lock is needed. A full cache,
+ * or a name or path too long for a slot, is left out.
+ */
+void jc_add(const char *name, const char *path, const char *full)
+{
+	unsigned int h, i, state;
+	jcent_t *e;
+
+	if (g_sh.jcache == NULL || strlen(name) >= JC_NAME ||
+		strlen(full) >= JC_PATH)
+		return;
+	h = ht_hash(name);
+	for (i = 0; i < JC_PROBE; i++)
+	{
+		e = &g_sh.jcache[(h + i) & (JC_SLOTS - 1)];
+		state = 0;
+		if (!__atomic_compare_exchange_n(&e->state, &state, 1, 0,
+			__ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+			continue;
+		e->hash = h;
+		e->pathhash = ht_hash(path);
+		strcpy(e->name, name);
+		strcpy(e->path, full);
+		__atomic_store_n(&e->state, 2, __ATOMIC_RELEASE);
+		return;
+	}
+}
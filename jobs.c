@@ -0,0 +1,189 @@
+#include "shell.h"
+
+/**
+ * job_start - forks the shell to run one script of -j
+ * @j: receives the job
+ * @path: the script
+ * @shell_name: name of the shell
+ * Return: 0 on success, -1 on failure
+ *
+ * The copy has its own variables, directory, positional parameters and
+ * descriptors. It reads /dev/null, and its output is kept in memfds so
+ * that it can be written out in one piece once it is done. It is a "job"
+ * event of --trace-events, on a track of its own.
+ */
+static int job_start(job_t *j, const char *path, const char *shell_name)
+{
+	static char *none[] = {NULL};
+	int in = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+	j->out = memfd_create("hsh-job-out", MFD_CLOEXEC);
+	j->err = memfd_create("hsh-job-err", MFD_CLOEXEC);
+	j->pid = in >= 0 && j->out >= 0 && j->err >= 0 ? shell_fork() : -1;
+	if (j->pid == 0)
+	{
+		if (dup2(in, 0) < 0 || dup2(j->out, 1) < 0 ||
+			dup2(j->err, 2) < 0)
+			_exit(126);
+		g_sh.arg0 = (char *)path;
+		g_sh.params = none;
+		g_sh.nparams = 0;
+		g_sh.tail = 1;
+		shell_exit(run_script(path, shell_name));
+	}
+	if (j->pid > 0)
+		trace_stage("job", path, j->pid, in, j->out, j->err);
+	if (in >= 0)
+		close(in);
+	if (j->pid > 0)
+		return (0);
+	fprintf(stderr, "%s: 0: -j: cannot start %s: %s\n", shell_name, path,
+		strerror(errno));
+	j->status = 126;
+	return (-1);
+}
+
+/**
+ * job_write - writes out the rest of a memfd with read and write
+ * @fd: the memfd
+ * @off: where the rest starts
+ * @to: where it goes
+ * Return: 0 on success, -1 on failure with errno set
+ */
+static int job_write(int fd, off_t off, int to)
+{
+	static char buf[RB_BLOCK];
+	ssize_t n, w, done;
+
+	while ((n = pread(fd, buf, sizeof(buf), off)) != 0)
+	{
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0)
+			return (-1);
+		for (done = 0; done < n; done += w > 0 ? w : 0)
+		{
+			w = write(to, buf + done, n - done);
+			if (w < 0 && errno != EINTR)
+				return (-1);
+		}
+		off += n;
+	}
+	return (0);
+}
+
+/**
+ * job_copy - writes out what a script of -j wrote, then drops it
+ * @fd: the memfd holding it
+ * @to: where it goes
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 when the output could not be written
+ *
+ * sendfile refuses some outputs, such as files opened for appending;
+ * those get the rest with read and write.
+ */
+static int job_copy(int fd, int to, const char *shell_name)
+{
+	off_t off = 0;
+	ssize_t n;
+
+	if (fd < 0)
+		return (0);
+	do
+		n = sendfile(to, fd, &off, 1 << 30);
+	while (n > 0 || (n < 0 && errno == EINTR));
+	if (n < 0 && (errno == EINVAL || errno == ENOSYS))
+		n = job_write(fd, off, to);
+	if (n < 0)
+		fprintf(stderr, "%s: 0: -j: cannot write output: %s\n",
+			shell_name, strerror(errno));
+	close(fd);
+	return (n < 0 ? -1 : 0);
+}
+
+/**
+ * run_jobs - runs scripts side by side, each in its own copy of the shell
+ * @paths: the scripts
+ * @n: number of @paths
+ * @max: most scripts running at once
+ * @shell_name: name of the shell
+ * Return: 0 if every script succeeded, else the status of the first one,
+ * in the order given, that failed; 1 for one whose output could not be
+ * written
+ *
+ * The copies are forked from a shell that has already started up, so
+ * they share its startup work as well as one lookup cache. A script's
+ * standard output and error are written out when it finishes, each in
+ * one piece, so the output of different scripts never interleaves.
+ */
+int run_jobs(char *paths[], int n, int max, const char *shell_name)
+{
+	job_t *jobs = calloc(n, sizeof(*jobs));
+	int started = 0, running = 0, status = 0, st, i;
+	pid_t pid;
+
+	if (jobs == NULL)
+		return (1);
+	jc_open();
+	while (started < n || running > 0)
+	{
+		if (started < n && running < max)
+		{
+			running += job_start(&jobs[started], paths[started],
+				shell_name) == 0;
+			started++;
+			continue;
+		}
+		pid = -1;
+		st = spawn_wait(&pid, &g_sh.spawn);
+		if (st < 0)
+			break;
+		for (i = 0; i < started && jobs[i].pid != pid; i++)
+			;
+		if (i == started)
+			continue;
+		METRIC_ADD(jobs, -1);
+		running--;
+		jobs[i].pid = 0;
+		fflush(NULL);
+		if (job_copy(jobs[i].out, 1, shell_name) != 0 && st == 0)
+			st = 1;
+		if (job_copy(jobs[i].err, 2, shell_name) != 0 && st == 0)
+			st = 1;
+		jobs[i].status = st;
+		trace_end("job", paths[i], pid, st);
+	}
+	for (i = 0; i < n && status == 0; i++)
+		status = jobs[i].status;
+	free(jobs);
+	return (status);
+}
+
+/**
+ * jobs_args - handles a command line of the form -j N script...
+ * @argc: number of arguments after -j
+ * @argv: the arguments after -j
+ * @shell_name: name of the shell
+ * Return: exit status, as for run_jobs; 2 on a usage error
+ *
+ * N is the most scripts to run at once, 0 for the number of CPUs. The rc
+ * file runs once, before the scripts start.
+ */
+int jobs_args(int argc, char *argv[], const char *shell_name)
+{
+	int max;
+
+	if (argc < 2 || *argv[0] == '\0' || check_for_non_digit(argv[0]))
+	{
+		fprintf(stderr, "%s: 0: usage: -j N script...\n", shell_name);
+		return (2);
+	}
+	max = strlen(argv[0]) < 5 ? atoi(argv[0]) : 1024;
+	if (max <= 0)
+		max = sysconf(_SC_NPROCESSORS_ONLN);
+	max = max < 1 ? 1 : max > 1024 ? 1024 : max;
+	rc_load(shell_name, 0);
+	prof_mark("ready");
+	prof_report();
+	return (run_jobs(argv + 1, argc - 1, max, shell_name));
+}
@@ -0,0 +1,178 @@
+#include "shell.h"
+
+/**
+ * lex_skip - skips blanks, line continuations and comments
+ * @s: the source
+ */
+static void lex_skip(source_t *s)
+{
+	int c;
+
+	while ((c = src_peek(s)) != EOF)
+	{
+		if (c == ' ' || c == '\t' || c == '\r')
+			src_next(s);
+		else if (c == '\\' && s->pos + 1 < s->len &&
+			s->buf[s->pos + 1] == '\n')
+		{
+			src_next(s);
+			src_next(s);
+		}
+		else if (c == '#')
+			while ((c = src_peek(s)) != EOF && c != '\n')
+				src_next(s);
+		else
+			break;
+	}
+}
+
+static int lex_dollar(source_t *s, wbuf_t *b, int dq);
+
+/**
+ * lex_quoted - copies a quoted section of a word, quotes included
+ * @s: the source, positioned on the opening quote
+ * @b: the word being built
+ * Return: 0 on success, -1 on an unterminated quote
+ */
+static int lex_quoted(source_t *s, wbuf_t *b)
+{
+	int q = src_next(s), c;
+
+	wbuf_putc(b, q);
+	while ((c = src_peek(s)) != EOF)
+	{
+		if (q == '"' && (c == '$' || c == '`'))
+		{
+			if ((c == '$' ? lex_dollar(s, b, 1) :
+				lex_subst(s, b, '`')) != 0)
+				return (-1);
+			continue;
+		}
+		wbuf_putc(b, src_next(s));
+		if (c == q)
+			return (0);
+		if (c == '\\' && q == '"')
+		{
+			c = src_next(s);
+			if (c == EOF)
+				break;
+			wbuf_putc(b, c);
+		}
+	}
+	return (-1);
+}
+
+/**
+ * lex_dollar - copies a "$", and a whole ${...} or $(...) if one starts
+ * @s: the source, positioned on the "$"
+ * @b: the word being built
+ * @dq: nonzero inside double quotes, where single quotes are literal
+ * Return: 0 on success, -1 when the expansion is not terminated
+ */
+static int lex_dollar(source_t *s, wbuf_t *b, int dq)
+{
+	int c, depth = 1;
+
+	wbuf_putc(b, src_next(s));
+	if (src_peek(s) == '(')
+		return (lex_subst(s, b, ')'));
+	if (src_peek(s) != '{')
+		return (0);
+	wbuf_putc(b, src_next(s));
+	while ((c = src_peek(s)) != EOF)
+	{
+		if (c == '"' || (c == '\'' && !dq))
+		{
+			if (lex_quoted(s, b) != 0)
+				return (-1);
+			continue;
+		}
+		wbuf_putc(b, src_next(s));
+		if (c == '\\' && src_peek(s) != EOF)
+			wbuf_putc(b, src_next(s));
+		else if (c == '$' && src_peek(s) == '{')
+		{
+			wbuf_putc(b, src_next(s));
+			depth++;
+		}
+		else if (c == '}' && --depth == 0)
+			return (0);
+	}
+	return (-1);
+}
+
+/**
+ * lex_word - reads a word, keeping its quoting for the expander
+ * @s: the source
+ * @t: the token to fill in
+ * Return: the token type
+ *
+ * A single digit right before a "<" or ">" is the descriptor of the
+ * redirection that follows.
+ */
+static int lex_word(source_t *s, token_t *t)
+{
+	wbuf_t b = {NULL, 0, 0};
+	int c, r = 0;
+
+	while (r == 0 && (c = src_peek(s)) != EOF &&
+		!strchr(" \t\r\n;()<>|", c))
+	{
+		if (c == '\'' || c == '"' || c == '$' || c == '`')
+		{
+			r = c == '$' ? lex_dollar(s, &b, 0) : c == '`' ?
+				lex_subst(s, &b, '`') : lex_quoted(s, &b);
+			continue;
+		}
+		src_next(s);
+		if (c == '\\' && src_peek(s) == '\n')
+		{
+			src_next(s);
+			continue;
+		}
+		wbuf_putc(&b, c);
+		if (c == '\\' && src_peek(s) != EOF)
+			wbuf_putc(&b, src_next(s));
+	}
+	if (r == 0 && (c == '<' || c == '>') && b.len == 1 &&
+		b.s[0] >= '0' && b.s[0] <= '9')
+		return (lex_redir(s, &b, t));
+	if (r != 0 || b.s == NULL)
+	{
+		free(b.s);
+		t->word = r ? "Unterminated quoted string" : "out of memory";
+		return (t->type = T_ERROR);
+	}
+	t->word = b.s;
+	return (t->type = T_WORD);
+}
+
+/**
+ * lex_token - reads the next token
+ * @s: the source
+ * @t: filled in with the token; the text of a T_WORD or T_REDIR is
+ * malloc'd
+ * Return: the token type
+ */
+int lex_token(source_t *s, token_t *t)
+{
+	wbuf_t b = {NULL, 0, 0};
+	int c;
+
+	lex_skip(s);
+	t->line = s->lineno;
+	t->word = NULL;
+	c = src_peek(s);
+	if (c == EOF)
+		return (t->type = T_EOF);
+	if (c == '\n' || c == ';' || c == '(' || c == ')' || c == '|')
+	{
+		src_next(s);
+		t->type = c == '\n' ? T_NEWLINE : c == ';' ? T_SEMI :
+			c == '(' ? T_LPAREN : c == ')' ? T_RPAREN : T_PIPE;
+		return (t->type);
+	}
+	if (c == '<' || c == '>')
+		return (lex_redir(s, &b, t));
+	return (lex_word(s, t));
+}
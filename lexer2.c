@@ -0,0 +1,70 @@
+#include "shell.h"
+
+/**
+ * lex_redir - reads a redirection operator
+ * @s: the source, positioned on the "<" or ">"
+ * @b: holds the descriptor number before the operator, if any
+ * @t: the token to fill in
+ * Return: T_REDIR, or T_ERROR when out of memory
+ *
+ * The operators are < > >> >| <> <& >& << <<- and <<<.
+ */
+int lex_redir(source_t *s, wbuf_t *b, token_t *t)
+{
+	int c = src_next(s), n = src_peek(s);
+
+	wbuf_putc(b, c);
+	if (n == c || n == '&' || (c == '<' && n == '>') ||
+		(c == '>' && n == '|'))
+	{
+		wbuf_putc(b, src_next(s));
+		n = src_peek(s);
+		if (c == '<' && b->s != NULL && b->s[b->len - 1] == '<' &&
+			(n == '-' || n == '<'))
+			wbuf_putc(b, src_next(s));
+	}
+	t->word = b->s != NULL ? b->s : "out of memory";
+	return (t->type = b->s != NULL ? T_REDIR : T_ERROR);
+}
+
+/**
+ * lex_subst - copies a whole $(...) or `...` command substitution
+ * @s: the source, positioned on the "(" or the opening backquote
+ * @b: the word being built
+ * @close: ')' or '`'
+ * Return: 0 on success, -1 when the substitution is not terminated
+ *
+ * Inside $(...) quotes are honoured and parentheses nest, so the command
+ * may hold words that would otherwise end the outer one; the command is
+ * only parsed when the substitution is expanded.
+ */
+int lex_subst(source_t *s, wbuf_t *b, int close)
+{
+	int c, q = 0, depth = 0;
+
+	wbuf_putc(b, src_next(s));
+	while ((c = src_next(s)) != EOF)
+	{
+		wbuf_putc(b, c);
+		if (c == '\\' && q != '\'' && src_peek(s) != EOF)
+			wbuf_putc(b, src_next(s));
+		else if (close == '`' && c == close)
+			return (0);
+		else if (close == '`')
+			continue;
+		else if (q != 0 && c == q)
+			q = 0;
+		else if (q == 0 && (c == '\'' || c == '"'))
+			q = c;
+		else if (q != '\'' && c == '$' && src_peek(s) == '(')
+		{
+			if (lex_subst(s, b, ')') != 0)
+				return (-1);
+		}
+		else if (q == 0 && c == '(')
+			depth++;
+		else if (q == 0 && c == ')' && depth-- == 0)
+			return (0);
+	}
+	return (-1);
+}
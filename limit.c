@@ -0,0 +1,128 @@
+#include "shell.h"
+
+/**
+ * limit_num - parses the value of a limit option
+ * @s: the value
+ * @size: nonzero to allow a K, M, G or T suffix
+ * Return: the value, -1 if it is not a positive number
+ */
+static long limit_num(const char *s, int size)
+{
+	const char *units = "KMGT", *u;
+	char *end;
+	long v;
+
+	errno = 0;
+	v = strtol(s, &end, 10);
+	if (end == s || v <= 0 || errno != 0)
+		return (-1);
+	u = size && *end != '\0' ? strchr(units, *end & ~0x20) : NULL;
+	if (u != NULL)
+	{
+		for (; u >= units; u--)
+			if (v > LONG_MAX / 1024)
+				return (-1);
+			else
+				v *= 1024;
+		end++;
+	}
+	return (*end == '\0' ? v : -1);
+}
+
+/**
+ * limit_opt - applies one option of the limit builtin
+ * @sp: the settings
+ * @opt: the option letter
+ * @arg: its value
+ * Return: 0 on success, -1 for a bad option or value
+ */
+static int limit_opt(spawn_t *sp, int opt, const char *arg)
+{
+	long v = arg != NULL ? limit_num(arg, opt == 'm') : -1;
+
+	if (v < 0 || ((opt == 'c' || opt == 'i') && v > 10000))
+		return (-1);
+	if (opt == 'm')
+		sp->mem = v, sp->lim |= LIM_MEM;
+	else if (opt == 'c')
+		sp->cpu_weight = v, sp->lim |= LIM_CPU;
+	else if (opt == 'p')
+		sp->pids = v, sp->lim |= LIM_PIDS;
+	else if (opt == 'i')
+		sp->io_weight = v, sp->lim |= LIM_IO;
+	else
+		return (-1);
+	return (0);
+}
+
+/**
+ * limit_opts - parses the options of the limit builtin
+ * @args: the arguments, args[0] being "limit"
+ * @sp: the settings
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: index of the command, -1 on a usage error
+ */
+static int limit_opts(char **args, spawn_t *sp, const char *shell_name,
+int line)
+{
+	const char *arg;
+	int i;
+
+	for (i = 1; args[i] != NULL && args[i][0] == '-'; i++)
+	{
+		if (strcmp(args[i], "--") == 0)
+			return (args[i + 1] != NULL ? i + 1 : -1);
+		arg = args[i][1] != '\0' && args[i][2] != '\0' ? args[i] + 2 :
+			args[i + 1];
+		if (limit_opt(sp, args[i][1], arg) != 0)
+		{
+			fprintf(stderr, "%s: %d: limit: bad option: %s\n",
+				shell_name, line, args[i]);
+			return (-1);
+		}
+		i += arg == args[i + 1];
+	}
+	return (args[i] != NULL ? i : -1);
+}
+
+/**
+ * handle_limit - runs a command under resource limits
+ * @args: "limit", the options and the command
+ * @shell_name: name of the shell
+ * @command_count: line number, for messages
+ * @status: exit status of the last command
+ * @input: the input line, for exit
+ * Return: exit status of the command, 2 on a usage error
+ *
+ * Usage: limit [-m SIZE] [-c WEIGHT] [-p N] [-i WEIGHT] [--] command
+ * The command runs in a cgroup leaf of its own, with memory.max,
+ * cpu.weight, pids.max and io.weight set, and its peak usage is reported
+ * when it finishes. Limits nest: an inner limit starts from the outer one.
+ */
+int handle_limit(char *args[], const char *shell_name, int command_count,
+int status, char *input)
+{
+	spawn_t saved = g_sh.spawn, *sp = &g_sh.spawn;
+	int i = limit_opts(args, sp, shell_name, command_count);
+
+	if (i < 0)
+	{
+		fprintf(stderr, "%s: %d: limit: usage: limit [-m SIZE] "
+			"[-c WEIGHT] [-p N] [-i WEIGHT] [--] command\n",
+			shell_name, command_count);
+		g_sh.spawn = saved;
+		return (2);
+	}
+	sp->cgroup = NULL;
+	sp->maxrss = 0;
+	sp->cpu_us = 0;
+	cg_create(sp);
+	status = chK(args + i, shell_name, command_count, status, input);
+	cg_finish(sp, shell_name, command_count);
+	if (sp->maxrss > saved.maxrss)
+		saved.maxrss = sp->maxrss;
+	saved.cpu_us += sp->cpu_us;
+	g_sh.spawn = saved;
+	return (status);
+}
@@ -0,0 +1,144 @@
+#include "shell.h"
+
+/**
+ * le_mode - switches the terminal in and out of raw mode
+ * @raw: nonzero to enter raw mode, 0 to restore the saved mode
+ * Return: 0 on success, -1 when standard input is not a terminal
+ *
+ * Output processing is left on, so "\n" still moves to a new line.
+ */
+static int le_mode(int raw)
+{
+	static struct termios saved;
+	struct termios t;
+
+	if (!raw)
+		return (tcsetattr(STDIN_FILENO, TCSADRAIN, &saved));
+	if (tcgetattr(STDIN_FILENO, &saved) != 0)
+		return (-1);
+	t = saved;
+	t.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+	t.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+	t.c_cc[VMIN] = 1;
+	t.c_cc[VTIME] = 0;
+	return (tcsetattr(STDIN_FILENO, TCSADRAIN, &t));
+}
+
+/**
+ * le_width - counts the columns taken by UTF-8 text
+ * @s: the text
+ * @n: its length in bytes
+ * Return: the number of characters, taken as one column each
+ */
+static size_t le_width(const char *s, size_t n)
+{
+	size_t w = 0, i;
+
+	for (i = 0; i < n; i++)
+		w += ((unsigned char)s[i] & 0xc0) != 0x80;
+	return (w);
+}
+
+/**
+ * le_refresh - redraws the prompt and the line with a single write
+ * @e: the editor
+ *
+ * A line wider than the terminal scrolls sideways to keep the cursor
+ * in view.
+ */
+void le_refresh(lined_t *e)
+{
+	size_t start = 0, avail, show, col;
+	char mv[32];
+	wbuf_t o;
+
+	avail = (size_t)e->cols > e->plen + 1 ? e->cols - e->plen - 1 : 1;
+	while (le_width(e->b.s + start, e->pos - start) > avail)
+		start++;
+	for (show = e->b.len - start; le_width(e->b.s + start, show) > avail;)
+		show--;
+	col = e->plen + le_width(e->b.s + start, e->pos - start);
+	memset(&o, 0, sizeof(o));
+	wbuf_put(&o, "\r", 1);
+	wbuf_put(&o, e->ps, strlen(e->ps));
+	wbuf_put(&o, e->b.s + start, show);
+	wbuf_put(&o, "\033[K\r", 4);
+	if (col > 0)
+	{
+		sprintf(mv, "\033[%luC", (unsigned long)col);
+		wbuf_put(&o, mv, strlen(mv));
+	}
+	if (o.s != NULL && write(STDOUT_FILENO, o.s, o.len) < 0)
+		o.len = 0;
+	free(o.s);
+}
+
+/**
+ * le_done - hands over an edited line
+ * @e: the editor
+ * @linep: getline style buffer receiving the line and its newline
+ * @capp: size of *@linep
+ * Return: length of the line including the newline, -1 on failure
+ */
+static ssize_t le_done(lined_t *e, char **linep, size_t *capp)
+{
+	char *p;
+
+	if (*capp < e->b.len + 2)
+	{
+		p = realloc(*linep, e->b.len + 2);
+		if (p == NULL)
+			return (-1);
+		*linep = p;
+		*capp = e->b.len + 2;
+	}
+	printf("\n");
+	fflush(stdout);
+	memcpy(*linep, e->b.s, e->b.len);
+	strcpy(*linep + e->b.len, "\n");
+	return (e->b.len + 1);
+}
+
+/**
+ * le_read - reads a line from the terminal with editing
+ * @ps: the prompt
+ * @linep: getline style buffer receiving the line and its newline
+ * @capp: size of *@linep
+ * Return: length of the line, -1 at end of input
+ *
+ * Falls back to getline when standard input is not a terminal.
+ */
+ssize_t le_read(const char *ps, char **linep, size_t *capp)
+{
+	struct winsize ws;
+	lined_t e;
+	unsigned char c;
+	ssize_t r = 0, n;
+
+	ps = ps != NULL ? ps : "";
+	if (le_mode(1) != 0)
+	{
+		printf("%s", ps);
+		fflush(stdout);
+		return (getline(linep, capp, stdin));
+	}
+	memset(&e, 0, sizeof(e));
+	e.ps = ps;
+	e.plen = le_width(ps, strlen(ps));
+	e.cols = ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col ?
+		ws.ws_col : 80;
+	wbuf_put(&e.b, "", 0);
+	le_refresh(&e);
+	while (r == 0 && e.b.s != NULL)
+		if ((n = read(STDIN_FILENO, &c, 1)) == 1)
+			r = le_key(&e, c);
+		else if (n < 0 && errno == EINTR)
+			continue;
+		else
+			r = -1;
+	le_mode(0);
+	n = r > 0 ? le_done(&e, linep, capp) : -1;
+	free(e.b.s);
+	free(e.saved);
+	return (n);
+}
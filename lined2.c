@@ -0,0 +1,136 @@
+#include "shell.h"
+
+/**
+ * le_insert - inserts text at the cursor
+ * @e: the editor
+ * @s: the text
+ * @n: its length
+ * Return: 0 on success, -1 on failure
+ */
+int le_insert(lined_t *e, const char *s, size_t n)
+{
+	if (wbuf_grow(&e->b, n) != 0)
+		return (-1);
+	memmove(e->b.s + e->pos + n, e->b.s + e->pos, e->b.len - e->pos + 1);
+	memcpy(e->b.s + e->pos, s, n);
+	e->b.len += n;
+	e->pos += n;
+	return (0);
+}
+
+/**
+ * le_erase - deletes part of the line, moving the cursor to its start
+ * @e: the editor
+ * @from: first byte to delete
+ * @to: byte after the last one to delete
+ */
+void le_erase(lined_t *e, size_t from, size_t to)
+{
+	memmove(e->b.s + from, e->b.s + to, e->b.len - to + 1);
+	e->b.len -= to - from;
+	e->pos = from;
+}
+
+/**
+ * le_hist - shows an older or newer history entry
+ * @e: the editor
+ * @dir: 1 for older, -1 for newer
+ *
+ * The line being edited is kept aside and comes back past the newest
+ * entry.
+ */
+static void le_hist(lined_t *e, int dir)
+{
+	int i = e->hidx + dir;
+	const char *s = i > 0 ? hist_get(i) : e->saved;
+
+	if (i < 0 || (i > 0 && s == NULL))
+		return;
+	if (e->hidx == 0)
+	{
+		free(e->saved);
+		e->saved = strdup(e->b.s);
+	}
+	e->hidx = i;
+	le_erase(e, 0, e->b.len);
+	if (s != NULL)
+		le_insert(e, s, strlen(s));
+}
+
+/**
+ * le_esc - reads the rest of an escape sequence
+ * Return: the control key the sequence stands for, 0 if unknown, and
+ * 256 for the delete key
+ */
+static int le_esc(void)
+{
+	unsigned char s[3];
+
+	if (read(STDIN_FILENO, s, 1) != 1 || (s[0] != '[' && s[0] != 'O') ||
+		read(STDIN_FILENO, s + 1, 1) != 1)
+		return (0);
+	if (s[1] >= '0' && s[1] <= '9')
+	{
+		if (read(STDIN_FILENO, s + 2, 1) != 1 || s[2] != '~')
+			return (0);
+		return (s[1] == '3' ? 256 : s[1] == '1' || s[1] == '7' ? 1 :
+			s[1] == '4' || s[1] == '8' ? 5 : 0);
+	}
+	switch (s[1])
+	{
+	case 'A':
+		return (16);
+	case 'B':
+		return (14);
+	case 'C':
+		return (6);
+	case 'D':
+		return (2);
+	case 'H':
+		return (1);
+	case 'F':
+		return (5);
+	}
+	return (0);
+}
+
+/**
+ * le_key - handles one key
+ * @e: the editor
+ * @c: the key
+ * Return: 1 when the line is complete, -1 at end of input, 0 otherwise
+ *
+ * Keys follow emacs mode: ^P and ^N walk the history, ^R searches it,
+ * tab completes, ^L clears the screen and ^C drops the line; see le_edit
+ * for the rest.
+ */
+int le_key(lined_t *e, int c)
+{
+	char ch = c;
+
+	if (c == 18)
+		c = le_search(e);
+	if (c == 27)
+		c = le_esc();
+	if (c == '\r' || c == '\n')
+		return (1);
+	if (c == 4 && e->b.len == 0)
+		return (-1);
+	e->tabs = c == '\t' ? e->tabs + 1 : 0;
+	if (c == 3)
+	{
+		le_erase(e, 0, e->b.len);
+		printf("^C");
+		return (1);
+	}
+	if (c == 16 || c == 14)
+		le_hist(e, c == 16 ? 1 : -1);
+	else if (c == '\t')
+		le_complete(e);
+	else if (c == 12 && write(STDOUT_FILENO, "\033[H\033[2J", 7) < 0)
+		return (-1);
+	else if (!le_edit(e, c) && c >= 32 && c < 256 && c != 127)
+		le_insert(e, &ch, 1);
+	le_refresh(e);
+	return (0);
+}
@@ -0,0 +1,65 @@
+#include "shell.h"
+
+/**
+ * le_prev - finds the start of the character before a position
+ * @e: the editor
+ * @p: the position
+ * Return: the start of the previous UTF-8 character
+ */
+static size_t le_prev(lined_t *e, size_t p)
+{
+	while (p > 0 && ((unsigned char)e->b.s[--p] & 0xc0) == 0x80)
+		;
+	return (p);
+}
+
+/**
+ * le_next - finds the end of the character at a position
+ * @e: the editor
+ * @p: the position
+ * Return: the start of the next UTF-8 character
+ */
+static size_t le_next(lined_t *e, size_t p)
+{
+	if (p < e->b.len)
+		p++;
+	while (p < e->b.len && ((unsigned char)e->b.s[p] & 0xc0) == 0x80)
+		p++;
+	return (p);
+}
+
+/**
+ * le_edit - handles the cursor movement and deletion keys
+ * @e: the editor
+ * @c: the key; 256 stands for the delete key
+ * Return: 1 if @c was handled, 0 otherwise
+ *
+ * ^A ^E ^B ^F move, backspace ^D and delete remove a character, and
+ * ^K ^U ^W kill to the end, to the start and the previous word.
+ */
+int le_edit(lined_t *e, int c)
+{
+	size_t p = e->pos;
+
+	if (c == 1 || c == 5)
+		e->pos = c == 1 ? 0 : e->b.len;
+	else if (c == 2 || c == 6)
+		e->pos = c == 2 ? le_prev(e, p) : le_next(e, p);
+	else if (c == 8 || c == 127)
+		le_erase(e, le_prev(e, p), p);
+	else if (c == 4 || c == 256)
+		le_erase(e, p, le_next(e, p));
+	else if (c == 11 || c == 21)
+		le_erase(e, c == 11 ? p : 0, c == 11 ? e->b.len : p);
+	else if (c == 23)
+	{
+		while (p > 0 && e->b.s[p - 1] == ' ')
+			p--;
+		while (p > 0 && e->b.s[p - 1] != ' ')
+			p--;
+		le_erase(e, p, e->pos);
+	}
+	else
+		return (0);
+	return (1);
+}
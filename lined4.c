@@ -0,0 +1,112 @@
+#include "shell.h"
+
+/**
+ * le_word - finds the word being completed
+ * @e: the editor
+ * @cmd: set to nonzero when the word is in command position
+ * Return: offset of the start of the word; it ends at the cursor
+ */
+static size_t le_word(lined_t *e, int *cmd)
+{
+	const char *s = e->b.s;
+	size_t i = e->pos, j;
+
+	while (i > 0 && (strchr(" \t;|&()<>", s[i - 1]) == NULL ||
+		(i > 1 && s[i - 2] == '\\')))
+		i--;
+	for (j = i; j > 0 && (s[j - 1] == ' ' || s[j - 1] == '\t'); j--)
+		;
+	*cmd = j == 0 || strchr(";|&(", s[j - 1]) != NULL;
+	return (i);
+}
+
+/**
+ * le_quote - appends a name with the bytes special to the shell escaped
+ * @w: the buffer
+ * @s: the name
+ */
+static void le_quote(wbuf_t *w, const char *s)
+{
+	for (; *s; s++)
+	{
+		if (strchr(" \t\n'\"\\$`;&|()<>*?[#~!{}", *s) != NULL)
+			wbuf_putc(w, '\\');
+		wbuf_putc(w, *s);
+	}
+}
+
+/**
+ * le_list - prints the candidates in columns below the line
+ * @e: the editor
+ * @c: the candidates
+ */
+static void le_list(lined_t *e, cands_t *c)
+{
+	char **v = malloc((c->n + 1) * sizeof(*v)), *p = c->text.s;
+	size_t w = 0;
+	int i, per, n = c->n < LE_MAXLIST ? c->n : LE_MAXLIST;
+
+	for (i = 0; v != NULL && i < c->n; i++, p += strlen(p) + 1)
+	{
+		v[i] = p + c->skip;
+		w = strlen(v[i]) > w ? strlen(v[i]) : w;
+	}
+	if (v == NULL)
+		return;
+	qsort(v, c->n, sizeof(*v), glob_cmp);
+	per = e->cols / (int)(w + 2);
+	per = per > 0 ? per : 1;
+	printf("\n");
+	for (i = 0; i < n; i++)
+		printf("%-*s%s", (int)(w + 2), v[i],
+			i % per == per - 1 || i == n - 1 ? "\n" : "");
+	if (c->more)
+		printf("(more than %d matches)\n", LE_MAXLIST);
+	fflush(stdout);
+	free(v);
+}
+
+/**
+ * le_complete - completes the word before the cursor
+ * @e: the editor
+ *
+ * Command names come from the completion trie and anything else from
+ * the file system. The word is extended by what all candidates share;
+ * a second tab lists them when that adds nothing.
+ */
+void le_complete(lined_t *e)
+{
+	cands_t c;
+	wbuf_t q;
+	size_t start;
+	int cmd;
+	char *raw, *word;
+
+	start = le_word(e, &cmd);
+	raw = strndup(e->b.s + start, e->pos - start);
+	word = raw != NULL ? unquote(raw) : NULL;
+	free(raw);
+	if (word == NULL)
+		return;
+	if (cmd && strchr(word, '/') == NULL)
+		comp_cmds(word, &c);
+	else
+		comp_files(word, &c);
+	memset(&q, 0, sizeof(q));
+	if (c.n > 0 && (c.unique || strlen(c.lcp) > strlen(word)))
+	{
+		le_quote(&q, c.lcp);
+		if (c.unique && q.len > 0 && q.s[q.len - 1] != '/')
+			wbuf_putc(&q, ' ');
+		le_erase(e, start, e->pos);
+		le_insert(e, q.s, q.len);
+	}
+	else if (c.n > 0 && e->tabs > 1)
+		le_list(e, &c);
+	else if (write(STDOUT_FILENO, "\a", 1) < 0)
+		c.n = 0;
+	free(q.s);
+	free(c.lcp);
+	free(c.text.s);
+	free(word);
+}
@@ -0,0 +1,70 @@
+#include "shell.h"
+
+/**
+ * le_show - draws the reverse search prompt
+ * @q: the query
+ * @at: the matching record, -1 for none
+ */
+static void le_show(wbuf_t *q, int at)
+{
+	const char *m = at >= 0 ? hist_text(at) : NULL;
+	wbuf_t o;
+
+	memset(&o, 0, sizeof(o));
+	wbuf_put(&o, "\r(", 2);
+	if (at < 0 && q->len > 0)
+		wbuf_put(&o, "failed ", 7);
+	wbuf_put(&o, "reverse-i-search)`", 18);
+	wbuf_put(&o, q->s, q->len);
+	wbuf_put(&o, "': ", 3);
+	if (m != NULL)
+		wbuf_put(&o, m, strcspn(m, "\n"));
+	wbuf_put(&o, "\033[K", 3);
+	if (o.s != NULL && write(STDOUT_FILENO, o.s, o.len) < 0)
+		o.len = 0;
+	free(o.s);
+}
+
+/**
+ * le_search - searches the history backwards as the query is typed
+ * @e: the editor
+ * Return: the key that ended the search, to be handled as usual, or 0
+ * when the search was cancelled
+ *
+ * Another ^R looks for an older match; any key other than a printable
+ * byte, backspace, ^G or ^C puts the match on the line.
+ */
+int le_search(lined_t *e)
+{
+	wbuf_t q;
+	unsigned char c = 18;
+	int at = -1, prev;
+	const char *m;
+
+	memset(&q, 0, sizeof(q));
+	wbuf_put(&q, "", 0);
+	for (le_show(&q, at); read(STDIN_FILENO, &c, 1) == 1; le_show(&q, at))
+	{
+		prev = at;
+		if (c == 18 && q.len > 0)
+			at = hist_search(q.s, at);
+		else if ((c == 127 || c == 8) && q.len > 0)
+		{
+			q.s[--q.len] = '\0';
+			at = hist_search(q.s, -1);
+		}
+		else if (c >= 32 && c != 127 && wbuf_putc(&q, c) == 0)
+			at = hist_search(q.s, at >= 0 ? at + 1 : -1);
+		else if (c != 18)
+			break;
+		at = at < 0 && c == 18 ? prev : at;
+	}
+	m = at >= 0 && c != 7 && c != 3 ? hist_text(at) : NULL;
+	if (m != NULL)
+	{
+		le_erase(e, 0, e->b.len);
+		le_insert(e, m, strlen(m));
+	}
+	free(q.s);
+	return (c == 7 || c == 3 ? 0 : c);
+}
@@ -0,0 +1,101 @@
+#include "shell.h"
+
+/**
+ * redir_kids - opens and applies the redirections of a compound command
+ * @n: the N_WHILE or N_SUBSHELL node
+ * @first: index of its first N_REDIR kid
+ * @r: receives the redirections
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * Return: 1 when standard input is now a pipe opened for the command,
+ * such as that of a here-document; 0 when it is not; -1 on failure, with
+ * nothing applied
+ */
+int redir_kids(node_t *n, int first, redir_t *r, const char *shell_name,
+int status)
+{
+	expand_t *x = expand_get(status, shell_name, n->line);
+	node_t v = *n;
+	char **vals = NULL;
+	int i, own = 0;
+
+	r->n = 0;
+	v.kids += first;
+	v.nkids -= first;
+	if (x != NULL)
+	{
+		redir_expand(x, &v);
+		vals = expand_words(x, NULL, 0, 0);
+	}
+	if (vals == NULL || redir_open(r, &v, vals, shell_name) != 0)
+	{
+		expand_put(x);
+		return (-1);
+	}
+	expand_put(x);
+	if (redir_apply(r) != 0)
+	{
+		redir_close(r);
+		return (-1);
+	}
+	for (i = 0; i < r->n; i++)
+		if (r->fd[i] == 0)
+			own = r->own >> i & 1;
+	return (own);
+}
+
+/**
+ * redir_done - undoes what redir_kids applied
+ * @r: the redirections
+ * @own: nonzero when the command took its input with read_own
+ */
+void redir_done(redir_t *r, int own)
+{
+	if (own)
+		read_disown();
+	if (r->n > 0)
+	{
+		redir_restore(r);
+		redir_close(r);
+	}
+}
+
+/**
+ * exec_while - runs a while or until loop
+ * @n: the N_WHILE node
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the last run of the body, 0 if it never ran,
+ * or that of a return leaving the loop
+ *
+ * Redirections after "done" apply to the whole loop, so that
+ * "while read line; do ...; done < file" opens the file once and each
+ * read continues where the last one stopped. Nothing in a loop is the
+ * tail of a script, as the condition always runs again.
+ */
+int exec_while(node_t *n, const char *shell_name, int status, char *input)
+{
+	int tail = g_sh.tail, until = n->words[0][0] == 'u';
+	int own = 0, last = 0;
+	redir_t r;
+
+	r.n = 0;
+	if (n->nkids > 2)
+		own = redir_kids(n, 2, &r, shell_name, status);
+	if (own < 0)
+		return (1);
+	own = own && read_own(0);
+	g_sh.tail = 0;
+	while (!g_sh.returning)
+	{
+		status = exec_node(n->kids[0], shell_name, status, input);
+		if (g_sh.returning || (status == 0) == until)
+			break;
+		status = exec_node(n->kids[1], shell_name, status, input);
+		last = status;
+	}
+	g_sh.tail = tail;
+	redir_done(&r, own);
+	return (g_sh.returning ? status : last);
+}
@@ -0,0 +1,54 @@
+#include "shell.h"
+
+/**
+ * metrics_open - creates the shared metrics block of --metrics
+ * @file: the file to map; a bare name is created in /dev/shm
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 on failure
+ *
+ * The block is mapped once at startup and then only written through
+ * memory, so keeping it up to date costs no system calls. It is left
+ * behind when the shell exits, holding the final counts.
+ */
+int metrics_open(const char *file, const char *shell_name)
+{
+	char path[PATH_MAX];
+	metrics_t *m = MAP_FAILED;
+	int fd, n;
+
+	n = snprintf(path, sizeof(path), "%s%s",
+		strchr(file, '/') != NULL ? "" : "/dev/shm/", file);
+	fd = n > 0 && (size_t)n < sizeof(path) ? open(path,
+		O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : -1;
+	if (fd >= 0 && ftruncate(fd, sizeof(*m)) == 0)
+		m = mmap(NULL, sizeof(*m), PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+	if (fd >= 0)
+		close(fd);
+	if (m == MAP_FAILED)
+	{
+		fprintf(stderr, "%s: 0: --metrics: %s: %s\n", shell_name,
+			file, strerror(errno));
+		return (-1);
+	}
+	m->size = sizeof(*m);
+	m->pid = getpid();
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(m->magic, METRICS_MAGIC, 8);
+	g_sh.metrics = m;
+	return (0);
+}
+
+/**
+ * metrics_now - reads the monotonic clock for the metrics timers
+ * Return: the time in nanoseconds, 0 when there is no metrics block
+ */
+uint64_t metrics_now(void)
+{
+	struct timespec t;
+
+	if (g_sh.metrics == NULL)
+		return (0);
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return ((uint64_t)t.tv_sec * 1000000000U + t.tv_nsec);
+}
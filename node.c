@@ -0,0 +1,100 @@
+#include "shell.h"
+
+/**
+ * node_new - allocates an empty parse tree node
+ * @type: one of the N_* node types
+ * @line: line number the node starts on
+ * Return: the new node, or NULL on failure
+ */
+node_t *node_new(int type, int line)
+{
+	node_t *n = malloc(sizeof(*n));
+
+	if (n == NULL)
+		return (NULL);
+	n->type = type;
+	n->flags = 0;
+	n->line = line;
+	n->nwords = 0;
+	n->words = NULL;
+	n->nkids = 0;
+	n->kids = NULL;
+	return (n);
+}
+
+/**
+ * grow_array - makes room for one more entry in a NULL terminated array
+ * @arr: the array, may be NULL
+ * @count: number of entries currently in the array
+ * Return: the (possibly moved) array, or NULL on failure
+ *
+ * Capacity doubles, so it is implied by @count and need not be stored.
+ */
+static void **grow_array(void **arr, int count)
+{
+	int cap = 4;
+
+	while (cap < count + 1)
+		cap <<= 1;
+	if (arr != NULL && count + 2 <= cap)
+		return (arr);
+	if (arr != NULL)
+		cap <<= 1;
+	return (realloc(arr, cap * sizeof(void *)));
+}
+
+/**
+ * node_add_word - appends a word to a node, taking ownership of it
+ * @n: the node
+ * @word: malloc'd word
+ * Return: 0 on success, -1 on failure
+ */
+int node_add_word(node_t *n, char *word)
+{
+	void **arr = grow_array((void **)n->words, n->nwords);
+
+	if (arr == NULL)
+		return (-1);
+	n->words = (char **)arr;
+	n->words[n->nwords++] = word;
+	n->words[n->nwords] = NULL;
+	return (0);
+}
+
+/**
+ * node_add_kid - appends a child node
+ * @n: the parent node
+ * @kid: the child node
+ * Return: 0 on success, -1 on failure
+ */
+int node_add_kid(node_t *n, node_t *kid)
+{
+	void **arr = grow_array((void **)n->kids, n->nkids);
+
+	if (arr == NULL)
+		return (-1);
+	n->kids = (node_t **)arr;
+	n->kids[n->nkids++] = kid;
+	n->kids[n->nkids] = NULL;
+	return (0);
+}
+
+/**
+ * node_free - frees a node and all of its children
+ * @n: the node, may be NULL
+ */
+void node_free(node_t *n)
+{
+	int i;
+
+	if (n == NULL)
+		return;
+	if (!(n->flags & NF_BORROWED))
+		for (i = 0; i < n->nwords; i++)
+			free(n->words[i]);
+	for (i = 0; i < n->nkids; i++)
+		node_free(n->kids[i]);
+	free(n->words);
+	free(n->kids);
+	free(n);
+}
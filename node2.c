@@ -0,0 +1,55 @@
+#include "shell.h"
+
+/**
+ * node_copy - deep copies a node, owning every word of the copy
+ * @n: the node
+ * Return: the copy, or NULL on failure
+ */
+node_t *node_copy(node_t *n)
+{
+	node_t *c = node_new(n->type, n->line), *kid;
+	char *w;
+	int i;
+
+	if (c == NULL)
+		return (NULL);
+	c->flags = n->flags & ~NF_BORROWED;
+	for (i = 0; i < n->nwords; i++)
+	{
+		w = strdup(n->words[i]);
+		if (w == NULL || node_add_word(c, w) != 0)
+		{
+			free(w);
+			node_free(c);
+			return (NULL);
+		}
+	}
+	for (i = 0; i < n->nkids; i++)
+	{
+		kid = node_copy(n->kids[i]);
+		if (kid == NULL || node_add_kid(c, kid) != 0)
+		{
+			node_free(kid);
+			node_free(c);
+			return (NULL);
+		}
+	}
+	return (c);
+}
+
+/**
+ * node_name - names a node, for traces
+ * @n: the node
+ * Return: its first word, or what kind of node it is when it has none;
+ * a list of one command is named after that command
+ */
+const char *node_name(node_t *n)
+{
+	while (n->type == N_LIST && n->nkids == 1)
+		n = n->kids[0];
+	if (n->type == N_SUBSHELL)
+		return ("( )");
+	if (n->type == N_LIST)
+		return ("{ }");
+	return (n->nwords > 0 ? n->words[0] : "command");
+}
@@ -0,0 +1,121 @@
+#include "shell.h"
+
+/**
+ * parse_peek - returns the lookahead token, reading it if needed
+ * @p: the parser
+ * Return: the lookahead token
+ *
+ * The bodies of the here-documents started on a line are read as soon as
+ * its newline has been.
+ */
+token_t *parse_peek(parser_t *p)
+{
+	if (!p->have)
+	{
+		lex_token(p->src, &p->tok);
+		p->have = 1;
+		if (p->nhere > 0 && (p->tok.type == T_NEWLINE ||
+			p->tok.type == T_EOF))
+			parse_heredocs(p);
+	}
+	return (&p->tok);
+}
+
+/**
+ * parse_drop - consumes the lookahead token, freeing its text
+ * @p: the parser
+ */
+void parse_drop(parser_t *p)
+{
+	if (p->have && (p->tok.type == T_WORD || p->tok.type == T_REDIR))
+		free(p->tok.word);
+	p->have = 0;
+}
+
+/**
+ * parse_fail - records a syntax error, keeping the first one
+ * @p: the parser
+ * @msg: the message
+ * Return: always NULL
+ */
+node_t *parse_fail(parser_t *p, const char *msg)
+{
+	if (p->err == NULL)
+		p->err = strdup(msg);
+	return (NULL);
+}
+
+/**
+ * parse_unexpected - records a syntax error on the lookahead token
+ * @p: the parser
+ * @expecting: what was expected instead, or NULL
+ * Return: always NULL
+ */
+node_t *parse_unexpected(parser_t *p, const char *expecting)
+{
+	token_t *t = parse_peek(p);
+	char msg[MAX_LENGTH], what[MAX_LENGTH / 2];
+
+	if (t->type == T_ERROR)
+		return (parse_fail(p, t->word));
+	if (t->type == T_WORD || t->type == T_REDIR)
+		snprintf(what, sizeof(what), "\"%s\"", t->word);
+	else if (t->type == T_EOF || t->type == T_NEWLINE)
+		snprintf(what, sizeof(what), "%s",
+			t->type == T_EOF ? "end of file" : "newline");
+	else
+		snprintf(what, sizeof(what), "\"%c\"", t->type == T_SEMI ? ';' :
+			t->type == T_LPAREN ? '(' : t->type == T_PIPE ? '|' :
+			')');
+	if (expecting != NULL)
+		snprintf(msg, sizeof(msg), "%s unexpected (expecting %s)",
+			what, expecting);
+	else
+		snprintf(msg, sizeof(msg), "%s unexpected", what);
+	return (parse_fail(p, msg));
+}
+
+/**
+ * parse_command - parses the next complete command of a source
+ * @s: the source
+ * Return: an N_LIST of the commands on the line, an N_SYNERR node on a
+ * syntax error, or NULL at end of input
+ *
+ * Parsing stops right after the terminating newline, so an interactive
+ * shell runs each line before reading the next one. Blank lines are
+ * skipped under the primary prompt.
+ */
+node_t *parse_command(source_t *s)
+{
+	parser_t p;
+	node_t *n;
+	int type, stage;
+	const char *ps = s->ps;
+
+	memset(&p, 0, sizeof(p));
+	p.src = s;
+	stage = REC_STAGE(REC_PARSE);
+	while (parse_peek(&p)->type == T_NEWLINE)
+	{
+		parse_drop(&p);
+		s->ps = ps;
+	}
+	if (p.tok.type == T_EOF)
+		return (REC_STAGE(stage), NULL);
+	n = parse_list(&p, NULL);
+	type = parse_peek(&p)->type;
+	if (n != NULL && type != T_NEWLINE && type != T_EOF)
+		parse_unexpected(&p, NULL);
+	if (p.err != NULL)
+	{
+		node_free(n);
+		n = node_new(N_SYNERR, p.tok.line);
+		if (n == NULL || node_add_word(n, p.err) != 0)
+			free(p.err);
+		if (type != T_NEWLINE)
+			src_skip_line(s);
+	}
+	parse_drop(&p);
+	REC_STAGE(stage);
+	return (n);
+}
@@ -0,0 +1,175 @@
+#include "shell.h"
+
+/**
+ * parse_brace - parses a { list } group, the "{" being the lookahead
+ * @p: the parser
+ * Return: the N_LIST inside the braces, or NULL on a syntax error
+ */
+static node_t *parse_brace(parser_t *p)
+{
+	node_t *body;
+	token_t *t;
+
+	parse_drop(p);
+	body = parse_list(p, "}");
+	if (body == NULL)
+		return (NULL);
+	t = parse_peek(p);
+	if (t->type != T_WORD || strcmp(t->word, "}") != 0 || body->nkids == 0)
+	{
+		node_free(body);
+		return (parse_unexpected(p, t->type == T_EOF ? "\"}\"" : NULL));
+	}
+	parse_drop(p);
+	return (body);
+}
+
+/**
+ * parse_func - parses the rest of a function definition
+ * @p: the parser, with "(" as the lookahead
+ * @n: command node holding the function name
+ * Return: @n turned into an N_FUNC node, or NULL on a syntax error
+ */
+static node_t *parse_func(parser_t *p, node_t *n)
+{
+	node_t *body = NULL;
+
+	parse_drop(p);
+	if (parse_peek(p)->type == T_RPAREN)
+	{
+		parse_drop(p);
+		while (parse_peek(p)->type == T_NEWLINE)
+			parse_drop(p);
+		if (p->tok.type == T_WORD && strcmp(p->tok.word, "{") == 0)
+			body = parse_brace(p);
+		else
+			parse_unexpected(p, "\"{\"");
+	}
+	else
+		parse_unexpected(p, "\")\"");
+	if (body != NULL && !is_name(n->words[0]))
+		parse_fail(p, "Bad function name");
+	if (body == NULL || p->err != NULL || node_add_kid(n, body) != 0)
+	{
+		node_free(body);
+		node_free(n);
+		return (NULL);
+	}
+	n->type = N_FUNC;
+	return (n);
+}
+
+/**
+ * parse_cmd - parses a simple command, a group, a subshell, a loop or a
+ * function
+ * @p: the parser
+ * Return: the node, or NULL on a syntax error
+ *
+ * The redirections of a simple command become its N_REDIR kids.
+ */
+node_t *parse_cmd(parser_t *p)
+{
+	token_t *t = parse_peek(p);
+	node_t *n;
+
+	if (t->type == T_LPAREN)
+		return (parse_subshell(p));
+	if (t->type != T_WORD && t->type != T_REDIR)
+		return (parse_unexpected(p, NULL));
+	if (t->type == T_WORD && strcmp(t->word, "{") == 0)
+		return (parse_brace(p));
+	if (t->type == T_WORD && (strcmp(t->word, "while") == 0 ||
+		strcmp(t->word, "until") == 0))
+		return (parse_while(p));
+	n = node_new(N_CMD, t->line);
+	if (n == NULL)
+		return (parse_fail(p, "out of memory"));
+	while ((t = parse_peek(p))->type == T_WORD || t->type == T_REDIR)
+	{
+		if (t->type == T_REDIR ? parse_redir(p, n) != 0 :
+			n->nwords >= MAX_LENGTH - 1 ||
+			node_add_word(n, t->word) != 0)
+		{
+			node_free(n);
+			return (parse_fail(p, "too many words"));
+		}
+		p->have = 0;
+	}
+	if (t->type == T_LPAREN && n->nwords == 1)
+		return (parse_func(p, n));
+	return (n);
+}
+
+/**
+ * parse_list - parses pipelines separated by ";" or newlines
+ * @p: the parser
+ * @close: the word that ends a nested list, such as "}" or "do", or ")"
+ * inside a subshell; newlines then separate commands. NULL at top level
+ * Return: an N_LIST node, or NULL on a syntax error
+ */
+node_t *parse_list(parser_t *p, const char *close)
+{
+	node_t *list = node_new(N_LIST, parse_peek(p)->line), *cmd;
+	token_t *t;
+	char want[8];
+
+	while (list != NULL)
+	{
+		t = parse_peek(p);
+		if (close && t->type == T_NEWLINE)
+		{
+			parse_drop(p);
+			continue;
+		}
+		if (parse_end(t, close))
+			return (list);
+		if (close && t->type == T_EOF)
+			break;
+		cmd = parse_pipe(p);
+		if (cmd == NULL || node_add_kid(list, cmd) != 0)
+		{
+			node_free(cmd);
+			break;
+		}
+		t = parse_peek(p);
+		if (t->type == T_SEMI)
+			parse_drop(p);
+		else if (t->type != T_NEWLINE && t->type != T_EOF &&
+			!parse_end(t, close))
+			break;
+	}
+	node_free(list);
+	if (p->err != NULL)
+		return (NULL);
+	if (close != NULL)
+		sprintf(want, "\"%.5s\"", close);
+	return (parse_unexpected(p, !close || parse_peek(p)->type != T_EOF ?
+		NULL : want));
+}
+
+/**
+ * parse_buffer - parses a whole script into a list of commands
+ * @buf: the script text
+ * @len: length of @buf
+ * Return: an N_LIST node holding one kid per complete command, ending with
+ * an N_SYNERR node if the script has a syntax error, or NULL on failure
+ */
+node_t *parse_buffer(const char *buf, size_t len)
+{
+	node_t *prog = node_new(N_LIST, 0), *cmd;
+	source_t src;
+
+	src_init(&src, buf, len, NULL);
+	while (prog != NULL && (cmd = parse_command(&src)) != NULL)
+	{
+		if (node_add_kid(prog, cmd) != 0)
+		{
+			node_free(cmd);
+			node_free(prog);
+			return (NULL);
+		}
+		if (cmd->type == N_SYNERR)
+			break;
+	}
+	return (prog);
+}
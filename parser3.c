@@ -0,0 +1,107 @@
+#include "shell.h"
+
+/**
+ * parse_redir - parses a redirection into an N_REDIR kid of a command
+ * @p: the parser, with the operator as the lookahead
+ * @n: the command
+ * Return: 0 on success, -1 on a syntax error
+ *
+ * The kid's words are the operator and its operand. A here-document's
+ * operand is its delimiter, quotes removed, until parse_heredocs replaces
+ * it with the body.
+ */
+int parse_redir(parser_t *p, node_t *n)
+{
+	char *op = p->tok.word, *o = op + (*op >= '0' && *op <= '9'), *w;
+	int here = strcmp(o, "<<") == 0 || strcmp(o, "<<-") == 0;
+	node_t *r = node_new(N_REDIR, p->tok.line);
+
+	p->have = 0;
+	if (r == NULL || node_add_word(r, op) != 0)
+		free(op);
+	if (r == NULL || r->nwords == 0 || node_add_kid(n, r) != 0)
+	{
+		node_free(r);
+		parse_fail(p, "out of memory");
+		return (-1);
+	}
+	if (parse_peek(p)->type != T_WORD)
+	{
+		parse_unexpected(p, NULL);
+		return (-1);
+	}
+	w = p->tok.word;
+	p->have = 0;
+	if (here)
+	{
+		r->flags |= strpbrk(w, "'\"\\") != NULL ? NF_LITERAL : 0;
+		o = w;
+		w = p->nhere < HERE_MAX ? unquote(o) : NULL;
+		free(o);
+	}
+	if (w == NULL || node_add_word(r, w) != 0)
+	{
+		free(w);
+		parse_fail(p, here && p->nhere == HERE_MAX ?
+			"too many here-documents" : "out of memory");
+		return (-1);
+	}
+	if (here)
+		p->here[p->nhere++] = r;
+	return (0);
+}
+
+/**
+ * here_line - reads one line of a here-document
+ * @s: the source
+ * @b: receives the line, newline included
+ * Return: 0 on success, -1 at end of input
+ */
+static int here_line(source_t *s, wbuf_t *b)
+{
+	int c;
+
+	b->len = 0;
+	while ((c = src_next(s)) != EOF)
+		if (wbuf_putc(b, c) != 0 || c == '\n')
+			break;
+	return (c == EOF && b->len == 0 ? -1 : 0);
+}
+
+/**
+ * parse_heredocs - reads the bodies of the pending here-documents
+ * @p: the parser, whose source is at the start of the line after them
+ *
+ * Each body runs up to a line holding only its delimiter, or to the end
+ * of input. With <<- leading tabs are stripped from every line first.
+ * After a syntax error the nodes may be gone, and nothing is read.
+ */
+void parse_heredocs(parser_t *p)
+{
+	wbuf_t line = {NULL, 0, 0}, body;
+	node_t *r;
+	const char *l;
+	size_t dlen;
+	int i, strip;
+
+	for (i = 0; i < p->nhere && p->err == NULL; i++)
+	{
+		r = p->here[i];
+		strip = r->words[0][strlen(r->words[0]) - 1] == '-';
+		dlen = strlen(r->words[1]);
+		memset(&body, 0, sizeof(body));
+		while (here_line(p->src, &line) == 0)
+		{
+			for (l = line.s; strip && *l == '\t'; l++)
+				;
+			if (strncmp(l, r->words[1], dlen) == 0 &&
+				(l[dlen] == '\n' || l[dlen] == '\0'))
+				break;
+			wbuf_put(&body, l, line.len - (l - line.s));
+		}
+		free(r->words[1]);
+		r->words[1] = body.s != NULL ? body.s : strdup("");
+	}
+	p->nhere = 0;
+	free(line.s);
+}
@@ -0,0 +1,134 @@
+#include "shell.h"
+
+/**
+ * parse_end - tells whether a token ends a list
+ * @t: the token
+ * @close: as for parse_list
+ * Return: 1 if it does, 0 otherwise
+ */
+int parse_end(token_t *t, const char *close)
+{
+	if (close == NULL)
+		return (t->type == T_NEWLINE || t->type == T_EOF);
+	if (strcmp(close, ")") == 0)
+		return (t->type == T_RPAREN);
+	return (t->type == T_WORD && strcmp(t->word, close) == 0);
+}
+
+/**
+ * parse_pipe - parses commands joined by "|"
+ * @p: the parser
+ * Return: the command when there is only one, otherwise an N_PIPE node
+ * with one kid per stage; NULL on a syntax error
+ *
+ * A pipeline may continue on the line after a "|".
+ */
+node_t *parse_pipe(parser_t *p)
+{
+	node_t *n = parse_cmd(p), *pipe, *cmd;
+
+	if (n == NULL || parse_peek(p)->type != T_PIPE)
+		return (n);
+	pipe = node_new(N_PIPE, n->line);
+	if (pipe == NULL || node_add_kid(pipe, n) != 0)
+	{
+		node_free(n);
+		node_free(pipe);
+		return (parse_fail(p, "out of memory"));
+	}
+	while (parse_peek(p)->type == T_PIPE)
+	{
+		parse_drop(p);
+		while (parse_peek(p)->type == T_NEWLINE)
+			parse_drop(p);
+		cmd = parse_cmd(p);
+		if (cmd == NULL || node_add_kid(pipe, cmd) != 0)
+		{
+			node_free(pipe);
+			if (cmd == NULL)
+				return (NULL);
+			node_free(cmd);
+			return (parse_fail(p, "out of memory"));
+		}
+	}
+	return (pipe);
+}
+
+/**
+ * parse_subshell - parses a ( list ) subshell, the "(" being the lookahead
+ * @p: the parser
+ * Return: an N_SUBSHELL node whose kids are the list and the N_REDIR
+ * kids of the redirections after ")", or NULL on a syntax error
+ */
+node_t *parse_subshell(parser_t *p)
+{
+	node_t *n = node_new(N_SUBSHELL, parse_peek(p)->line), *body;
+
+	parse_drop(p);
+	body = n != NULL ? parse_list(p, ")") : NULL;
+	if (body != NULL && body->nkids == 0)
+	{
+		node_free(body);
+		body = parse_unexpected(p, NULL);
+	}
+	if (body == NULL || node_add_kid(n, body) != 0)
+	{
+		node_free(body);
+		node_free(n);
+		return (n == NULL ? parse_fail(p, "out of memory") : NULL);
+	}
+	parse_drop(p);
+	while (parse_peek(p)->type == T_REDIR)
+		if (parse_redir(p, n) != 0)
+		{
+			node_free(n);
+			return (NULL);
+		}
+	return (n);
+}
+
+/**
+ * parse_while - parses a while or until loop, the keyword being the
+ * lookahead
+ * @p: the parser
+ * Return: an N_WHILE node whose word is the keyword and whose kids are the
+ * condition, the body and the N_REDIR kids of the redirections after
+ * "done"; NULL on a syntax error
+ */
+node_t *parse_while(parser_t *p)
+{
+	node_t *n = node_new(N_WHILE, parse_peek(p)->line), *list;
+	int i;
+
+	if (n == NULL || node_add_word(n, p->tok.word) != 0)
+	{
+		node_free(n);
+		return (parse_fail(p, "out of memory"));
+	}
+	p->have = 0;
+	for (i = 0; i < 2; i++)
+	{
+		list = parse_list(p, i == 0 ? "do" : "done");
+		if (list != NULL && list->nkids == 0)
+		{
+			node_free(list);
+			list = parse_unexpected(p, NULL);
+		}
+		if (list == NULL || node_add_kid(n, list) != 0)
+		{
+			node_free(n);
+			if (list == NULL)
+				return (NULL);
+			node_free(list);
+			return (parse_fail(p, "out of memory"));
+		}
+		parse_drop(p);
+	}
+	while (parse_peek(p)->type == T_REDIR)
+		if (parse_redir(p, n) != 0)
+		{
+			node_free(n);
+			return (NULL);
+		}
+	return (n);
+}
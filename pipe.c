@@ -0,0 +1,180 @@
+#include "shell.h"
+
+/**
+ * pipe_pick - chooses the stage of a pipeline the shell runs itself
+ * @n: the N_PIPE node
+ * Return: index of the first stage that cannot change the shell and needs
+ * no process of its own, -1 if there is none
+ *
+ * Only one stage can run in the shell, as every stage has to run at the
+ * same time as the others; the rest get children.
+ */
+static int pipe_pick(node_t *n)
+{
+	int i;
+
+	for (i = 0; i < n->nkids; i++)
+		if (node_pure(n->kids[i], 0, 0))
+			return (i);
+	return (-1);
+}
+
+/**
+ * pipe_fork - starts a stage of a pipeline in a child
+ * @stage: the stage
+ * @fd: the stage's input and output, -1 for the shell's own, then the
+ * descriptors the child must not keep open
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * Return: the child, -1 on failure
+ */
+static pid_t pipe_fork(node_t *stage, int fd[5], const char *shell_name,
+int status)
+{
+	pid_t pid = shell_fork();
+	int i;
+
+	if (pid != 0)
+		return (pid);
+	for (i = 2; i < 5; i++)
+		if (fd[i] >= 0)
+			close(fd[i]);
+	if ((fd[0] >= 0 && dup2(fd[0], 0) < 0) ||
+		(fd[1] >= 0 && dup2(fd[1], 1) < 0))
+		_exit(1);
+	if (fd[0] >= 0)
+		read_own(0);
+	g_sh.tail = 1;
+	status = exec_node(stage, shell_name, status, NULL);
+	shell_exit(status);
+}
+
+/**
+ * pipe_self - runs a stage of a pipeline in the shell
+ * @stage: the stage
+ * @fd: its input and output, -1 for the shell's own
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the stage
+ *
+ * The stage writes straight into the pipe. SIGPIPE is ignored meanwhile,
+ * so a reader that leaves early only fails its writes.
+ */
+static int pipe_self(node_t *stage, int fd[2], const char *shell_name,
+int status, char *input)
+{
+	redir_t r, *outer = g_sh.redir;
+	struct sigaction ign, old;
+	int tail = g_sh.tail;
+
+	r.n = 0, r.own = 0;
+	if (fd[0] >= 0)
+		r.fd[r.n] = 0, r.src[r.n++] = fd[0];
+	if (fd[1] >= 0)
+		r.fd[r.n] = 1, r.src[r.n++] = fd[1];
+	memset(&ign, 0, sizeof(ign));
+	ign.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &ign, &old);
+	if (redir_apply(&r) != 0)
+		status = 1;
+	else
+	{
+		g_sh.redir = NULL;
+		g_sh.tail = 0;
+		plan_elided();
+		status = exec_node(stage, shell_name, status, input);
+		g_sh.tail = tail;
+		g_sh.redir = outer;
+		redir_restore(&r);
+		clearerr(stdout);
+	}
+	sigaction(SIGPIPE, &old, NULL);
+	return (status);
+}
+
+/**
+ * pipe_start - creates the pipes of a pipeline and its children
+ * @n: the N_PIPE node
+ * @pids: receives the child of each stage, 0 for the one the shell runs
+ * @pick: the stage the shell runs, -1 for none
+ * @fd: receives the input and output of that stage at 3 and 4
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * Return: 0 on success, -1 when a pipe could not be made
+ */
+static int pipe_start(node_t *n, pid_t *pids, int pick, int fd[5],
+const char *shell_name, int status)
+{
+	int p[2], i;
+
+	for (i = 0; i < n->nkids; i++)
+	{
+		p[0] = p[1] = -1;
+		if (i + 1 < n->nkids && pipe2(p, O_CLOEXEC) != 0)
+			break;
+		fd[1] = p[1], fd[2] = p[0];
+		if (i == pick)
+			fd[3] = fd[0], fd[4] = fd[1];
+		else
+		{
+			pids[i] = pipe_fork(n->kids[i], fd, shell_name, status);
+			if (pids[i] > 0)
+				trace_stage("stage", node_name(n->kids[i]),
+					pids[i], fd[0], fd[1], -1);
+			if (fd[0] >= 0)
+				close(fd[0]);
+			if (fd[1] >= 0)
+				close(fd[1]);
+		}
+		fd[0] = p[0];
+	}
+	if (fd[0] >= 0)
+		close(fd[0]);
+	return (i == n->nkids ? 0 : -1);
+}
+
+/**
+ * exec_pipe - runs a pipeline
+ * @n: the N_PIPE node
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the last stage
+ *
+ * Every stage but the one pipe_pick chooses gets a child, which replaces
+ * itself with the stage's command when that is an external one. The
+ * chosen stage then runs in the shell, once the others are going. Each
+ * stage is a "stage" event of --trace-events, on the track of its child.
+ */
+int exec_pipe(node_t *n, const char *shell_name, int status, char *input)
+{
+	pid_t *pids = calloc(n->nkids, sizeof(*pids));
+	int pick = pipe_pick(n), fd[5] = {-1, -1, -1, -1, -1}, i, st, ok;
+
+	ok = pids != NULL &&
+		pipe_start(n, pids, pick, fd, shell_name, status) == 0;
+	if (!ok)
+		fprintf(stderr, "%s: %d: cannot run pipeline: %s\n",
+			shell_name, n->line, strerror(errno));
+	if (ok && pick >= 0)
+	{
+		trace_stage("stage", node_name(n->kids[pick]), g_sh.pid, fd[3],
+			fd[4], -1);
+		status = pipe_self(n->kids[pick], fd + 3, shell_name, status,
+			input);
+		trace_end("stage", node_name(n->kids[pick]), g_sh.pid, status);
+	}
+	for (i = 3; i < 5; i++)
+		if (fd[i] >= 0)
+			close(fd[i]);
+	for (i = 0; pids != NULL && i < n->nkids; i++)
+		if (pids[i] > 0)
+		{
+			st = wait_status(pids[i]);
+			trace_end("stage", node_name(n->kids[i]), pids[i], st);
+			status = i + 1 == n->nkids ? st : status;
+		}
+	free(pids);
+	return (ok ? status : 1);
+}
@@ -0,0 +1,165 @@
+#include "shell.h"
+
+/**
+ * place_name - looks a name up in a colon separated list
+ * @s: the name, possibly followed by ":" and more
+ * @list: the names
+ * Return: index of the name in @list, -1 if it is not there
+ */
+static int place_name(const char *s, const char *list)
+{
+	size_t n = strcspn(s, ":");
+	int i;
+
+	for (i = 0; *list != '\0'; i++)
+	{
+		if (n > 0 && strncmp(list, s, n) == 0 &&
+			(list[n] == ':' || list[n] == '\0'))
+			return (i);
+		list += strcspn(list, ":");
+		list += *list == ':';
+	}
+	return (-1);
+}
+
+/**
+ * place_io - parses an I/O priority such as "be:4" or "idle"
+ * @sp: the settings
+ * @arg: the priority, a class and an optional level from 0 to 7
+ * Return: 0 on success, -1 on failure
+ */
+static int place_io(spawn_t *sp, const char *arg)
+{
+	int class = place_name(arg, "rt:be:idle") + 1;
+	const char *lv = strchr(arg, ':');
+	int level = lv != NULL ? lv[1] - '0' : 4;
+
+	if (class == 0 || level < 0 || level > 7 ||
+		(lv != NULL && lv[2] != '\0'))
+		return (-1);
+	sp->ioprio = (class << 13) | (class == 3 ? 0 : level);
+	sp->place |= PL_IO;
+	return (0);
+}
+
+/**
+ * place_opt - applies one option of the place builtin
+ * @sp: the settings
+ * @opt: the option letter
+ * @arg: its value
+ * @rr: set to 1 or 2 by -r cpu or -r node
+ * Return: 0 on success, -1 for a bad option or value
+ */
+static int place_opt(spawn_t *sp, int opt, const char *arg, int *rr)
+{
+	char *end;
+	long v;
+	int i = arg != NULL ? 0 : -1;
+
+	if (i == 0 && (opt == 'c' || opt == 'n'))
+		i = place_list(arg, opt == 'c' ? &sp->cpus : &sp->nodes);
+	if (i == 0 && (opt == 'c' || opt == 'n'))
+		sp->place |= opt == 'c' ? PL_CPUS : PL_MEM;
+	else if (i == 0 && opt == 'm' &&
+		(i = place_name(arg, "preferred:bind:interleave")) >= 0)
+		sp->mpol = MPOL_PREFERRED + i;
+	else if (i == 0 && opt == 's' &&
+		(i = place_name(arg, "other:batch:idle")) >= 0)
+	{
+		sp->policy = i == 0 ? SCHED_OTHER : i == 1 ? SCHED_BATCH :
+			SCHED_IDLE;
+		sp->place |= PL_SCHED;
+	}
+	else if (i == 0 && opt == 'i')
+		i = place_io(sp, arg);
+	else if (i == 0 && opt == 'r')
+		i = (*rr = place_name(arg, "cpu:node") + 1) > 0 ? 0 : -1;
+	else if (i == 0 && opt == 'N')
+	{
+		v = strtol(arg, &end, 10);
+		i = end == arg || *end != '\0' || v < -20 || v > 19 ? -1 : 0;
+		sp->nice = v;
+		sp->place |= i == 0 ? PL_NICE : 0;
+	}
+	else if (i == 0)
+		i = -1;
+	return (i < 0 ? -1 : 0);
+}
+
+/**
+ * place_opts - parses the options of the place builtin
+ * @args: the arguments, args[0] being "place"
+ * @sp: the settings
+ * @rr: set to 1 or 2 by -r cpu or -r node
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: index of the command, -1 on a usage error
+ */
+static int place_opts(char **args, spawn_t *sp, int *rr,
+const char *shell_name, int line)
+{
+	const char *arg;
+	int i;
+
+	for (i = 1; args[i] != NULL && args[i][0] == '-'; i++)
+	{
+		if (strcmp(args[i], "--") == 0)
+			return (args[i + 1] != NULL ? i + 1 : -1);
+		arg = args[i][1] != '\0' && args[i][2] != '\0' ? args[i] + 2 :
+			args[i + 1];
+		if (place_opt(sp, args[i][1], arg, rr) != 0)
+		{
+			fprintf(stderr, "%s: %d: place: bad option: %s\n",
+				shell_name, line, args[i]);
+			return (-1);
+		}
+		i += arg == args[i + 1];
+	}
+	return (args[i] != NULL ? i : -1);
+}
+
+/**
+ * handle_place - runs a command with a CPU, memory and scheduling placement
+ * @args: "place", the options and the command
+ * @shell_name: name of the shell
+ * @command_count: line number, for messages
+ * @status: exit status of the last command
+ * @input: the input line, for exit
+ * Return: exit status of the command, 2 on a usage error
+ *
+ * Usage: place [-c CPUS] [-n NODES] [-m bind|preferred|interleave]
+ * [-N NICE] [-i CLASS[:LEVEL]] [-s other|batch|idle] [-r cpu|node] [--]
+ * command
+ * The placement is applied by the child itself just before exec, so no
+ * helper process is started. With -r each place picks the next CPU or
+ * node in turn, and so does each process a builtin such as batch starts.
+ */
+int handle_place(char *args[], const char *shell_name, int command_count,
+int status, char *input)
+{
+	spawn_t saved = g_sh.spawn, base, *sp = &g_sh.spawn;
+	int rr = 0, i = place_opts(args, sp, &rr, shell_name, command_count);
+
+	if (i < 0)
+	{
+		fprintf(stderr, "%s: %d: place: usage: place [-c CPUS] "
+			"[-n NODES] [-m MODE] [-N NICE] [-i CLASS[:LEVEL]] "
+			"[-s POLICY] [-r cpu|node] [--] command\n",
+			shell_name, command_count);
+		g_sh.spawn = saved;
+		return (2);
+	}
+	if ((sp->place & PL_MEM) && sp->mpol == 0)
+		sp->mpol = MPOL_BIND;
+	base = *sp;
+	sp->rr = rr;
+	sp->rrbase = &base;
+	if (rr != 0 && place_rr(sp, rr == 2) != 0)
+		fprintf(stderr, "%s: %d: place: nothing to rotate over\n",
+			shell_name, command_count);
+	status = chK(args + i, shell_name, command_count, status, input);
+	saved.maxrss = sp->maxrss;
+	saved.cpu_us = sp->cpu_us;
+	g_sh.spawn = saved;
+	return (status);
+}
@@ -0,0 +1,157 @@
+#include "shell.h"
+
+/**
+ * place_list - parses a list of CPUs or nodes such as "0-3,8,10-11"
+ * @s: the list, optionally ending in a newline as in sysfs
+ * @set: the set to fill
+ * Return: 0 on success, -1 if @s is malformed or names nothing
+ */
+int place_list(const char *s, cpu_set_t *set)
+{
+	char *end;
+	long lo, hi;
+
+	CPU_ZERO(set);
+	while (*s != '\0' && *s != '\n')
+	{
+		lo = strtol(s, &end, 10);
+		hi = lo;
+		if (end != s && *end == '-')
+		{
+			s = end + 1;
+			hi = strtol(s, &end, 10);
+		}
+		if (end == s || lo < 0 || hi < lo || hi >= CPU_SETSIZE ||
+			(*end != ',' && *end != '\0' && *end != '\n'))
+			return (-1);
+		for (; lo <= hi; lo++)
+			CPU_SET(lo, set);
+		s = end + (*end == ',');
+	}
+	return (CPU_COUNT(set) > 0 ? 0 : -1);
+}
+
+/**
+ * place_file - reads a list of CPUs or nodes from a sysfs file
+ * @path: the file
+ * @set: the set to fill
+ * Return: 0 on success, -1 on failure
+ */
+static int place_file(const char *path, cpu_set_t *set)
+{
+	char buf[4096];
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	ssize_t n = fd >= 0 ? read(fd, buf, sizeof(buf) - 1) : -1;
+
+	if (fd >= 0)
+		close(fd);
+	if (n <= 0)
+		return (-1);
+	buf[n] = '\0';
+	return (place_list(buf, set));
+}
+
+/**
+ * place_rr - narrows the placement to the next CPU or node in turn
+ * @sp: the settings
+ * @nodes: nonzero to rotate over NUMA nodes, zero over CPUs
+ * Return: 0 on success, -1 if there is nothing to rotate over
+ *
+ * CPUs rotate over -c, or the CPUs the shell may use; nodes over -n, or
+ * the online nodes, and bring their CPUs and a memory policy with them.
+ */
+int place_rr(spawn_t *sp, int nodes)
+{
+	static unsigned int next;
+	cpu_set_t pool, one;
+	char path[64];
+	int i, k;
+
+	if (nodes && (sp->place & PL_MEM))
+		pool = sp->nodes;
+	else if (nodes && place_file("/sys/devices/system/node/online",
+		&pool) != 0)
+		place_list("0", &pool);
+	else if (!nodes && (sp->place & PL_CPUS))
+		pool = sp->cpus;
+	else if (!nodes && sched_getaffinity(0, sizeof(pool), &pool) != 0)
+		return (-1);
+	if (CPU_COUNT(&pool) == 0)
+		return (-1);
+	k = next++ % CPU_COUNT(&pool);
+	for (i = 0; !CPU_ISSET(i, &pool) || k-- > 0; i++)
+		;
+	CPU_ZERO(&one);
+	CPU_SET(i, &one);
+	if (nodes)
+	{
+		sp->nodes = one;
+		sp->mpol = (sp->place & PL_MEM) ? sp->mpol : MPOL_BIND;
+		sp->place |= PL_MEM;
+		sprintf(path, "/sys/devices/system/node/node%d/cpulist", i);
+		if (place_file(path, &one) != 0)
+			return (0);
+	}
+	if (sp->place & PL_CPUS)
+		CPU_AND(&sp->cpus, &sp->cpus, &one);
+	else
+		sp->cpus = one;
+	sp->place |= PL_CPUS;
+	return (0);
+}
+
+/**
+ * place_child - applies the placement in a child before it execs
+ * @sp: the settings
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: 0 on success, -1 after reporting a failure
+ */
+int place_child(spawn_t *sp, const char *shell_name, int line)
+{
+	struct sched_param sch;
+	const char *what = NULL;
+
+	memset(&sch, 0, sizeof(sch));
+	if ((sp->place & PL_CPUS) &&
+		sched_setaffinity(0, sizeof(sp->cpus), &sp->cpus) != 0)
+		what = "sched_setaffinity";
+	else if ((sp->place & PL_MEM) && syscall(SYS_set_mempolicy,
+		sp->mpol, &sp->nodes, (unsigned long)CPU_SETSIZE) != 0)
+		what = "set_mempolicy";
+	else if ((sp->place & PL_SCHED) &&
+		sched_setscheduler(0, sp->policy, &sch) != 0)
+		what = "sched_setscheduler";
+	else if ((sp->place & PL_NICE) &&
+		setpriority(PRIO_PROCESS, 0, sp->nice) != 0)
+		what = "setpriority";
+	else if ((sp->place & PL_IO) &&
+		syscall(SYS_ioprio_set, 1, 0, sp->ioprio) != 0)
+		what = "ioprio_set";
+	if (what == NULL)
+		return (0);
+	fprintf(stderr, "%s: %d: place: %s: %s\n", shell_name, line, what,
+		strerror(errno));
+	return (-1);
+}
+
+/**
+ * place_next - moves a placement made with place -r to the next CPU or
+ * node in turn
+ * @sp: the settings
+ *
+ * For builtins that start several processes under one place, such as
+ * batch. Settings made under place, such as a timeout, are kept.
+ */
+void place_next(spawn_t *sp)
+{
+	const spawn_t *b = sp->rrbase;
+
+	if (sp->rr == 0 || b == NULL)
+		return;
+	sp->place = b->place;
+	sp->cpus = b->cpus;
+	sp->nodes = b->nodes;
+	sp->mpol = b->mpol;
+	place_rr(sp, sp->rr == 2);
+}
@@ -0,0 +1,169 @@
+#include "shell.h"
+
+/**
+ * plan_word - tells whether a word can be expanded without side effects
+ * @w: the word
+ * Return: 1 if so, 0 when it might assign with ${name=word}
+ */
+static int plan_word(const char *w)
+{
+	return (strstr(w, "${") == NULL || strchr(w, '=') == NULL);
+}
+
+/**
+ * node_pure - tells whether commands can run without changing the shell
+ * @n: the commands, or a part of them
+ * @ext: nonzero when external commands qualify; they get children of
+ * their own anyway
+ * @depth: depth of function calls followed so far
+ * Return: 1 if so, 0 when they need a child of their own
+ *
+ * Builtins that only write output, such as printf or pwd, qualify, and so
+ * do functions whose commands all qualify in turn, externals included.
+ * Pipelines and subshells always do, as they never change the shell.
+ */
+int node_pure(node_t *n, int ext, int depth)
+{
+	shfunc_t *f;
+	const char *w;
+	int i;
+
+	for (i = 0; n->type == N_LIST && i < n->nkids; i++)
+		if (!node_pure(n->kids[i], ext, depth))
+			return (0);
+	for (i = 1; n->type == N_SUBSHELL && i < n->nkids; i++)
+		if (!plan_word(n->kids[i]->words[1]))
+			return (0);
+	if (n->type == N_LIST || n->type == N_PIPE || n->type == N_SUBSHELL)
+		return (n->nkids > 0);
+	if (n->type != N_CMD || n->nwords == 0 || depth > 8)
+		return (0);
+	for (i = 0; i < n->nwords; i++)
+		if (!plan_word(n->words[i]))
+			return (0);
+	for (i = 0; i < n->nkids; i++)
+		if (!plan_word(n->kids[i]->words[1]))
+			return (0);
+	w = n->words[0];
+	if (assign_len(w) > 0 || strpbrk(w, "$`'\"\\*?[~") != NULL ||
+		alias_lookup(w) != NULL)
+		return (0);
+	f = func_find(w);
+	if (f != NULL)
+		return (node_pure(f->body, 1, depth + 1));
+	if (strcmp(w, "printf") == 0 || strcmp(w, "pwd") == 0 ||
+		strcmp(w, "env") == 0)
+		return (1);
+	if (depth > 0 && strcmp(w, "return") == 0)
+		return (1);
+	return (ext && !cmd_inproc(w));
+}
+
+/**
+ * plan_light - tells whether a subshell can run on a snapshot of the shell
+ * @n: the body, or a part of it
+ * @names: receives the assignment words of the body
+ * @count: number of @names so far
+ * @cd: set when the body changes directory
+ * Return: 1 when every command is pure, a cd or only assignments, so that
+ * saving the directory and the variables assigned is enough; 0 otherwise
+ */
+static int plan_light(node_t *n, char **names, int *count, int *cd)
+{
+	int i;
+
+	for (i = 0; n->type == N_LIST && i < n->nkids; i++)
+		if (!plan_light(n->kids[i], names, count, cd))
+			return (0);
+	if (n->type == N_LIST || node_pure(n, 1, 0))
+		return (1);
+	if (n->type != N_CMD || n->nkids > 0)
+		return (0);
+	for (i = 0; i < n->nwords; i++)
+		if (!plan_word(n->words[i]))
+			return (0);
+	if (strcmp(n->words[0], "cd") == 0 && alias_lookup("cd") == NULL &&
+		func_find("cd") == NULL)
+		return (*cd = 1);
+	for (i = 0; i < n->nwords; i++)
+		if (assign_len(n->words[i]) == 0 || *count == SUB_VARS)
+			return (0);
+		else
+			names[(*count)++] = n->words[i];
+	return (1);
+}
+
+/**
+ * plan_run - runs the list of a ( list ) subshell
+ * @n: the N_SUBSHELL node
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the list
+ *
+ * A list that cannot change the shell runs in it as it is; one that only
+ * changes directory or assigns variables runs in it too, with those put
+ * back afterwards. Anything else gets a child.
+ */
+static int plan_run(node_t *n, const char *shell_name, int status,
+char *input)
+{
+	char *names[SUB_VARS];
+	var_t save[SUB_VARS];
+	int count = 0, cd = 0, dir = -1, i, light;
+	pid_t pid;
+
+	light = plan_light(n->kids[0], names, &count, &cd);
+	if (light && cd)
+	{
+		dir = open(".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+		light = dir >= 0;
+	}
+	if (light)
+	{
+		plan_elided();
+		for (i = 0; i < count; i++)
+			var_save(names[i], &save[i]);
+		status = exec_node(n->kids[0], shell_name, status, input);
+		assign_restore(names, save, count);
+		if (dir >= 0 && fchdir(dir) == 0 && g_sh.audit.on)
+			audit_cwd();
+		if (dir >= 0)
+			close(dir);
+		return (status);
+	}
+	pid = shell_fork();
+	if (pid == 0)
+	{
+		g_sh.tail = 1;
+		status = exec_node(n->kids[0], shell_name, status, NULL);
+		shell_exit(status);
+	}
+	return (pid < 0 ? 1 : wait_status(pid));
+}
+
+/**
+ * exec_subshell - runs a ( list ) subshell
+ * @n: the N_SUBSHELL node
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the node was read from
+ * Return: exit status of the list, 1 when its redirections failed
+ *
+ * Redirections after ")" apply to the whole list, wherever it runs.
+ */
+int exec_subshell(node_t *n, const char *shell_name, int status,
+char *input)
+{
+	int own = 0;
+	redir_t r;
+
+	r.n = 0;
+	if (n->nkids > 1)
+		own = redir_kids(n, 1, &r, shell_name, status);
+	if (own < 0)
+		return (1);
+	status = plan_run(n, shell_name, status, input);
+	redir_done(&r, 0);
+	return (status);
+}
@@ -0,0 +1,183 @@
+#include "shell.h"
+
+/**
+ * pf_escape - appends the byte a backslash escape stands for
+ * @p: the byte after the backslash
+ * @b: the output
+ * @bconv: nonzero inside a %b argument, where octal escapes start with a
+ * 0 and \c ends the output
+ * Return: the position after the escape, NULL at a \c
+ */
+static const char *pf_escape(const char *p, wbuf_t *b, int bconv)
+{
+	static const char from[] = "\\abfnrtv\"", to[] = "\\\a\b\f\n\r\t\v\"";
+	const char *e = *p != '\0' ? strchr(from, *p) : NULL;
+	int c = 0, n = 0, zero = bconv && *p == '0';
+
+	if (bconv && *p == 'c')
+		return (NULL);
+	if (e != NULL)
+	{
+		wbuf_putc(b, to[e - from]);
+		return (p + 1);
+	}
+	p += zero;
+	while (n < 3 && p[n] >= '0' && p[n] <= '7')
+		c = c * 8 + p[n++] - '0';
+	if (n == 0 && !zero)
+	{
+		wbuf_putc(b, '\\');
+		return (p);
+	}
+	wbuf_putc(b, c);
+	return (p + n);
+}
+
+/**
+ * pf_num - converts the argument of a numeric conversion
+ * @s: the argument; a leading quote gives the value of the next byte
+ * @bad: set to @s when it is not a number
+ * Return: the value
+ */
+static long pf_num(const char *s, const char **bad)
+{
+	char *end;
+	long v;
+
+	if (*s == '\'' || *s == '"')
+		return ((unsigned char)s[1]);
+	if (*s == '\0')
+		return (0);
+	errno = 0;
+	v = strtol(s, &end, 0);
+	if ((end == s || *end != '\0' || errno != 0) && *bad == NULL)
+		*bad = s;
+	return (v);
+}
+
+/**
+ * pf_conv - appends one converted argument
+ * @b: the output
+ * @spec: the conversion, from the "%" to the conversion character
+ * @len: length of @spec
+ * @arg: the argument, "" when they ran out
+ * @bad: set to the first argument that is not a number
+ * Return: 1 when a %b argument ended the output with \c, 0 otherwise
+ */
+static int pf_conv(wbuf_t *b, const char *spec, size_t len, const char *arg,
+const char **bad)
+{
+	char fmt[40];
+	int c = spec[len - 1], stop = 0;
+	wbuf_t t = {NULL, 0, 0};
+	const char *p;
+
+	if (len + 2 > sizeof(fmt))
+	{
+		wbuf_put(b, spec, len);
+		return (0);
+	}
+	memcpy(fmt, spec, len - 1);
+	fmt[len - 1] = 'l', fmt[len] = c, fmt[len + 1] = '\0';
+	if (c == 'd' || c == 'i')
+		wbuf_printf(b, fmt, pf_num(arg, bad));
+	else if (c != 'c' && c != 's' && c != 'b')
+		wbuf_printf(b, fmt, (unsigned long)pf_num(arg, bad));
+	fmt[len - 1] = c == 'c' ? 'c' : 's', fmt[len] = '\0';
+	if (c == 'c' && *arg != '\0')
+		wbuf_printf(b, fmt, *arg);
+	else if (c == 's')
+		wbuf_printf(b, fmt, arg);
+	if (c != 'b')
+		return (0);
+	for (p = arg; *p != '\0' && !stop; )
+		if (*p != '\\')
+			wbuf_putc(&t, *p++);
+		else if ((p = pf_escape(p + 1, &t, 1)) == NULL)
+			stop = 1;
+	wbuf_printf(b, fmt, t.s != NULL ? t.s : "");
+	free(t.s);
+	return (stop);
+}
+
+/**
+ * pf_format - appends the output of one pass over the format
+ * @b: the output
+ * @f: the format
+ * @args: the arguments left
+ * @bad: set to the first argument that is not a number
+ * Return: number of arguments used, -1 when \c ended the output
+ */
+static int pf_format(wbuf_t *b, const char *f, char **args, const char **bad)
+{
+	size_t len;
+	int used = 0;
+
+	while (*f != '\0')
+		if (*f == '\\')
+			f = pf_escape(f + 1, b, 0);
+		else if (*f != '%' || f[1] == '%')
+		{
+			wbuf_putc(b, *f);
+			f += 1 + (*f == '%');
+		}
+		else
+		{
+			len = 1 + strspn(f + 1, "-+ #0");
+			len += strspn(f + len, "0123456789");
+			if (f[len] == '.')
+				len += 1 + strspn(f + len + 1, "0123456789");
+			if (f[len] == '\0' || !strchr("diouxXcsb", f[len]))
+			{
+				wbuf_put(b, f, len);
+				f += len;
+				continue;
+			}
+			if (pf_conv(b, f, len + 1, args[used] != NULL ?
+				args[used] : "", bad))
+				return (-1);
+			used += args[used] != NULL;
+			f += len + 1;
+		}
+	return (used);
+}
+
+/**
+ * handle_printf - handles the built-in "printf" command
+ * @args: "printf", the format and its arguments
+ * @shell_name: the name of the shell
+ * @command_count: line number, for messages
+ * Return: 0 on success, 1 when an argument was not a number, 2 on a usage
+ * error
+ *
+ * Supports the escapes and the d, i, o, u, x, X, c, s and b conversions
+ * of POSIX printf with flags, width and precision; the format is reused
+ * until every argument is used.
+ */
+int handle_printf(char *args[], const char *shell_name, int command_count)
+{
+	wbuf_t b = {NULL, 0, 0};
+	const char *bad = NULL, *fmt;
+	int used = 0, n;
+
+	args += args[1] != NULL && strcmp(args[1], "--") == 0;
+	if (args[1] == NULL)
+	{
+		fprintf(stderr, "%s: %d: printf: usage: printf format "
+			"[arg ...]\n", shell_name, command_count);
+		return (2);
+	}
+	fmt = args[1];
+	args += 2;
+	do {
+		n = pf_format(&b, fmt, args + used, &bad);
+		used += n;
+	} while (n > 0 && args[used] != NULL);
+	if (b.len > 0)
+		fwrite(b.s, 1, b.len, stdout);
+	free(b.s);
+	if (bad != NULL)
+		fprintf(stderr, "%s: %d: printf: %s: expected numeric value\n",
+			shell_name, command_count, bad);
+	return (bad != NULL);
+}
@@ -0,0 +1,147 @@
+#include "shell.h"
+
+/**
+ * rb_check - works out how the read builtin may take standard input
+ * @b: the read-ahead buffer
+ * Return: the mode, RB_BYTE, RB_SEEK or RB_OWNED
+ *
+ * Only checked again after read_sync, which runs whenever standard input
+ * may have changed. A buffer still holding input of another pipe is kept
+ * for when that pipe comes back, and this input is read a byte at a time.
+ */
+static int rb_check(rbuf_t *b)
+{
+	struct stat st;
+	int i;
+
+	if (b->checked)
+		return (b->mode);
+	b->checked = 1;
+	b->mode = RB_BYTE;
+	if (fstat(0, &st) != 0)
+		return (RB_BYTE);
+	if (b->pos < b->len && (st.st_dev != b->dev || st.st_ino != b->ino))
+		return (RB_BYTE);
+	b->dev = st.st_dev;
+	b->ino = st.st_ino;
+	if (S_ISREG(st.st_mode) && lseek(0, 0, SEEK_CUR) >= 0)
+		b->mode = RB_SEEK;
+	for (i = 0; i < b->nown && b->mode == RB_BYTE; i++)
+		if (st.st_dev == b->own_dev[i] && st.st_ino == b->own_ino[i])
+			b->mode = RB_OWNED;
+	return (b->mode);
+}
+
+/**
+ * rb_fill - reads the next block of standard input into the buffer
+ * @b: the read-ahead buffer, empty
+ * Return: number of bytes read, 0 at end of input, -1 on error
+ */
+static ssize_t rb_fill(rbuf_t *b)
+{
+	ssize_t n;
+
+	if (b->buf == NULL && (b->buf = malloc(RB_BLOCK)) == NULL)
+		return (-1);
+	if (b->mode == RB_SEEK && !b->synced)
+	{
+		b->synced = 1;
+		atexit(read_sync);
+	}
+	do
+		n = read(0, b->buf, RB_BLOCK);
+	while (n < 0 && errno == EINTR);
+	b->pos = 0;
+	b->len = n > 0 ? n : 0;
+	return (n);
+}
+
+/**
+ * rb_getc - takes the next byte of standard input
+ * @b: the read-ahead buffer
+ * Return: the byte, -1 at end of input, -2 on error
+ */
+static int rb_getc(rbuf_t *b)
+{
+	unsigned char c;
+	ssize_t n;
+
+	if (rb_check(b) == RB_BYTE)
+	{
+		do
+			n = read(0, &c, 1);
+		while (n < 0 && errno == EINTR);
+		return (n == 1 ? c : n == 0 ? -1 : -2);
+	}
+	if (b->pos == b->len && (n = rb_fill(b)) <= 0)
+		return (n == 0 ? -1 : -2);
+	return ((unsigned char)b->buf[b->pos++]);
+}
+
+/**
+ * read_line - reads a line of standard input for the read builtin
+ * @line: receives the line without its delimiter; unless @raw, each byte
+ * a backslash escaped keeps the backslash in front of it, and
+ * backslash-newline pairs are dropped
+ * @delim: the delimiter
+ * @raw: nonzero for read -r
+ * Return: 0 when the delimiter was found, 1 at end of input, -1 on error
+ *
+ * Input that no other process can read next is taken in blocks of
+ * RB_BLOCK bytes, and a raw line is then found with a single memchr.
+ */
+int read_line(wbuf_t *line, int delim, int raw)
+{
+	rbuf_t *b = &g_sh.rbuf;
+	int c, esc = 0;
+	char *p;
+	size_t n;
+
+	while (1)
+	{
+		if (raw && b->pos < b->len && rb_check(b) != RB_BYTE)
+		{
+			p = memchr(b->buf + b->pos, delim, b->len - b->pos);
+			n = (p != NULL ? (size_t)(p - b->buf) : b->len) -
+				b->pos;
+			wbuf_put(line, b->buf + b->pos, n);
+			b->pos += n + (p != NULL);
+			if (p != NULL)
+				return (0);
+		}
+		c = rb_getc(b);
+		if (c < 0)
+			return (c == -1 ? 1 : -1);
+		if (esc)
+		{
+			esc = 0;
+			if (c != '\n')
+				wbuf_putc(line, '\\'), wbuf_putc(line, c);
+		}
+		else if (c == delim)
+			return (0);
+		else if (c == '\\' && !raw)
+			esc = 1;
+		else
+			wbuf_putc(line, c);
+	}
+}
+
+/**
+ * read_sync - gives back input the read builtin took ahead
+ *
+ * Runs before standard input changes, before the shell starts another
+ * process and when it exits. Input taken from a regular file goes back
+ * with lseek, so whatever reads next starts right after the last line
+ * read; input of a pipe only a loop reads stays for the next read.
+ */
+void read_sync(void)
+{
+	rbuf_t *b = &g_sh.rbuf;
+
+	if (b->mode == RB_SEEK && b->pos < b->len)
+		lseek(0, -(off_t)(b->len - b->pos), SEEK_CUR);
+	if (b->mode == RB_SEEK)
+		b->pos = b->len = 0;
+	b->checked = 0;
+}
@@ -0,0 +1,135 @@
+#include "shell.h"
+
+/**
+ * read_skip - skips IFS white space
+ * @s: the text
+ * @ifs: the field separators
+ * Return: the first byte that is not white space in @ifs
+ */
+static char *read_skip(char *s, const char *ifs)
+{
+	while (*s != '\0' && strchr(ifs, *s) != NULL &&
+		strchr(" \t\n", *s) != NULL)
+		s++;
+	return (s);
+}
+
+/**
+ * read_split - splits a line read by read into variables
+ * @s: the line, split in place
+ * @names: NULL terminated names of the variables
+ * @ifs: the field separators
+ * @raw: nonzero for read -r, where backslashes escape nothing
+ * Return: 0 on success, 1 when a variable could not be set
+ *
+ * Fields are split as by expansion; the last variable gets the rest of
+ * the line, less trailing IFS white space.
+ */
+static int read_split(char *s, char **names, const char *ifs, int raw)
+{
+	char *f, *d, *keep, sep;
+	int i, bad = 0;
+
+	for (i = 0; names[i] != NULL; i++)
+	{
+		s = read_skip(s, ifs);
+		for (f = d = keep = s; *s != '\0'; )
+			if (!raw && *s == '\\' && s[1] != '\0')
+			{
+				*d++ = s[1];
+				s += 2;
+				keep = d;
+			}
+			else if (names[i + 1] != NULL &&
+				strchr(ifs, *s) != NULL)
+				break;
+			else
+			{
+				if (strchr(ifs, *s) == NULL ||
+					strchr(" \t\n", *s) == NULL)
+					keep = d + 1;
+				*d++ = *s++;
+			}
+		sep = *s;
+		s += sep != '\0';
+		*(names[i + 1] != NULL ? d : keep) = '\0';
+		if (sep != '\0' && strchr(" \t\n", sep) != NULL)
+		{
+			s = read_skip(s, ifs);
+			s += *s != '\0' && strchr(ifs, *s) != NULL;
+		}
+		bad |= var_set(names[i], f, 0) != 0;
+	}
+	return (bad);
+}
+
+/**
+ * read_opts - parses the options of read
+ * @args: the arguments of read
+ * @raw: set for -r
+ * @delim: set to the byte given with -d
+ * Return: index of the first name, -1 on a usage error
+ */
+static int read_opts(char *args[], int *raw, int *delim)
+{
+	int i;
+
+	for (i = 1; args[i] != NULL && args[i][0] == '-'; i++)
+	{
+		if (strcmp(args[i], "--") == 0)
+			return (i + 1);
+		if (strcmp(args[i], "-r") == 0)
+			*raw = 1;
+		else if (strcmp(args[i], "-d") == 0 && args[i + 1] != NULL)
+			*delim = (unsigned char)args[++i][0];
+		else
+			return (-1);
+	}
+	return (i);
+}
+
+/**
+ * handle_read - handles the built-in "read" command
+ * @args: "read", its options and the names of the variables to set
+ * @shell_name: the name of the shell
+ * @command_count: line number, for messages
+ * Return: 0 when a whole line was read, 1 at end of input or on error, 2
+ * on a usage error
+ *
+ * Supports -r and -d delim; with no names the line goes to REPLY as it
+ * is. Input is read a byte at a time only when another process could
+ * read what follows the line; see read_line.
+ */
+int handle_read(char *args[], const char *shell_name, int command_count)
+{
+	static wbuf_t line;
+	static char *reply[] = {"REPLY", NULL};
+	const char *ifs = var_get("IFS");
+	int raw = 0, delim = '\n', i = read_opts(args, &raw, &delim), r;
+
+	if (i < 0)
+	{
+		fprintf(stderr, "%s: %d: read: usage: read [-r] [-d delim] "
+			"[name ...]\n", shell_name, command_count);
+		return (2);
+	}
+	for (r = i; args[r] != NULL; r++)
+		if (!is_name(args[r]))
+		{
+			fprintf(stderr, "%s: %d: read: %s: bad variable name\n",
+				shell_name, command_count, args[r]);
+			return (2);
+		}
+	if (wbuf_grow(&line, 1) != 0)
+		return (1);
+	line.len = 0;
+	line.s[0] = '\0';
+	r = read_line(&line, delim, raw);
+	if (r < 0)
+		fprintf(stderr, "%s: %d: read: %s\n", shell_name, command_count,
+			strerror(errno));
+	if (args[i] == NULL)
+		return (read_split(line.s, reply, "", raw) != 0 || r != 0);
+	return (read_split(line.s, args + i, ifs != NULL ? ifs : " \t\n",
+		raw) != 0 || r != 0);
+}
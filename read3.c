@@ -0,0 +1,42 @@
+#include "shell.h"
+
+/**
+ * read_own - lets read take blocks of a pipe only a loop of the shell
+ * reads
+ * @fd: descriptor of the pipe
+ * Return: 1 when the pipe was recorded, to be undone by read_disown; 0
+ * when @fd is not a pipe
+ *
+ * Used for the pipe of a here-document after "done" and for the input of
+ * a pipeline stage, where nothing outside the loop reads what follows.
+ */
+int read_own(int fd)
+{
+	rbuf_t *b = &g_sh.rbuf;
+	struct stat st;
+
+	if (b->nown == RB_OWN_MAX || fstat(fd, &st) != 0 ||
+		!S_ISFIFO(st.st_mode))
+		return (0);
+	b->own_dev[b->nown] = st.st_dev;
+	b->own_ino[b->nown++] = st.st_ino;
+	b->checked = 0;
+	return (1);
+}
+
+/**
+ * read_disown - undoes the last read_own once its loop is done
+ *
+ * Whatever was taken ahead from the pipe is dropped with it.
+ */
+void read_disown(void)
+{
+	rbuf_t *b = &g_sh.rbuf;
+
+	if (b->nown == 0)
+		return;
+	b->nown--;
+	if (b->dev == b->own_dev[b->nown] && b->ino == b->own_ino[b->nown])
+		b->pos = b->len = 0;
+	b->checked = 0;
+}
@@ -0,0 +1,137 @@
+#include "shell.h"
+
+/**
+ * rec_flush - writes out the buffered records
+ */
+static void rec_flush(void)
+{
+	rec_t *r = &g_sh.rec;
+	size_t off = 0;
+	ssize_t w;
+
+	while (off < r->buf.len)
+	{
+		w = write(r->fd, r->buf.s + off, r->buf.len - off);
+		if (w < 0 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			break;
+		off += w;
+	}
+	r->buf.len = 0;
+}
+
+/**
+ * rec_close - ends a recording or a replay as the shell exits
+ *
+ * A recording ends with the time spent in each stage and the number of
+ * simple commands run; a replay reports how its own compare. Registered
+ * with atexit, and forked children leave both to the shell.
+ */
+static void rec_close(void)
+{
+	static const char *const name[REC_STAGES] = {"input", "parse",
+		"expand", "dispatch", "lookup", "exec"};
+	rec_t *r = &g_sh.rec;
+	int i;
+
+	if (!r->on || r->pid != getpid())
+		return;
+	rec_stage(REC_DISPATCH);
+	if (r->on == REC_REPLAY)
+		rec_report(name);
+	for (i = 0; r->on == REC_RECORD && i < REC_STAGES; i++)
+	{
+		wbuf_printf(&r->buf, "S\t%d\t%s\t%lu", i, name[i],
+			(unsigned long)r->ns[i]);
+		rec_end();
+	}
+	if (r->on == REC_RECORD)
+	{
+		wbuf_printf(&r->buf, "N\t%lu", r->ncmd);
+		rec_end();
+		rec_flush();
+	}
+	close(r->fd);
+	r->on = 0;
+}
+
+/**
+ * rec_open - starts --record or --replay
+ * @file: the record file
+ * @how: REC_RECORD to write it, REC_REPLAY to run it
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 on failure
+ *
+ * Each line of the file is a record: a type, then fields separated by
+ * tabs, with backslashes, tabs and newlines in them escaped. "M" tells
+ * how the input was read, "P" gives $0 and then each positional
+ * parameter, "L" each line of input, "C" the status, the resolved path
+ * and the arguments of each simple command as it finishes, "O" the
+ * status, the text and the output of each command substitution, and "S"
+ * and "N" the totals at exit.
+ */
+int rec_open(const char *file, int how, const char *shell_name)
+{
+	rec_t *r = &g_sh.rec;
+
+	if (r->on)
+	{
+		fprintf(stderr, "%s: 0: --record and --replay are exclusive\n",
+			shell_name);
+		return (-1);
+	}
+	r->fd = open(file, how == REC_RECORD ? O_WRONLY | O_CREAT | O_TRUNC |
+		O_APPEND | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+	if (r->fd < 0 || (how == REC_REPLAY && replay_load(r->fd) != 0))
+	{
+		fprintf(stderr, "%s: 0: %s: %s: %s\n", shell_name, how ==
+			REC_RECORD ? "--record" : "--replay", file,
+			r->fd < 0 ? strerror(errno) : "not a recording");
+		return (-1);
+	}
+	r->on = how;
+	r->pid = getpid();
+	r->fed = 1;
+	r->stage = REC_DISPATCH;
+	rec_stage(REC_DISPATCH);
+	atexit(rec_close);
+	return (0);
+}
+
+/**
+ * rec_stage - moves the shell into another stage of running commands
+ * @stage: the stage entered, a REC_* stage
+ * Return: the stage left, for the caller to go back to
+ *
+ * Time is charged to one stage at a time, so a stage nested in another,
+ * such as parsing a command substitution while expanding, counts once.
+ */
+int rec_stage(int stage)
+{
+	rec_t *r = &g_sh.rec;
+	struct timespec ts;
+	uint64_t now;
+	int old = r->stage;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = (uint64_t)ts.tv_sec * 1000000000U + ts.tv_nsec;
+	if (r->t != 0)
+		r->ns[old] += now - r->t;
+	r->t = now;
+	r->stage = stage;
+	return (old);
+}
+
+/**
+ * rec_end - ends a record, writing the buffer out once it is full
+ *
+ * Forked copies of the shell write each record out as it ends, with a
+ * single write to the file, which is opened for appending.
+ */
+void rec_end(void)
+{
+	wbuf_putc(&g_sh.rec.buf, '\n');
+	if (g_sh.rec.buf.len >= REC_CHUNK || g_sh.rec.pid != getpid())
+		rec_flush();
+}
@@ -0,0 +1,156 @@
+#include "shell.h"
+
+/**
+ * rec_put - appends a field of a record, escaping it
+ * @b: the buffer
+ * @s: the field
+ * @n: its length
+ */
+void rec_put(wbuf_t *b, const char *s, size_t n)
+{
+	size_t i, from;
+
+	for (i = from = 0; i < n; i++)
+		if (s[i] == '\\' || s[i] == '\t' || s[i] == '\n')
+		{
+			wbuf_put(b, s + from, i - from);
+			wbuf_putc(b, '\\');
+			wbuf_putc(b, s[i] == '\t' ? 't' : s[i] == '\n' ? 'n' :
+				'\\');
+			from = i + 1;
+		}
+	wbuf_put(b, s + from, n - from);
+}
+
+/**
+ * rec_input - records input the shell reads
+ * @mode: how it is read, see rec_s
+ * @text: the input
+ * @len: its length
+ *
+ * Only the input of the shell itself is recorded; rc files and the
+ * scripts it runs are read while @fed is set. Standard input comes a
+ * line at a time, and its first line starts the recording.
+ */
+void rec_input(int mode, const char *text, size_t len)
+{
+	rec_t *r = &g_sh.rec;
+	const char *nl;
+	size_t n;
+	int i;
+
+	if (r->on != REC_RECORD || r->pid != getpid() ||
+		(r->fed && mode != 'i'))
+		return;
+	for (i = -1; !r->fed && i < g_sh.nparams; i++)
+	{
+		if (i < 0)
+			wbuf_printf(&r->buf, "M\t%c", mode), rec_end();
+		wbuf_put(&r->buf, "P\t", 2);
+		nl = i < 0 ? g_sh.arg0 : g_sh.params[i];
+		rec_put(&r->buf, nl, strlen(nl));
+		rec_end();
+	}
+	r->fed = 1;
+	while (len > 0)
+	{
+		nl = memchr(text, '\n', len);
+		n = nl != NULL ? (size_t)(nl - text) : len;
+		wbuf_put(&r->buf, "L\t", 2);
+		rec_put(&r->buf, text, n);
+		rec_end();
+		n += nl != NULL;
+		text += n;
+		len -= n;
+	}
+}
+
+/**
+ * rec_key - writes the arguments of a command the way a record holds them
+ * @args: the arguments
+ * Return: a buffer holding them escaped and separated by tabs, reused by
+ * the next call
+ */
+wbuf_t *rec_key(char *args[])
+{
+	static wbuf_t k;
+	int i;
+
+	k.len = 0;
+	wbuf_put(&k, "", 0);
+	for (i = 0; args[i] != NULL; i++)
+	{
+		if (i > 0)
+			wbuf_putc(&k, '\t');
+		rec_put(&k, args[i], strlen(args[i]));
+	}
+	return (&k);
+}
+
+/**
+ * rec_cmd - records a simple command once it has finished
+ * @args: its arguments, before alias expansion
+ * @path: the external command it resolved to, NULL if none
+ * @status: its exit status
+ *
+ * Commands forked copies of the shell run are recorded too. A replay
+ * instead counts the commands the recording never ran, and those that
+ * resolved to another path or ended with another status.
+ */
+void rec_cmd(char *args[], const char *path, int status)
+{
+	rec_t *r = &g_sh.rec;
+	wbuf_t *k;
+	hent_t *e;
+	char *p;
+
+	if (r->pid != getpid() && r->on != REC_RECORD)
+		return;
+	r->ncmd++;
+	k = rec_key(args);
+	if (r->on == REC_RECORD)
+	{
+		wbuf_printf(&r->buf, "C\t%d\t", status);
+		rec_put(&r->buf, path != NULL ? path : "-",
+			path != NULL ? strlen(path) : 1);
+		wbuf_putc(&r->buf, '\t');
+		wbuf_put(&r->buf, k->s, k->len);
+		rec_end();
+		return;
+	}
+	e = ht_find(&r->cmds, k->s);
+	if (e == NULL)
+	{
+		r->miss++;
+		return;
+	}
+	r->diff += strtol(e->val, &p, 10) != status ||
+		strcmp(p + 1, path != NULL ? path : "-") != 0;
+}
+
+/**
+ * rec_stub - stands in for a command during a replay
+ * @args: its arguments
+ * @sp: settings of the prefix builtins, for --replay-exec; NULL for a
+ * builtin, see rec_skip
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: the status the command last ended with in the recording, 127
+ * when the recording never ran it
+ *
+ * Nothing runs, unless --replay-exec gave a command to run in place of
+ * an external command with the same arguments, such as /bin/true to
+ * time starting processes.
+ */
+int rec_stub(char *args[], spawn_t *sp, const char *shell_name, int line)
+{
+	hent_t *e = ht_find(&g_sh.rec.cmds, rec_key(args)->s);
+
+	if (g_sh.rec.exec != NULL && sp != NULL)
+		spawn_cmd(g_sh.rec.exec, args, sp, shell_name, line);
+	if (e != NULL)
+		return (atoi(e->val));
+	fprintf(stderr, "%s: %d: replay: %s: not in the recording\n",
+		shell_name, line, args[0]);
+	return (127);
+}
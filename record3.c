@@ -0,0 +1,129 @@
+#include "shell.h"
+
+/**
+ * rec_nth - names the next run of a command substitution
+ * @pfx: "l" while loading a recording, "r" while replaying it
+ * @text: the text of the substitution, escaped as in a record
+ * Return: "o<TAB>run<TAB>text" for the next run of @text, in a buffer the
+ * next call reuses, or NULL on failure
+ *
+ * Runs of the same text are counted from 0, for each @pfx on its own, so
+ * a substitution run again in a loop gets its outputs back in order.
+ */
+static char *rec_nth(const char *pfx, const char *text)
+{
+	static wbuf_t k;
+	hent_t *e;
+	long n;
+
+	k.len = 0;
+	if (wbuf_printf(&k, "%s\t%s", pfx, text) != 0)
+		return (NULL);
+	e = ht_insert(&g_sh.rec.subs, k.s);
+	if (e == NULL)
+		return (NULL);
+	n = e->val != NULL ? atol(e->val) : 0;
+	free(e->val);
+	e->val = malloc(24);
+	if (e->val == NULL)
+		return (NULL);
+	sprintf(e->val, "%ld", n + 1);
+	k.len = 0;
+	return (wbuf_printf(&k, "o\t%ld\t%s", n, text) != 0 ? NULL : k.s);
+}
+
+/**
+ * replay_out - takes in a "C" or "O" record of a recording to replay
+ * @r: the replay
+ * @f: the fields of the record
+ * @type: 'C' for a command, 'O' for the output of a substitution
+ * Return: 0 on success, -1 on failure
+ */
+int replay_out(rec_t *r, char *f, int type)
+{
+	char *a = strchr(f, '\t'), *b = a != NULL ? strchr(a + 1, '\t') : NULL;
+	hent_t *e;
+
+	if (b == NULL)
+		return (-1);
+	*b++ = '\0';
+	if (type == 'O')
+	{
+		*a++ = '\0';
+		a = rec_nth("l", a);
+	}
+	if (type == 'C')
+		e = ht_insert(&r->cmds, b);
+	else
+		e = a != NULL ? ht_insert(&r->subs, a) : NULL;
+	if (e == NULL)
+		return (-1);
+	free(e->val);
+	if (type == 'C')
+		e->val = strdup(rec_unesc(f));
+	else if ((e->val = malloc(strlen(f) + strlen(b) + 2)) != NULL)
+		sprintf(e->val, "%s\t%s", f, rec_unesc(b));
+	return (e->val != NULL ? 0 : -1);
+}
+
+/**
+ * rec_subst - records or replays a command substitution
+ * @prog: the parsed command, NULL during a replay
+ * @x: the expansion buffer
+ * @text: the text of the substitution
+ * @len: its length
+ * @out: receives the output
+ * Return: exit status of the command
+ *
+ * A recording keeps the output and status of each substitution the
+ * shell runs, though not of those nested in it. A replay gives them back
+ * in the order they were recorded, without running anything, so that
+ * loops and tests on them go the way they went; a substitution the
+ * recording never ran fails with 127.
+ */
+int rec_subst(node_t *prog, expand_t *x, const char *text, size_t len,
+wbuf_t *out)
+{
+	static wbuf_t t;
+	rec_t *r = &g_sh.rec;
+	hent_t *e = NULL;
+	char *p;
+	int status;
+
+	if (r->on == REC_RECORD)
+		r->depth++;
+	status = r->on == REC_RECORD ? subst_run(prog, x, out) : 127;
+	t.len = 0;
+	wbuf_put(&t, "", 0);
+	rec_put(&t, text, len);
+	if (r->on == REC_RECORD && --r->depth == 0)
+	{
+		wbuf_printf(&r->buf, "O\t%d\t%s\t", status, t.s);
+		rec_put(&r->buf, out->len > 0 ? out->s : "", out->len);
+		rec_end();
+	}
+	if (r->on != REC_REPLAY)
+		return (status);
+	p = rec_nth("r", t.s);
+	e = p != NULL ? ht_find(&r->subs, p) : NULL;
+	if (e == NULL)
+	{
+		fprintf(stderr, "%s: %d: replay: $(%s): not in the recording\n",
+			x->shell_name, x->line, t.s);
+		return (127);
+	}
+	status = strtol(e->val, &p, 10);
+	wbuf_put(out, p + 1, strlen(p + 1));
+	return (status);
+}
+
+/**
+ * rec_skip - tells whether a replay stands in for a builtin
+ * @name: the builtin
+ * Return: 1 for builtins that start processes of their own, which a
+ * replay must not run, 0 otherwise
+ */
+int rec_skip(const char *name)
+{
+	return (strcmp(name, "batch") == 0 || strcmp(name, "coproc") == 0);
+}
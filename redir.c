@@ -0,0 +1,179 @@
+#include "shell.h"
+
+/**
+ * redir_expand - expands the operands of the redirections of a command
+ * @x: the expansion buffer of the command
+ * @n: the N_CMD node
+ * Return: number of fields added, one per redirection
+ *
+ * The operands are expanded in the same pass as the words of the command,
+ * without splitting or pathname expansion. Here-document bodies expand as
+ * if double quoted unless their delimiter was quoted.
+ */
+int redir_expand(expand_t *x, node_t *n)
+{
+	const char *w, *op;
+	int i;
+
+	for (i = 0; i < n->nkids && !x->err; i++)
+	{
+		w = n->kids[i]->words[1];
+		op = n->kids[i]->words[0];
+		op += *op >= '0' && *op <= '9';
+		x->nosplit = 1;
+		x->quoted = 1;
+		if (n->kids[i]->flags & NF_LITERAL)
+			x_value(x, w, strlen(w), 1);
+		else
+		{
+			x->here = op[1] == '<' && op[2] != '<';
+			x_span(x, w, w + strlen(w), x->here);
+			x->here = 0;
+		}
+		x_field(x);
+		x_break(x);
+	}
+	x->nosplit = 0;
+	return (n->nkids);
+}
+
+/**
+ * here_fd - makes a descriptor to read a here-document or here-string from
+ * @s: the text
+ * @nl: nonzero to add a newline, for a here-string
+ * Return: the descriptor, -1 on failure
+ *
+ * Text that fits the pipe buffer is written into a pipe; anything larger
+ * goes into a sealed memfd. Nothing touches the file system either way.
+ */
+static int here_fd(const char *s, int nl)
+{
+	struct iovec v[2];
+	int fd[2], r;
+	size_t len = strlen(s);
+
+	v[0].iov_base = (char *)s, v[0].iov_len = len;
+	v[1].iov_base = "\n", v[1].iov_len = nl != 0;
+	len += nl != 0;
+	if (pipe2(fd, O_CLOEXEC) != 0)
+		return (-1);
+	if (len > PIPE_BUF && fcntl(fd[1], F_GETPIPE_SZ) < (long)len)
+	{
+		close(fd[1]);
+		close(fd[0]);
+		fd[0] = fd[1] = memfd_create("hsh-here",
+			MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (fd[0] < 0)
+			return (-1);
+	}
+	r = writev(fd[1], v, 2) == (ssize_t)len;
+	if (fd[1] != fd[0])
+		close(fd[1]);
+	else if (r)
+		r = fcntl(fd[0], F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW |
+			F_SEAL_WRITE | F_SEAL_SEAL) == 0 &&
+			lseek(fd[0], 0, SEEK_SET) == 0;
+	if (!r)
+		close(fd[0]);
+	return (r ? fd[0] : -1);
+}
+
+/**
+ * redir_src - opens what a redirection makes its descriptor a copy of
+ * @op: the operator, without the descriptor number
+ * @val: the expanded operand
+ * @own: set to 1 when the result was opened here and must be closed
+ * Return: the descriptor, -1 to close, -2 on failure with errno set
+ *
+ * A --replay writes nothing: files opened for writing are /dev/null.
+ */
+static int redir_src(const char *op, const char *val, int *own)
+{
+	int fd, flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+	*own = op[1] != '&';
+	if (!*own && strcmp(val, "-") == 0)
+		return (-1);
+	if (!*own)
+	{
+		fd = *val != '\0' && strlen(val) < 6 &&
+			!check_for_non_digit(val) ? atoi(val) : -1;
+		errno = EBADF;
+		return (fd >= 0 && fcntl(fd, F_GETFD) >= 0 ? fd : -2);
+	}
+	if (op[1] == '<')
+		fd = here_fd(val, op[2] == '<');
+	else
+	{
+		if (op[0] == '<')
+			flags = op[1] == '>' ? O_RDWR | O_CREAT : O_RDONLY;
+		else if (op[1] == '>')
+			flags = O_WRONLY | O_CREAT | O_APPEND;
+		if (g_sh.rec.on == REC_REPLAY && flags != O_RDONLY)
+			val = "/dev/null";
+		fd = open(val, flags | O_CLOEXEC, 0666);
+	}
+	return (fd >= 0 ? fd : -2);
+}
+
+/**
+ * redir_open - opens the redirections of a command
+ * @r: receives them
+ * @n: the N_CMD node
+ * @vals: the expanded operand of each N_REDIR kid
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 on failure, with nothing left open
+ *
+ * Descriptors opened below 10 that the command redirects are moved up,
+ * so applying the redirections in order never clobbers one of them.
+ */
+int redir_open(redir_t *r, node_t *n, char **vals, const char *shell_name)
+{
+	unsigned int mask = 0;
+	const char *op;
+	int i, fd, own;
+
+	for (i = 0; i < n->nkids; i++)
+		op = n->kids[i]->words[0], mask |= 1U << (*op >= '0' &&
+			*op <= '9' ? *op - '0' : *op == '<' ? 0 : 1);
+	for (r->n = 0, r->own = 0; r->n < n->nkids; r->n++)
+	{
+		op = n->kids[r->n]->words[0];
+		r->fd[r->n] = *op >= '0' && *op <= '9' ? *op++ - '0' :
+			*op == '<' ? 0 : 1;
+		fd = redir_src(op, vals[r->n], &own);
+		if (fd >= 0 && fd < 10 && own && (mask >> fd & 1))
+		{
+			i = fd;
+			fd = fcntl(i, F_DUPFD_CLOEXEC, 10);
+			close(i);
+		}
+		if (fd < -1 || (own && fd < 0))
+		{
+			fprintf(stderr, "%s: %d: cannot %s %s: %s\n",
+				shell_name, n->line,
+				own && *op != '<' ? "create" : "open",
+				vals[r->n], strerror(errno));
+			redir_close(r);
+			return (-1);
+		}
+		r->src[r->n] = fd;
+		r->own |= (unsigned int)own << r->n;
+	}
+	return (0);
+}
+
+/**
+ * redir_close - closes the descriptors opened for a command's redirections
+ * @r: the redirections
+ */
+void redir_close(redir_t *r)
+{
+	int i;
+
+	for (i = 0; i < r->n; i++)
+		if (r->own >> i & 1)
+			close(r->src[i]);
+	r->n = 0;
+	r->own = 0;
+}
@@ -0,0 +1,73 @@
+#include "shell.h"
+
+/**
+ * redir_apply - applies redirections to the shell itself
+ * @r: the redirections
+ * Return: 0 on success, -1 on failure, with nothing changed
+ *
+ * Used around builtins, functions and loops. The original descriptors are
+ * kept above 10 for redir_restore. Input the read builtin took ahead is
+ * given back before standard input changes.
+ */
+int redir_apply(redir_t *r)
+{
+	int i, n = r->n;
+
+	fflush(stdout);
+	fflush(stderr);
+	for (i = 0; i < n; i++)
+	{
+		if (r->fd[i] == 0)
+			read_sync();
+		r->save[i] = fcntl(r->fd[i], F_DUPFD_CLOEXEC, 10);
+		if (r->src[i] < 0)
+			close(r->fd[i]);
+		else if (dup2(r->src[i], r->fd[i]) < 0)
+		{
+			r->n = i + 1;
+			redir_restore(r);
+			r->n = n;
+			return (-1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * redir_restore - undoes redir_apply
+ * @r: the redirections
+ */
+void redir_restore(redir_t *r)
+{
+	int i;
+
+	fflush(stdout);
+	fflush(stderr);
+	for (i = r->n - 1; i >= 0; i--)
+	{
+		if (r->fd[i] == 0)
+			read_sync();
+		if (r->save[i] >= 0)
+		{
+			dup2(r->save[i], r->fd[i]);
+			close(r->save[i]);
+		}
+		else
+			close(r->fd[i]);
+	}
+}
+
+/**
+ * redir_child - applies redirections in a child about to exec
+ * @r: the redirections, NULL for none
+ */
+void redir_child(redir_t *r)
+{
+	int i;
+
+	for (i = 0; r != NULL && i < r->n; i++)
+		if (r->src[i] < 0)
+			close(r->fd[i]);
+		else
+			dup2(r->src[i], r->fd[i]);
+}
@@ -0,0 +1,51 @@
+#include "shell.h"
+
+/**
+ * repl_init - sets up the source of an interactive shell
+ * @src: the source, reading standard input
+ * @rec: buffer collecting the text of each command for the history
+ *
+ * The line editor and the history are used when both standard input and
+ * standard output are terminals, unless TERM is "dumb".
+ */
+void repl_init(source_t *src, wbuf_t *rec)
+{
+	const char *term = getenv("TERM");
+
+	src_init(src, NULL, 0, stdin);
+	memset(rec, 0, sizeof(*rec));
+	src->edit = isatty(STDIN_FILENO) && isatty(STDOUT_FILENO) &&
+		(term == NULL || strcmp(term, "dumb") != 0);
+	src->rec = src->edit ? rec : NULL;
+}
+
+/**
+ * repl_exec - runs a command read at the prompt and records it
+ * @cmd: the command
+ * @src: the source it was read from; its @rec buffer holds the text
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * Return: exit status of the command
+ *
+ * The history record carries the start time, the run time and the exit
+ * status of the command.
+ */
+int repl_exec(node_t *cmd, source_t *src, const char *shell_name,
+int status)
+{
+	struct timespec t0, t1;
+	time_t when = time(NULL);
+	long ms;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	status = exec_top(cmd, shell_name, status, src->line);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	ms = (t1.tv_sec - t0.tv_sec) * 1000L +
+		(t1.tv_nsec - t0.tv_nsec) / 1000000L;
+	if (src->rec != NULL && src->rec->s != NULL)
+		hist_add(src->rec->s + strspn(src->rec->s, " \t\n"), when, ms,
+			status);
+	if (src->rec != NULL)
+		src->rec->len = 0;
+	return (status);
+}
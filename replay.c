@@ -0,0 +1,161 @@
+#include "shell.h"
+
+/**
+ * rec_unesc - undoes the escapes of a field of a record, in place
+ * @s: the field
+ * Return: @s
+ */
+char *rec_unesc(char *s)
+{
+	char *d = s, *p;
+
+	for (p = s; *p != '\0'; p++)
+		if (*p == '\\' && p[1] != '\0')
+		{
+			p++;
+			*d++ = *p == 't' ? '\t' : *p == 'n' ? '\n' : *p;
+		}
+		else
+			*d++ = *p;
+	*d = '\0';
+	return (s);
+}
+
+/**
+ * replay_line - takes in a record of a recording to replay
+ * @r: the replay
+ * @l: the record, without its newline
+ * Return: 0 on success, -1 when it is not a record
+ */
+static int replay_line(rec_t *r, char *l)
+{
+	char *f = l + 2, **v;
+
+	if (l[0] == '\0' || l[1] != '\t')
+		return (l[0] == '\0' ? 0 : -1);
+	if (l[0] == 'L' || l[0] == 'P')
+		rec_unesc(f);
+	if (l[0] == 'M')
+		r->mode = *f;
+	else if (l[0] == 'L')
+		return (wbuf_put(&r->text, f, strlen(f)) != 0 ||
+			wbuf_putc(&r->text, '\n') != 0 ? -1 : 0);
+	else if (l[0] == 'P')
+	{
+		v = realloc(r->argv, (r->argc + 2) * sizeof(*v));
+		if (v != NULL)
+			r->argv = v;
+		if (v == NULL || (v[r->argc] = strdup(f)) == NULL)
+			return (-1);
+		v[++r->argc] = NULL;
+	}
+	else if (l[0] == 'C' || l[0] == 'O')
+		return (replay_out(r, f, l[0]));
+	else if (l[0] == 'S' && atoi(f) >= 0 && atoi(f) < REC_STAGES &&
+		strrchr(f, '\t') != NULL)
+		r->rns[atoi(f)] = strtoul(strrchr(f, '\t') + 1, NULL, 10);
+	else if (l[0] == 'N')
+		r->rcmd = strtoul(f, NULL, 10);
+	return (0);
+}
+
+/**
+ * replay_load - reads a recording for --replay
+ * @fd: the record file
+ * Return: 0 on success, -1 on failure
+ */
+int replay_load(int fd)
+{
+	wbuf_t b;
+	char *l, *nl;
+	ssize_t n = 1;
+	int bad = 0;
+
+	memset(&b, 0, sizeof(b));
+	while (n > 0 && wbuf_grow(&b, 1 << 16) == 0)
+	{
+		n = read(fd, b.s + b.len, b.cap - b.len - 1);
+		b.len += n > 0 ? n : 0;
+		if (n < 0 && errno == EINTR)
+			n = 1;
+	}
+	if (n != 0)
+		bad = 1;
+	for (l = b.s; !bad && l != NULL && *l != '\0'; l = nl)
+	{
+		nl = strchr(l, '\n');
+		if (nl != NULL)
+			*nl++ = '\0';
+		bad = replay_line(&g_sh.rec, l) != 0;
+	}
+	free(b.s);
+	return (bad || g_sh.rec.mode == 0 ? -1 : 0);
+}
+
+/**
+ * rec_replay - runs the input of a recording for --replay
+ * @shell_name: name of shell executed
+ * Return: exit status of the last command
+ *
+ * Input the recording read from a script or a -c string is parsed all at
+ * once as it was then, and standard input a command at a time. $0 and the
+ * positional parameters are those of the recording.
+ */
+int rec_replay(const char *shell_name)
+{
+	rec_t *r = &g_sh.rec;
+	source_t src;
+	node_t *cmd;
+	int status = 0, type;
+
+	if (r->argc > 0)
+	{
+		g_sh.arg0 = r->argv[0];
+		g_sh.params = r->argv + 1;
+		g_sh.nparams = r->argc - 1;
+	}
+	if (r->mode != 'i')
+		return (run_string(r->text.s != NULL ? r->text.s : "",
+			shell_name));
+	src_init(&src, r->text.s, r->text.len, NULL);
+	while ((cmd = parse_command(&src)) != NULL)
+	{
+		status = exec_top(cmd, shell_name, status, NULL);
+		type = cmd->type;
+		node_free(cmd);
+		if (type == N_SYNERR)
+			break;
+	}
+	return (status);
+}
+
+/**
+ * rec_report - compares a replay with its recording, on standard error
+ * @name: name of each stage
+ *
+ * Exec compares how long external commands took with how long their
+ * stand-ins did; the other stages are the shell's own work.
+ */
+void rec_report(const char *const *name)
+{
+	rec_t *r = &g_sh.rec;
+	double was, now;
+	int i;
+
+	fflush(stdout);
+	fprintf(stderr, "replay: %lu commands, %lu recorded; %lu never "
+		"recorded, %lu resolved or ended differently\n", r->ncmd,
+		r->rcmd, r->miss, r->diff);
+	fprintf(stderr, "%-10s %14s %14s %9s\n", "stage", "recorded ms",
+		"replayed ms", "change");
+	for (i = 0; i < REC_STAGES; i++)
+	{
+		was = r->rns[i] / 1e6;
+		now = r->ns[i] / 1e6;
+		fprintf(stderr, "%-10s %14.3f %14.3f", name[i], was, now);
+		if (was > 0)
+			fprintf(stderr, " %+8.1f%%\n", 100 * (now - was) / was);
+		else
+			fprintf(stderr, " %9s\n", "-");
+	}
+}
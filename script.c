@@ -0,0 +1,134 @@
+#include "shell.h"
+
+/**
+ * script_parse - reads and parses a whole script file
+ * @fd: open descriptor of the script
+ * @st: stat of the script
+ * Return: an N_LIST node, or NULL on failure
+ */
+static node_t *script_parse(int fd, struct stat *st)
+{
+	char *buf;
+	node_t *prog;
+
+	if (st->st_size == 0)
+		return (node_new(N_LIST, 0));
+	buf = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (buf == MAP_FAILED)
+		return (NULL);
+	rec_input('s', buf, st->st_size);
+	prog = parse_buffer(buf, st->st_size);
+	munmap(buf, st->st_size);
+	return (prog);
+}
+
+/**
+ * run_parsed - executes the top level commands of a parsed script
+ * @prog: the parsed script
+ * @from: index of the first command to run
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * Return: exit status of the last command
+ */
+static int run_parsed(node_t *prog, unsigned int from, const char *shell_name,
+int status)
+{
+	unsigned int i;
+	int tail = g_sh.tail;
+
+	for (i = from; prog != NULL && i < (unsigned int)prog->nkids; i++)
+	{
+		g_sh.tail = tail && i + 1 == (unsigned int)prog->nkids;
+		ahead_at(prog->kids, NULL, prog->nkids, i + 1);
+		status = exec_top(prog->kids[i], shell_name, status, NULL);
+		if (prog->kids[i]->type == N_SYNERR)
+			break;
+	}
+	g_sh.tail = tail;
+	ahead_at(NULL, NULL, 0, 0);
+	node_free(prog);
+	return (status);
+}
+
+/**
+ * run_cached - executes a script from its compiled form
+ * @c: the mapped compiled script
+ * @fd: open descriptor of the script, to re-parse on a damaged cache
+ * @st: stat of the script
+ * @shell_name: name of shell executed
+ * Return: exit status of the last command
+ *
+ * Commands are materialised one at a time, so startup does not depend on
+ * the length of the script.
+ */
+static int run_cached(cache_t *c, int fd, struct stat *st,
+const char *shell_name)
+{
+	unsigned int i;
+	int status = 0, tail = g_sh.tail;
+	node_t *n;
+
+	for (i = 0; i < c->ntop; i++)
+	{
+		g_sh.tail = tail && i + 1 == c->ntop;
+		ahead_at(NULL, c, c->ntop, i + 1);
+		n = cache_node(c, i);
+		if (n == NULL)
+		{
+			cache_close(c);
+			g_sh.tail = tail;
+			return (run_parsed(script_parse(fd, st), i, shell_name,
+				status));
+		}
+		status = exec_top(n, shell_name, status, NULL);
+		i = n->type == N_SYNERR ? c->ntop : i;
+		node_free(n);
+	}
+	ahead_at(NULL, NULL, 0, 0);
+	cache_close(c);
+	g_sh.tail = tail;
+	return (status);
+}
+
+/**
+ * run_script - runs a script file, using its compiled form when current
+ * @path: path of the script
+ * @shell_name: name of shell executed
+ * Return: exit status of the script
+ */
+int run_script(const char *path, const char *shell_name)
+{
+	struct stat st;
+	cache_t c;
+	node_t *prog;
+	int fd, status;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "%s: 0: Can't open %s\n", shell_name, path);
+		return (127);
+	}
+	if (g_sh.rec.on != REC_RECORD && cache_load(path, &st, &c) == 0)
+		status = run_cached(&c, fd, &st, shell_name);
+	else
+	{
+		prog = script_parse(fd, &st);
+		if (prog != NULL)
+			cache_store(path, &st, prog);
+		status = run_parsed(prog, 0, shell_name, 0);
+	}
+	close(fd);
+	return (status);
+}
+
+/**
+ * run_string - runs the commands of a -c string
+ * @s: the string
+ * @shell_name: name of shell executed
+ * Return: exit status of the last command
+ */
+int run_string(const char *s, const char *shell_name)
+{
+	return (run_parsed(parse_buffer(s, strlen(s)), 0, shell_name, 0));
+}
@@ -0,0 +1,91 @@
+#include "shell.h"
+
+/**
+ * script_fresh - leaves the shell as a new one started on a script would
+ * be
+ * @path: the script, which becomes $0
+ * @args: the command line it was run with
+ * @shell_name: name of the shell
+ *
+ * The environment, the directory and the caches stay, the latter warm.
+ * Variables that are not exported, functions and aliases go, and the rc
+ * file runs again, usually from its snapshot. Options that only belong
+ * to the shell's own command line, such as --metrics, are dropped.
+ */
+static void script_fresh(const char *path, char *args[],
+const char *shell_name)
+{
+	static char *unalias[] = {"unalias", "-a", NULL};
+	unsigned int i;
+	hent_t *e, *next;
+
+	for (i = 0; i < g_sh.vars.nb; i++)
+		for (e = g_sh.vars.b[i]; e != NULL; e = next)
+		{
+			next = e->next;
+			if (!((var_t *)e->val)->exported)
+				var_unset(e->key);
+		}
+	for (i = 0; i < g_sh.funcs.nb; i++)
+		while (g_sh.funcs.b[i] != NULL)
+			func_unset(g_sh.funcs.b[i]->key);
+	handle_unalias(unalias, shell_name, 0);
+	stats_reset();
+	g_sh.pid = getpid();
+	g_sh.metrics = NULL;
+	g_sh.audit.on = 0;
+	g_sh.funcnest = 0;
+	g_sh.returning = 0;
+	g_sh.snap = 0;
+	g_sh.interactive = 0;
+	g_sh.arg0 = (char *)path;
+	g_sh.params = args + 1;
+	for (g_sh.nparams = 0; args[g_sh.nparams + 1] != NULL; )
+		g_sh.nparams++;
+	rc_load(shell_name, 0);
+	g_sh.tail = 1;
+}
+
+/**
+ * script_exec - runs a script for this shell without an exec
+ * @path: where the script was found
+ * @args: the command and its arguments
+ * @shell_name: name of shell executed
+ * Return: exit status of the script, -1 if it could not be started
+ *
+ * The script runs in one forked copy of the shell, made fresh by
+ * script_fresh, instead of a new process that starts up from nothing. As
+ * the last command of a script or -c string it runs in the shell itself,
+ * which exits afterwards, unless --trace-events or --audit still have to
+ * record it.
+ */
+int script_exec(const char *path, char *args[], const char *shell_name)
+{
+	redir_t *r = g_sh.redir;
+	int forked = !g_sh.tail || g_sh.trace != NULL || g_sh.audit.on;
+	pid_t pid = 0;
+	int status;
+
+	METRIC_ADD(externals, 1);
+	if (forked)
+	{
+		pid = shell_fork();
+		if (pid < 0)
+			return (-1);
+	}
+	if (pid > 0)
+	{
+		trace_spawn(args[0], pid);
+		status = wait_status(pid);
+		trace_end("proc", args[0], pid, status);
+		return (status);
+	}
+	read_sync();
+	redir_child(r);
+	g_sh.redir = NULL;
+	script_fresh(path, args, shell_name);
+	status = run_script(path, shell_name);
+	if (forked)
+		shell_exit(status);
+	exit(status);
+}
@@ -0,0 +1,96 @@
+#include "shell.h"
+
+/**
+ * cache_check - validates a mapped compiled script against its source
+ * @c: the cache, with map and len set; the remaining fields are filled in
+ * @key: resolved path of the script
+ * @st: stat of the script
+ * @magic: the magic the file must carry
+ * Return: 0 when the compiled form is current, -1 otherwise
+ */
+static int cache_check(cache_t *c, const char *key, struct stat *st,
+const char *magic)
+{
+	const cache_hdr_t *h = c->map;
+	size_t off = sizeof(*h), need;
+
+	if (c->len < off || memcmp(h->magic, magic, 8) != 0 ||
+		strncmp(h->version, HSH_VERSION, sizeof(h->version)) != 0)
+		return (-1);
+	if (h->size != (unsigned long)st->st_size ||
+		h->mtime_sec != (long)st->st_mtim.tv_sec ||
+		h->mtime_nsec != (long)st->st_mtim.tv_nsec ||
+		h->ctime_sec != (long)st->st_ctim.tv_sec ||
+		h->ctime_nsec != (long)st->st_ctim.tv_nsec ||
+		h->ino != (unsigned long)st->st_ino ||
+		h->dev != (unsigned long)st->st_dev)
+		return (-1);
+	need = off + ((h->path_len + 3) & ~3u) +
+		4 * ((size_t)h->ntop + h->nrecs) + h->str_len;
+	if (need > c->len || h->path_len != strlen(key) ||
+		memcmp((const char *)c->map + off, key, h->path_len) != 0)
+		return (-1);
+	off += (h->path_len + 3) & ~3u;
+	c->ntop = h->ntop;
+	c->index = (const unsigned int *)((const char *)c->map + off);
+	c->recs = c->index + h->ntop;
+	c->nrecs = h->nrecs;
+	c->strs = (const char *)(c->recs + h->nrecs);
+	c->str_len = h->str_len;
+	if (c->str_len > 0 && c->strs[c->str_len - 1] != '\0')
+		return (-1);
+	return (0);
+}
+
+/**
+ * cache_map - maps a file in the compiled script format if it is current
+ * @file: the file
+ * @key: resolved path of the source it was built from
+ * @st: stat of the source
+ * @magic: CACHE_MAGIC or SNAP_MAGIC
+ * @c: filled in with the mapping
+ * Return: 0 on success, -1 when the file is missing or stale
+ */
+int cache_map(const char *file, const char *key, struct stat *st,
+const char *magic, cache_t *c)
+{
+	struct stat cst;
+	int fd;
+
+	fd = open(file, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return (-1);
+	if (fstat(fd, &cst) != 0 || cst.st_size < (off_t)sizeof(cache_hdr_t))
+	{
+		close(fd);
+		return (-1);
+	}
+	c->len = cst.st_size;
+	c->map = mmap(NULL, c->len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (c->map == MAP_FAILED)
+		return (-1);
+	if (cache_check(c, key, st, magic) != 0)
+	{
+		munmap(c->map, c->len);
+		return (-1);
+	}
+	return (0);
+}
+
+/**
+ * cache_load - maps the compiled form of a script if it is current
+ * @path: path of the script
+ * @st: stat of the script
+ * @c: filled in with the mapping
+ * Return: 0 on success, -1 when the script has to be parsed
+ */
+int cache_load(const char *path, struct stat *st, cache_t *c)
+{
+	char key[PATH_MAX], file[PATH_MAX + 64];
+
+	if (realpath(path, key) == NULL ||
+		cache_file_name(key, file, sizeof(file)) != 0)
+		return (-1);
+	return (cache_map(file, key, st, CACHE_MAGIC, c));
+}
@@ -0,0 +1,181 @@
+#include "shell.h"
+
+/**
+ * cache_file_name - builds the name of the compiled form of a script
+ * @key: resolved path of the script
+ * @out: buffer for the file name
+ * @size: size of @out
+ * Return: 0 on success, -1 when caching is disabled or the name is too long
+ *
+ * The cache lives in $HSH_CACHE_DIR, $XDG_CACHE_HOME/hsh or ~/.cache/hsh;
+ * setting HSH_CACHE_DIR to the empty string disables it. As the XDG
+ * spec asks, an XDG_CACHE_HOME that is not an absolute path is ignored.
+ */
+int cache_file_name(const char *key, char *out, size_t size)
+{
+	const char *dir = getenv("HSH_CACHE_DIR"), *base = "%s/%016lx.hshc";
+	const char *xdg;
+	unsigned long h = 14695981039346656037UL;
+	int r;
+
+	for (; *key; key++)
+		h = (h ^ (unsigned char)*key) * 1099511628211UL;
+	if (dir != NULL && *dir == '\0')
+		return (-1);
+	if (dir == NULL && (xdg = getenv("XDG_CACHE_HOME")) != NULL &&
+		*xdg == '/')
+	{
+		dir = xdg;
+		base = "%s/hsh/%016lx.hshc";
+	}
+	else if (dir == NULL && getenv("HOME") != NULL)
+	{
+		dir = getenv("HOME");
+		base = "%s/.cache/hsh/%016lx.hshc";
+	}
+	if (dir == NULL)
+		return (-1);
+	r = snprintf(out, size, base, dir, h);
+	return (r < 0 || (size_t)r >= size ? -1 : 0);
+}
+
+/**
+ * cache_mkdirs - creates the missing parent directories of a file
+ * @file: path of the file, restored before returning
+ * Return: 0 on success, -1 on failure
+ */
+int cache_mkdirs(char *file)
+{
+	char *p;
+
+	for (p = strchr(file + 1, '/'); p != NULL; p = strchr(p + 1, '/'))
+	{
+		*p = '\0';
+		if (mkdir(file, 0700) != 0 && errno != EEXIST)
+		{
+			*p = '/';
+			return (-1);
+		}
+		*p = '/';
+	}
+	return (0);
+}
+
+/**
+ * cbuf_node - serialises a node and its children in preorder
+ * @b: the buffer
+ * @n: the node
+ * Return: 0 on success, -1 on failure
+ *
+ * A record is type, flags, line, word count and kid count followed by one
+ * string offset per word.
+ */
+int cbuf_node(cbuf_t *b, node_t *n)
+{
+	int i;
+	long off;
+
+	if (cbuf_rec(b, n->type) || cbuf_rec(b, n->flags & ~NF_BORROWED) ||
+		cbuf_rec(b, n->line) || cbuf_rec(b, n->nwords) ||
+		cbuf_rec(b, n->nkids))
+		return (-1);
+	for (i = 0; i < n->nwords; i++)
+	{
+		off = cbuf_str(b, n->words[i]);
+		if (off < 0 || cbuf_rec(b, off) != 0)
+			return (-1);
+	}
+	for (i = 0; i < n->nkids; i++)
+		if (cbuf_node(b, n->kids[i]) != 0)
+			return (-1);
+	return (0);
+}
+
+/**
+ * cache_write - writes a compiled script and moves it into place
+ * @file: name of the compiled form
+ * @h: the header
+ * @key: resolved path of the script
+ * @index: record offset of each top level command
+ * @b: the serialised records and strings
+ * Return: 0 on success, -1 on failure
+ */
+int cache_write(char *file, cache_hdr_t *h, const char *key,
+unsigned int *index, cbuf_t *b)
+{
+	char tmp[PATH_MAX + 96], pad[4] = {0, 0, 0, 0};
+	struct iovec v[6];
+	ssize_t want;
+	int fd;
+
+	v[0].iov_base = h, v[0].iov_len = sizeof(*h);
+	v[1].iov_base = (char *)key, v[1].iov_len = h->path_len;
+	v[2].iov_base = pad, v[2].iov_len = (4 - h->path_len % 4) % 4;
+	v[3].iov_base = index, v[3].iov_len = h->ntop * sizeof(*index);
+	v[4].iov_base = b->recs, v[4].iov_len = b->nrecs * sizeof(*b->recs);
+	v[5].iov_base = b->strs, v[5].iov_len = b->slen;
+	want = v[0].iov_len + v[1].iov_len + v[2].iov_len + v[3].iov_len +
+		v[4].iov_len + v[5].iov_len;
+	snprintf(tmp, sizeof(tmp), "%s.%d", file, (int)getpid());
+	if (cache_mkdirs(file) != 0)
+		return (-1);
+	fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd < 0)
+		return (-1);
+	if (writev(fd, v, 6) != want || close(fd) != 0 ||
+		rename(tmp, file) != 0)
+	{
+		unlink(tmp);
+		return (-1);
+	}
+	return (0);
+}
+
+/**
+ * cache_store - writes the compiled form of a parsed script
+ * @path: path of the script
+ * @st: stat of the script at the time it was read
+ * @prog: the parsed script
+ * Return: 0 on success, -1 on failure
+ */
+int cache_store(const char *path, struct stat *st, node_t *prog)
+{
+	char key[PATH_MAX], file[PATH_MAX + 64];
+	cache_hdr_t h;
+	cbuf_t b;
+	unsigned int *index;
+	int i, r = -1;
+
+	if (realpath(path, key) == NULL ||
+		cache_file_name(key, file, sizeof(file)) != 0)
+		return (-1);
+	memset(&b, 0, sizeof(b));
+	index = malloc((prog->nkids + 1) * sizeof(*index));
+	for (i = 0; index != NULL && i < prog->nkids; i++)
+	{
+		index[i] = b.nrecs;
+		if (cbuf_node(&b, prog->kids[i]) != 0)
+			break;
+	}
+	if (index != NULL && i == prog->nkids)
+	{
+		memset(&h, 0, sizeof(h));
+		memcpy(h.magic, CACHE_MAGIC, 8);
+		strncpy(h.version, HSH_VERSION, sizeof(h.version));
+		h.size = st->st_size;
+		h.mtime_sec = st->st_mtim.tv_sec;
+		h.mtime_nsec = st->st_mtim.tv_nsec;
+		h.ctime_sec = st->st_ctim.tv_sec;
+		h.ctime_nsec = st->st_ctim.tv_nsec;
+		h.ino = st->st_ino;
+		h.dev = st->st_dev;
+		h.path_len = strlen(key);
+		h.ntop = prog->nkids;
+		h.nrecs = b.nrecs;
+		h.str_len = b.slen;
+		r = cache_write(file, &h, key, index, &b);
+	}
+	free(index);
+	cbuf_free(&b);
+	return (r);
+}
@@ -0,0 +1,73 @@
+#include "shell.h"
+
+/**
+ * cache_rec - rebuilds a node from its record
+ * @c: the mapped compiled script
+ * @pos: offset of the record, advanced past it and its children
+ * Return: the node, with words borrowed from the mapping, or NULL
+ */
+node_t *cache_rec(cache_t *c, unsigned int *pos)
+{
+	const unsigned int *r = c->recs + *pos;
+	node_t *n;
+	unsigned int i, nw, nk;
+
+	if (*pos > c->nrecs || c->nrecs - *pos < 5 ||
+		c->nrecs - *pos - 5 < r[3] || r[4] > c->nrecs)
+		return (NULL);
+	nw = r[3];
+	nk = r[4];
+	n = node_new(r[0], r[2]);
+	if (n == NULL)
+		return (NULL);
+	n->flags = r[1] | NF_BORROWED;
+	n->words = malloc((nw + 1) * sizeof(char *));
+	n->kids = malloc((nk + 1) * sizeof(node_t *));
+	for (i = 0; n->words != NULL && i < nw && r[5 + i] < c->str_len; i++)
+		n->words[i] = (char *)c->strs + r[5 + i];
+	if (n->words == NULL || n->kids == NULL || i != nw)
+	{
+		node_free(n);
+		return (NULL);
+	}
+	n->words[nw] = NULL;
+	n->nwords = nw;
+	*pos += 5 + nw;
+	for (n->kids[0] = NULL; n->nkids < (int)nk; n->kids[n->nkids] = NULL)
+	{
+		n->kids[n->nkids] = cache_rec(c, pos);
+		if (n->kids[n->nkids] == NULL)
+		{
+			node_free(n);
+			return (NULL);
+		}
+		n->nkids++;
+	}
+	return (n);
+}
+
+/**
+ * cache_node - materialises one top level command of a compiled script
+ * @c: the mapped compiled script
+ * @i: index of the command
+ * Return: the command, or NULL when the record is damaged
+ */
+node_t *cache_node(cache_t *c, unsigned int i)
+{
+	unsigned int pos;
+
+	if (i >= c->ntop)
+		return (NULL);
+	pos = c->index[i];
+	return (cache_rec(c, &pos));
+}
+
+/**
+ * cache_close - unmaps a compiled script
+ * @c: the mapped compiled script
+ */
+void cache_close(cache_t *c)
+{
+	munmap(c->map, c->len);
+	c->map = NULL;
+}
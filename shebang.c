@@ -0,0 +1,109 @@
+#include "shell.h"
+
+/**
+ * sb_self - finds the executable of the shell
+ * Return: its resolved path, "" when it cannot be found
+ */
+static const char *sb_self(void)
+{
+	static char self[PATH_MAX];
+	char *p;
+
+	if (self[0] == '\0' && (p = realpath("/proc/self/exe", NULL)) != NULL)
+	{
+		snprintf(self, sizeof(self), "%s", p);
+		free(p);
+	}
+	return (self);
+}
+
+/**
+ * sb_probe - reads the start of a file to see which shell it is for
+ * @path: the file
+ * Return: 1 when it is a script with no "#!" line, or one whose "#!"
+ * line names this shell, directly or through env; 0 otherwise
+ *
+ * A file with no "#!" line makes execve fail with ENOEXEC, after which a
+ * shell is meant to run it itself. Binaries, and files with a NUL byte in
+ * their first block, are left to execve.
+ */
+static int sb_probe(const char *path)
+{
+	char buf[256], *interp, *arg, *real;
+	const char *base;
+	ssize_t n = -1;
+	int fd, self;
+
+	fd = access(path, X_OK) == 0 ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+	if (fd >= 0)
+		n = read(fd, buf, sizeof(buf) - 1);
+	if (fd >= 0)
+		close(fd);
+	if (n < 0 || memchr(buf, '\0', n) != NULL)
+		return (0);
+	buf[n] = '\0';
+	if (n < 2 || buf[0] != '#' || buf[1] != '!')
+		return (1);
+	buf[2 + strcspn(buf + 2, "\n")] = '\0';
+	interp = buf + 2 + strspn(buf + 2, " \t");
+	arg = interp + strcspn(interp, " \t");
+	if (*arg != '\0')
+		*arg++ = '\0';
+	arg += strspn(arg, " \t");
+	n = strcspn(arg, " \t");
+	if (arg[n + strspn(arg + n, " \t")] != '\0')
+		return (0);
+	arg[n] = '\0';
+	base = strrchr(interp, '/');
+	if (base != NULL && strcmp(base, "/env") == 0 && *arg != '\0' &&
+		strchr(arg, '/') == NULL)
+	{
+		base = cmd_lookup(arg);
+		arg = "";
+	}
+	else
+		base = interp;
+	real = base != NULL && *arg == '\0' ? realpath(base, NULL) : NULL;
+	self = real != NULL && strcmp(real, sb_self()) == 0;
+	free(real);
+	return (self);
+}
+
+/**
+ * shebang_self - tells whether an external command is a script for this
+ * shell, which it can run without an exec
+ * @path: where the command was found
+ * Return: 1 if so, 0 otherwise
+ *
+ * The answer is cached per path, and used again as long as the file has
+ * the same inode and change time, so the file is only read again once it
+ * is modified, replaced or has its mode changed.
+ */
+int shebang_self(const char *path)
+{
+	struct stat st;
+	shebang_t *s;
+	hent_t *e;
+
+	if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+		return (0);
+	e = ht_find(&g_sh.shebangs, path);
+	s = e != NULL ? e->val : NULL;
+	if (s != NULL && s->dev == st.st_dev && s->ino == st.st_ino &&
+		s->ctime.tv_sec == st.st_ctim.tv_sec &&
+		s->ctime.tv_nsec == st.st_ctim.tv_nsec)
+		return (s->self);
+	if (s == NULL)
+	{
+		e = ht_insert(&g_sh.shebangs, path);
+		s = e != NULL ? calloc(1, sizeof(*s)) : NULL;
+		if (s == NULL)
+			return (sb_probe(path));
+		e->val = s;
+	}
+	s->dev = st.st_dev;
+	s->ino = st.st_ino;
+	s->ctime = st.st_ctim;
+	s->self = sb_probe(path);
+	return (s->self);
+}
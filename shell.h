@@ -1,6 +1,10 @@
 #ifndef SHELL_H
 #define SHELL_H
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -9,14 +13,1200 @@
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <time.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <stdint.h>
+#include <signal.h>
+#include <sched.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/sendfile.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <linux/futex.h>
+#include <ctype.h>
 
 #define MAX_LENGTH 1024
 
+#define HSH_VERSION "0.8.0"
+
+/* parse tree node types */
+#define N_CMD 1
+#define N_LIST 2
+#define N_FUNC 3
+#define N_SYNERR 4
+#define N_REDIR 5
+#define N_PIPE 6
+#define N_SUBSHELL 7
+#define N_WHILE 8
+
+/* token types */
+#define T_EOF 0
+#define T_WORD 1
+#define T_NEWLINE 2
+#define T_SEMI 3
+#define T_LPAREN 4
+#define T_RPAREN 5
+#define T_ERROR 6
+#define T_REDIR 7
+#define T_PIPE 8
+
+/* node flags */
+#define NF_BORROWED 0x1
+/* an N_REDIR here-document whose delimiter was quoted, so not expanded */
+#define NF_LITERAL 0x2
+
+/* most here-documents one line can start */
+#define HERE_MAX 16
+/* most redirections of one command */
+#define REDIR_MAX 16
+/* most variables a subshell run without a fork may assign */
+#define SUB_VARS 16
+/* expansion buffers kept for reuse, one per level of $(...) nesting */
+#define XFREE_MAX 4
+
+/* how the read builtin takes its input, see rbuf_s */
+#define RB_BYTE 0
+#define RB_SEEK 1
+#define RB_OWNED 2
+/* bytes the read builtin asks for at once when it may read ahead */
+#define RB_BLOCK (1 << 16)
+/* most nested loops whose input pipe read may read ahead on */
+#define RB_OWN_MAX 8
+
+/* slots of the lookup cache shared by the scripts of -j, a power of two */
+#define JC_SLOTS 1024
+/* slots looked at for a command before the shared cache gives up */
+#define JC_PROBE 16
+/* longest command name and path the shared cache holds, NUL included */
+#define JC_NAME 64
+#define JC_PATH 256
+
+/* most top level commands --lookahead may work ahead on */
+#define AHEAD_MAX 64
+
+/* most coprocesses running at once */
+#define COPROC_MAX 8
+/* time a coprocess gets to exit once its input is closed, in ms */
+#define COPROC_GRACE_MS 1000
+
+#define CACHE_MAGIC "HSHC0002"
+/* magic of a startup snapshot, stored in the same container */
+#define SNAP_MAGIC "HSHS0002"
+/* string offset of a snapshot record that has no value */
+#define SNAP_NONE 0xffffffffU
+
+/* expansion field flags */
+#define XF_GLOB 0x1
+#define XF_ESC 0x2
+
+/* compiled glob pattern operations */
+#define G_LIT 0
+#define G_ANY 1
+#define G_STAR 2
+#define G_SET 3
+#define GLOB_DIRBUF (1 << 18)
+
+/* names completed in command position besides those found in PATH */
+#define BUILTINS "alias:batch:cd:coproc:env:exit:export:hash:limit:place:printf:pwd:read:return:stats:timeout:unalias:unset"
+
+/* most candidates listed by tab completion */
+#define LE_MAXLIST 256
+
+/* resource limits of the limit builtin */
+#define LIM_MEM 0x1
+#define LIM_CPU 0x2
+#define LIM_PIDS 0x4
+#define LIM_IO 0x8
+
+/* settings of the place builtin */
+#define PL_CPUS 0x1
+#define PL_MEM 0x2
+#define PL_NICE 0x4
+#define PL_IO 0x8
+#define PL_SCHED 0x10
+
+/* memory policies of set_mempolicy, which has no libc header */
+#define MPOL_PREFERRED 1
+#define MPOL_BIND 2
+#define MPOL_INTERLEAVE 3
+
+/* stats histograms: 1 << STATS_SUB_BITS buckets per power of two, in us */
+#define STATS_SUB_BITS 4
+#define STATS_BUCKETS 608
+/* most distinct commands stats keeps apart; later ones share a line */
+#define STATS_MAX 512
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
+#ifndef CLONE_INTO_CGROUP
+#define CLONE_INTO_CGROUP 0x200000000UL
+#endif
+
+/* the history search index hashes trigrams into 1 << HX_BITS lists */
+#define HX_BITS 16
+
 #define UNUSED(x) (void)(x)
 
+#define METRICS_MAGIC "HSHM0001"
+/* --trace-events writes its buffer out once it holds this many bytes */
+#define TRACE_CHUNK (1 << 20)
+/* --record writes its buffer out once it holds this many bytes */
+#define REC_CHUNK (1 << 16)
+/* what rec_s does: write a --record file, or run a --replay */
+#define REC_RECORD 1
+#define REC_REPLAY 2
+/* stages --record and --replay time each command in, see rec_stage */
+#define REC_INPUT 0
+#define REC_PARSE 1
+#define REC_EXPAND 2
+#define REC_DISPATCH 3
+#define REC_LOOKUP 4
+#define REC_EXEC 5
+#define REC_STAGES 6
+/* charges the time so far to the stage left and enters stage @s */
+#define REC_STAGE(s) (g_sh.rec.on ? rec_stage(s) : 0)
+/* size of the --audit ring buffer, a power of two */
+#define AUDIT_RING (1 << 20)
+/* bumps a counter of the --metrics block, if there is one */
+#define METRIC_ADD(f, n) ((void)(g_sh.metrics != NULL && \
+	__atomic_fetch_add(&g_sh.metrics->f, (n), __ATOMIC_RELAXED)))
+
 extern char **environ;
 
-int execute_command(char *args[], const char *shell_name, int command_count);
+/**
+ * struct node_s - a node of the parsed script tree
+ * @type: one of the N_* node types
+ * @flags: NF_* flags; NF_BORROWED words point into a mapped cache
+ * @line: line number the node starts on
+ * @nwords: number of words
+ * @words: NULL terminated array of words
+ * @nkids: number of child nodes
+ * @kids: NULL terminated array of child nodes
+ */
+typedef struct node_s
+{
+	int type;
+	int flags;
+	int line;
+	int nwords;
+	char **words;
+	int nkids;
+	struct node_s **kids;
+} node_t;
+
+/**
+ * struct wbuf_s - growable byte buffer
+ * @s: the bytes, kept NUL terminated
+ * @len: number of bytes used
+ * @cap: allocated size of @s
+ */
+typedef struct wbuf_s
+{
+	char *s;
+	size_t len;
+	size_t cap;
+} wbuf_t;
+
+/**
+ * struct source_s - where the lexer reads its characters from
+ * @buf: the text being read
+ * @len: length of @buf
+ * @pos: read position in @buf
+ * @fp: stream @buf is refilled from line by line, NULL for a fixed buffer
+ * @line: getline buffer used when reading from @fp
+ * @cap: size of @line
+ * @lineno: current line number
+ * @ps: prompt printed before the next refill, NULL for none
+ * @edit: nonzero to read lines from the terminal with the line editor
+ * @rec: when not NULL, receives every line read, for the history
+ */
+typedef struct source_s
+{
+	const char *buf;
+	size_t len;
+	size_t pos;
+	FILE *fp;
+	char *line;
+	size_t cap;
+	int lineno;
+	const char *ps;
+	int edit;
+	wbuf_t *rec;
+} source_t;
+
+/**
+ * struct token_s - a lexical token
+ * @type: one of the T_* token types
+ * @word: malloc'd text of a T_WORD, or error message of a T_ERROR
+ * @line: line the token starts on
+ */
+typedef struct token_s
+{
+	int type;
+	char *word;
+	int line;
+} token_t;
+
+/**
+ * struct parser_s - parser state
+ * @src: the source being parsed
+ * @tok: the lookahead token
+ * @have: whether @tok holds an unconsumed token
+ * @err: syntax error message, NULL while parsing succeeds
+ * @here: N_REDIR here-documents whose bodies start after the next newline
+ * @nhere: number of @here
+ */
+typedef struct parser_s
+{
+	source_t *src;
+	token_t tok;
+	int have;
+	char *err;
+	node_t *here[HERE_MAX];
+	int nhere;
+} parser_t;
+
+/**
+ * struct hent_s - hash table entry
+ * @key: malloc'd key
+ * @val: value owned by the table's user
+ * @hash: hash of @key
+ * @next: next entry in the bucket
+ */
+typedef struct hent_s
+{
+	char *key;
+	void *val;
+	unsigned int hash;
+	struct hent_s *next;
+} hent_t;
+
+/**
+ * struct htab_s - chained hash table keyed by strings
+ * @b: buckets, a power of two of them
+ * @nb: number of buckets
+ * @n: number of entries
+ */
+typedef struct htab_s
+{
+	hent_t **b;
+	unsigned int nb;
+	unsigned int n;
+} htab_t;
+
+/**
+ * struct alias_s - an alias, split into words when it is defined
+ * @value: the value as given to alias
+ * @nwords: number of words in @words
+ * @words: the value split into words with quotes removed
+ */
+typedef struct alias_s
+{
+	char *value;
+	int nwords;
+	char **words;
+} alias_t;
+
+/**
+ * struct shfunc_s - a shell function
+ * @body: the parsed body
+ * @refs: number of calls currently running the body
+ * @dead: set when the function was redefined or unset while running
+ */
+typedef struct shfunc_s
+{
+	node_t *body;
+	int refs;
+	int dead;
+} shfunc_t;
+
+/**
+ * struct var_s - a shell variable
+ * @value: malloc'd value
+ * @exported: whether the variable is in the environment of commands
+ */
+typedef struct var_s
+{
+	char *value;
+	int exported;
+} var_t;
+
+/**
+ * struct expand_s - per-command expansion buffer
+ * @buf: bytes of every field, each NUL terminated
+ * @offs: offset in @buf where each field starts
+ * @fflags: XF_* flags of each field
+ * @nfields: number of fields
+ * @fcap: capacity of @offs and @fflags
+ * @outs: offsets of the fields left after pathname expansion
+ * @ocap: capacity of @outs
+ * @argv: NULL terminated field pointers, built once expansion is done
+ * @acap: capacity of @argv
+ * @open: whether a field is being written
+ * @quoted: whether the current word had quotes, so it yields a field
+ * @emptyat: set by an empty "$@", so its closing quote adds no field
+ * @inparam: depth of ${...} words being expanded
+ * @nosplit: set while expanding assignment values, which are not split
+ * @here: set while expanding a here-document, where quotes are literal
+ * @subst: exit status of the last command substitution, -1 if none ran
+ * @err: set when an expansion error cancels the command
+ * @status: value of $?
+ * @line: line number for diagnostics
+ * @shell_name: name of the shell for diagnostics
+ * @ifs: nonzero for each byte in $IFS, 2 for IFS white space
+ * @ifs0: first byte of $IFS, joining "$*"
+ */
+typedef struct expand_s
+{
+	wbuf_t buf;
+	size_t *offs;
+	unsigned char *fflags;
+	int nfields;
+	int fcap;
+	size_t *outs;
+	int ocap;
+	char **argv;
+	int acap;
+	int open;
+	int quoted;
+	int emptyat;
+	int inparam;
+	int nosplit;
+	int here;
+	int subst;
+	int err;
+	int status;
+	int line;
+	const char *shell_name;
+	unsigned char ifs[256];
+	int ifs0;
+} expand_t;
+
+/**
+ * struct gop_s - one operation of a compiled glob pattern
+ * @type: one of the G_* operations
+ * @c: the byte matched by a G_LIT
+ * @set: bitmap of the bytes matched by a G_SET
+ */
+typedef struct gop_s
+{
+	unsigned char type;
+	unsigned char c;
+	unsigned char set[32];
+} gop_t;
+
+/**
+ * struct dirlist_s - cached listing of a directory
+ * @ents: entries back to back, each a d_type byte then a NUL terminated name
+ * @len: bytes used in @ents
+ * @dev: device of the directory
+ * @ino: inode of the directory
+ * @mtim: modification time the listing was taken at
+ * @ctim: change time the listing was taken at
+ * @racy: nonzero when the directory changed too recently for its times to
+ * tell later changes apart, so the listing must not be reused
+ */
+typedef struct dirlist_s
+{
+	char *ents;
+	size_t len;
+	dev_t dev;
+	ino_t ino;
+	struct timespec mtim;
+	struct timespec ctim;
+	int racy;
+} dirlist_t;
+
+/**
+ * struct gwalk_s - state of one pathname expansion
+ * @ncomps: number of path components in the pattern
+ * @comps: the components, still escaped
+ * @ops: compiled operations of each component
+ * @nops: number of operations of each component, -1 for a literal one
+ * @path: path being built
+ * @out: matches, NUL terminated back to back
+ * @nout: number of matches
+ */
+typedef struct gwalk_s
+{
+	int ncomps;
+	char **comps;
+	gop_t **ops;
+	int *nops;
+	wbuf_t path;
+	wbuf_t out;
+	int nout;
+} gwalk_t;
+
+/**
+ * struct lined_s - state of the line editor while a line is read
+ * @b: the line, kept NUL terminated
+ * @pos: cursor position in @b
+ * @ps: the prompt
+ * @plen: width of the prompt
+ * @cols: width of the terminal
+ * @hidx: how far back the history entry shown is, 0 for the line being
+ * edited
+ * @saved: the line being edited while history entries are shown
+ * @tabs: number of consecutive tab presses
+ */
+typedef struct lined_s
+{
+	wbuf_t b;
+	size_t pos;
+	const char *ps;
+	size_t plen;
+	int cols;
+	int hidx;
+	char *saved;
+	int tabs;
+} lined_t;
+
+/**
+ * struct tnode_s - node of the completion trie
+ * @kid: first child, -1 for none
+ * @next: next sibling in byte order, -1 for none
+ * @nterm: number of sources providing the name that ends here
+ * @nsub: sum of @nterm over the subtree, 0 for a dead subtree
+ * @c: the byte leading to this node
+ */
+typedef struct tnode_s
+{
+	int kid;
+	int next;
+	int nterm;
+	int nsub;
+	unsigned char c;
+} tnode_t;
+
+/**
+ * struct trie_s - prefix trie of command names, node 0 is the root
+ * @n: the nodes
+ * @len: number of nodes
+ * @cap: capacity of @n
+ *
+ * Names are never unlinked; removing one only lowers the counts, so a
+ * name coming back reuses its nodes.
+ */
+typedef struct trie_s
+{
+	tnode_t *n;
+	int len;
+	int cap;
+} trie_t;
+
+/**
+ * struct compdir_s - a PATH directory feeding the completion trie
+ * @path: the directory
+ * @ls: executables found there, in the dir_list layout, with the times
+ * of the directory when it was scanned
+ */
+typedef struct compdir_s
+{
+	char *path;
+	dirlist_t ls;
+} compdir_t;
+
+/**
+ * struct cands_s - completion candidates
+ * @text: the candidates, NUL terminated back to back
+ * @n: number of candidates in @text
+ * @more: nonzero when there were too many to collect
+ * @skip: leading bytes of each candidate not shown in listings
+ * @lcp: malloc'd longest common prefix of all candidates
+ * @unique: nonzero when exactly one name matches
+ */
+typedef struct cands_s
+{
+	wbuf_t text;
+	int n;
+	int more;
+	size_t skip;
+	char *lcp;
+	int unique;
+} cands_t;
+
+/**
+ * struct hpost_s - posting list of the history search index
+ * @d: record numbers as varint deltas, oldest first
+ * @len: bytes used in @d
+ * @cap: size of @d
+ * @last: last record number added plus one, 0 when empty
+ * @n: number of records in the list
+ */
+typedef struct hpost_s
+{
+	unsigned char *d;
+	unsigned int len;
+	unsigned int cap;
+	unsigned int last;
+	unsigned int n;
+} hpost_t;
+
+/**
+ * struct hist_s - the history file, shared with other shells
+ * @state: 0 until the file is opened, 1 once open, -1 if it cannot be
+ * @fd: the file, opened for appending
+ * @map: read-only mapping of the file
+ * @maplen: length of @map
+ * @size: bytes of complete records found so far
+ * @recs: offset of each record, oldest first
+ * @nrecs: number of records
+ * @rcap: capacity of @recs
+ * @ix: trigram posting lists, NULL until the first search
+ * @nix: number of records in @ix
+ * @text: buffer for the decoded command handed out by hist_text
+ *
+ * Each record is one line, "time;duration_ms;status;command", with
+ * newlines and backslashes in the command escaped, written with a single
+ * write on an O_APPEND descriptor so records from concurrent shells
+ * never interleave.
+ */
+typedef struct hist_s
+{
+	int state;
+	int fd;
+	char *map;
+	size_t maplen;
+	size_t size;
+	size_t *recs;
+	unsigned int nrecs;
+	unsigned int rcap;
+	hpost_t *ix;
+	unsigned int nix;
+	wbuf_t text;
+} hist_t;
+
+/**
+ * struct spawn_s - how external commands are to be started
+ * @lim: LIM_* bits of the limits requested
+ * @mem: memory limit in bytes
+ * @cpu_weight: CPU weight, 1 to 10000 with 100 the default
+ * @pids: most processes
+ * @io_weight: I/O weight, 1 to 10000 with 100 the default
+ * @fallback: LIM_* bits the cgroup could not enforce, applied with
+ * rlimits, nice and ionice in the child instead
+ * @cgroup: malloc'd path of the cgroup leaf children start in, or NULL
+ * @cgfd: the @cgroup directory, when @cgroup is set
+ * @maxrss: largest resident set of the children waited for, in KiB
+ * @cpu_us: CPU time of the children waited for, in microseconds
+ * @place: PL_* bits of the placement requested
+ * @cpus: CPUs the child may run on
+ * @nodes: NUMA nodes the memory policy names
+ * @mpol: MPOL_* memory policy
+ * @nice: nice value
+ * @ioprio: I/O priority, class and level as for ioprio_set
+ * @policy: SCHED_* scheduling policy
+ * @timeout_ms: time the child may run, 0 for no limit
+ * @kill_ms: time from the timeout signal to SIGKILL, 0 for never
+ * @tsig: signal sent when @timeout_ms runs out
+ * @rr: 1 when place -r rotates over CPUs, 2 over nodes, 0 when it does not
+ * @rrbase: the placement place -r picked from, for place_next
+ */
+typedef struct spawn_s
+{
+	int lim;
+	long mem;
+	int cpu_weight;
+	long pids;
+	int io_weight;
+	int fallback;
+	char *cgroup;
+	int cgfd;
+	long maxrss;
+	long cpu_us;
+	int place;
+	cpu_set_t cpus;
+	cpu_set_t nodes;
+	int mpol;
+	int nice;
+	int ioprio;
+	int policy;
+	long timeout_ms;
+	long kill_ms;
+	int tsig;
+	int rr;
+	const struct spawn_s *rrbase;
+} spawn_t;
+
+/**
+ * struct redir_s - the redirections of the command being run
+ * @n: number of redirections
+ * @fd: descriptor each one redirects
+ * @src: descriptor it becomes a copy of, -1 to close it
+ * @save: copy of the original @fd while applied in the shell, or -1
+ * @own: bit i set when @src[i] was opened for the command and must be
+ * closed after it
+ *
+ * An external command gets them applied in the child, after the fork;
+ * builtins and functions get them applied around their run.
+ */
+typedef struct redir_s
+{
+	int n;
+	int fd[REDIR_MAX];
+	int src[REDIR_MAX];
+	int save[REDIR_MAX];
+	unsigned int own;
+} redir_t;
+
+/**
+ * struct batch_s - state of the batch builtin
+ * @path: where the command was found
+ * @argv: the command and its fixed arguments, then the items of a batch
+ * @nfixed: number of fixed words at the start of @argv
+ * @items: the items of the batch being filled, each NUL terminated
+ * @offs: offset of each item in @items
+ * @n: number of items in the batch
+ * @cap: room in @offs and in @argv past @nfixed
+ * @room: bytes of arguments each command line may take
+ * @used: bytes the items of the batch take
+ * @jobs: batches running
+ * @njobs: number of @jobs
+ * @maxjobs: most batches run at once, from -P
+ * @status: 0 while every batch succeeded, otherwise as for xargs
+ * @timed: what spawn_watch returned for the batch waited for next
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ */
+typedef struct batch_s
+{
+	const char *path;
+	char **argv;
+	int nfixed;
+	wbuf_t items;
+	size_t *offs;
+	int n;
+	int cap;
+	size_t room;
+	size_t used;
+	pid_t *jobs;
+	int njobs;
+	int maxjobs;
+	int status;
+	int timed;
+	const char *shell_name;
+	int line;
+} batch_t;
+
+/**
+ * struct cstat_s - timings of one command, for the stats builtin
+ * @count: number of runs
+ * @fails: number of runs with a nonzero status
+ * @total_us: wall time of every run, in microseconds
+ * @max_us: longest run
+ * @hist: log-linear histogram of the run times, see stats_bucket
+ */
+typedef struct cstat_s
+{
+	unsigned long count;
+	unsigned long fails;
+	unsigned long total_us;
+	unsigned long max_us;
+	unsigned int hist[STATS_BUCKETS];
+} cstat_t;
+
+/**
+ * struct clone3_s - arguments of the clone3 system call
+ * @flags: CLONE_* flags
+ * @pidfd: where to store a pidfd of the child
+ * @child_tid: where to store the child TID in the child
+ * @parent_tid: where to store the child TID in the parent
+ * @exit_signal: signal sent to the parent when the child exits
+ * @stack: lowest address of the child stack, 0 to share the stack
+ * @stack_size: size of @stack
+ * @tls: thread local storage of the child
+ * @set_tid: TIDs to give the child
+ * @set_tid_size: number of @set_tid
+ * @cgroup: cgroup directory the child starts in, with CLONE_INTO_CGROUP
+ */
+typedef struct clone3_s
+{
+	uint64_t flags;
+	uint64_t pidfd;
+	uint64_t child_tid;
+	uint64_t parent_tid;
+	uint64_t exit_signal;
+	uint64_t stack;
+	uint64_t stack_size;
+	uint64_t tls;
+	uint64_t set_tid;
+	uint64_t set_tid_size;
+	uint64_t cgroup;
+} clone3_t;
+
+/**
+ * struct metrics_s - counters shared with monitoring tools by --metrics
+ * @magic: METRICS_MAGIC
+ * @size: size of the block, so readers can check its layout
+ * @pid: process id of the shell
+ * @started: commands started
+ * @finished: commands that returned to the shell
+ * @failed: commands that finished with a nonzero status
+ * @builtins: commands run by the shell itself
+ * @externals: external commands started
+ * @spawn_ns: time spent creating children, in nanoseconds
+ * @wait_ns: time spent waiting for children
+ * @jobs: children currently running
+ * @lookups: PATH searches asked of the lookup cache
+ * @hits: lookups the cache answered
+ *
+ * Every counter is updated with relaxed atomics and read the same way.
+ */
+typedef struct metrics_s
+{
+	char magic[8];
+	uint32_t size;
+	int32_t pid;
+	uint64_t started;
+	uint64_t finished;
+	uint64_t failed;
+	uint64_t builtins;
+	uint64_t externals;
+	uint64_t spawn_ns;
+	uint64_t wait_ns;
+	int64_t jobs;
+	uint64_t lookups;
+	uint64_t hits;
+} metrics_t;
+
+/**
+ * struct trace_s - the event buffer of --trace-events
+ * @fd: the trace file
+ * @pid: process that owns the buffer; forked children never flush it
+ * @n: number of events written so far
+ * @buf: events not yet written
+ */
+typedef struct trace_s
+{
+	int fd;
+	pid_t pid;
+	unsigned long n;
+	wbuf_t buf;
+} trace_t;
+
+/**
+ * struct audit_s - the --audit log and the ring feeding its writer thread
+ * @on: set once the writer runs
+ * @fd: the log file
+ * @pid: process that owns the writer
+ * @direct: set in forked children of the shell, which have no writer and
+ * append each record to @fd with a single write
+ * @block: whether a full ring makes the shell wait rather than drop
+ * @thread: the writer
+ * @ring: AUDIT_RING bytes of JSON lines
+ * @head: bytes ever put in the ring, only advanced by the shell
+ * @tail: bytes ever written out, only advanced by the writer
+ * @wake: futex the writer sleeps on
+ * @space: futex bumped by the writer whenever it frees room
+ * @blocked: set while the shell waits on @space
+ * @stop: tells the writer to drain the ring and exit
+ * @dropped: records lost to a full ring
+ * @rec: the record being built
+ * @cwd: working directory of the shell, kept up to date by cd
+ *
+ * There is one producer and one consumer, so the ring needs no lock. The
+ * shell only makes a system call to wake the writer when it fills the
+ * ring past half; otherwise the writer polls a few times a second.
+ */
+typedef struct audit_s
+{
+	int on;
+	int fd;
+	pid_t pid;
+	int direct;
+	int block;
+	pthread_t thread;
+	char *ring;
+	unsigned long head;
+	unsigned long tail;
+	int wake;
+	int space;
+	int blocked;
+	int stop;
+	unsigned long dropped;
+	wbuf_t rec;
+	char cwd[PATH_MAX];
+} audit_t;
+
+/**
+ * struct rec_s - a --record file being written, or a --replay running
+ * @on: 0, REC_RECORD or REC_REPLAY
+ * @fd: the record file
+ * @pid: process that owns the recording; forked children write their
+ * records out directly and leave the totals to it
+ * @fed: set once the input of the shell has been recorded, and until
+ * the shell is about to read it
+ * @buf: records not yet written
+ * @stage: the stage the time since @t goes to, a REC_* stage
+ * @t: when the shell last changed stage, in nanoseconds
+ * @ns: time spent in each stage
+ * @ncmd: simple commands run
+ * @rns: time the recording spent in each stage
+ * @rcmd: simple commands the recording ran
+ * @miss: commands run by the replay that the recording never ran
+ * @diff: commands that resolved to another path or ended with another
+ * status than in the recording
+ * @cmds: "status<TAB>path" of each command recorded, by its arguments
+ * as written to the record file
+ * @subs: "status<TAB>output" of each run of a command substitution, by
+ * "o<TAB>run<TAB>text", and how many runs of each text were seen so far
+ * @depth: command substitutions being run and recorded
+ * @text: the input to replay
+ * @mode: how the recording read it: 's' from a script, 'c' from a -c
+ * string, 'i' from standard input
+ * @argv: malloc'd $0 and positional parameters of the recording
+ * @argc: number of @argv
+ * @exec: what --replay-exec runs in place of every external command, NULL
+ * to run nothing
+ */
+typedef struct rec_s
+{
+	int on;
+	int fd;
+	pid_t pid;
+	int fed;
+	wbuf_t buf;
+	int stage;
+	uint64_t t;
+	uint64_t ns[REC_STAGES];
+	unsigned long ncmd;
+	uint64_t rns[REC_STAGES];
+	unsigned long rcmd;
+	unsigned long miss;
+	unsigned long diff;
+	htab_t cmds;
+	htab_t subs;
+	int depth;
+	wbuf_t text;
+	int mode;
+	char **argv;
+	int argc;
+	const char *exec;
+} rec_t;
+
+/**
+ * struct jcent_s - a slot of the lookup cache the scripts of -j share
+ * @state: 0 while free, 1 while a script fills it, 2 once it is ready;
+ * nothing else in a slot changes after that
+ * @hash: hash of @name
+ * @pathhash: hash of the value of PATH @path was found with
+ * @name: the command
+ * @path: where it was found
+ */
+typedef struct jcent_s
+{
+	unsigned int state;
+	unsigned int hash;
+	unsigned int pathhash;
+	char name[JC_NAME];
+	char path[JC_PATH];
+} jcent_t;
+
+/**
+ * struct job_s - a script run by -j
+ * @pid: the forked shell running it, 0 once reaped
+ * @out: memfd collecting its standard output
+ * @err: memfd collecting its standard error
+ * @status: its exit status
+ */
+typedef struct job_s
+{
+	pid_t pid;
+	int out;
+	int err;
+	int status;
+} job_t;
+
+/**
+ * struct ahead_s - the --lookahead stage of a script
+ * @lines: number of top level commands to work ahead on, 0 when off
+ * @kids: top level commands of the script running, NULL when compiled
+ * @c: the compiled form of the script running, NULL when parsed
+ * @n: number of top level commands
+ * @next: first top level command not started yet
+ * @done: first top level command not looked at yet
+ * @ph: hash of the value of PATH commands were looked up with
+ * @sig: the state of the PATH directories when they were
+ * @added: set while the lookup cache holds commands looked up ahead that
+ * have not all been started yet
+ * @until: the top level command after the last one of those
+ * @seen: binaries already prefetched, with NULL values
+ */
+typedef struct ahead_s
+{
+	int lines;
+	node_t **kids;
+	struct cache_s *c;
+	unsigned int n;
+	unsigned int next;
+	unsigned int done;
+	unsigned int ph;
+	unsigned long sig;
+	int added;
+	unsigned int until;
+	htab_t seen;
+} ahead_t;
+
+/**
+ * struct rbuf_s - input the read builtin took ahead of the line it wanted
+ * @buf: RB_BLOCK bytes, allocated on first use
+ * @pos: first byte not handed out yet
+ * @len: bytes in @buf
+ * @mode: how standard input is read: one byte at a time, RB_BYTE, as
+ * any other process may read it next; in blocks with the rest given back
+ * by lseek, RB_SEEK; or in blocks kept here, RB_OWNED, for a pipe only a
+ * loop of the shell reads
+ * @checked: set while @mode is known to still describe standard input
+ * @dev: device of the file @buf was read from
+ * @ino: inode of the file @buf was read from
+ * @nown: number of @own_dev and @own_ino
+ * @own_dev: device of each pipe that qualifies for RB_OWNED
+ * @own_ino: inode of each such pipe
+ * @synced: set once read_sync is registered to run at exit
+ */
+typedef struct rbuf_s
+{
+	char *buf;
+	size_t pos;
+	size_t len;
+	int mode;
+	int checked;
+	dev_t dev;
+	ino_t ino;
+	int nown;
+	dev_t own_dev[RB_OWN_MAX];
+	ino_t own_ino[RB_OWN_MAX];
+	int synced;
+} rbuf_t;
+
+/**
+ * struct coproc_s - a coprocess started by the coproc builtin
+ * @name: malloc'd NAME it was started as
+ * @pid: the child
+ * @owner: process of the shell that started it and has to reap it
+ * @rfd: descriptor reading its standard output, $NAME_R
+ * @wfd: descriptor writing its standard input, $NAME_W
+ */
+typedef struct coproc_s
+{
+	char *name;
+	pid_t pid;
+	pid_t owner;
+	int rfd;
+	int wfd;
+} coproc_t;
+
+/**
+ * struct shebang_s - what the start of an external command showed
+ * @dev: device of the file
+ * @ino: inode of the file
+ * @ctime: change time of the file, which any write or chmod updates
+ * @self: whether it is a script for this shell, see shebang_self
+ */
+typedef struct shebang_s
+{
+	dev_t dev;
+	ino_t ino;
+	struct timespec ctime;
+	int self;
+} shebang_t;
+
+/**
+ * struct state_s - interpreter state shared by the executor and builtins
+ * @arg0: $0
+ * @nparams: number of positional parameters
+ * @params: NULL terminated positional parameters $1, $2, ...
+ * @funcnest: depth of running function calls
+ * @returning: set by return until the function call unwinds
+ * @pid: process id of the shell, $$
+ * @xfree: expansion buffers kept for reuse by later commands
+ * @nxfree: number of @xfree
+ * @hist: the command history
+ * @spawn: settings of the prefix builtins for the next external command
+ * @tail: set while running the last command of a script or -c string,
+ * after which the shell exits; an external command then replaces the
+ * shell instead of being forked
+ * @vars: the shell variables, var_t values
+ * @aliases: the aliases, alias_t values
+ * @funcs: the shell functions, shfunc_t values
+ * @cmds: the command lookup cache, full paths of commands found in PATH
+ * @cmdpath: malloc'd value of PATH the entries of @cmds were found with
+ * @jcache: JC_SLOTS slots of lookup cache shared by the scripts of -j,
+ * NULL without -j
+ * @shebangs: shebang_t values of the external commands run, by path
+ * @snap: 1 while an rc file runs and its effects can be snapshotted, -1
+ * once it did something a snapshot cannot reproduce, 0 otherwise
+ * @profile: set by --startup-profile
+ * @stats: timings of the commands run so far, cstat_t values
+ * @metrics: the shared block of --metrics, NULL without one
+ * @trace: the event buffer of --trace-events, NULL without one
+ * @audit: the --audit log
+ * @rec: the --record file, or the recording --replay runs
+ * @ahead: the --lookahead stage
+ * @spawned: path of the external command the running simple command
+ * started, NULL if it started none
+ * @redir: redirections still to be applied to the command being run
+ * @subfd: memfd builtins write into when run by a command substitution,
+ * kept open for the next one; 0 when there is none
+ * @subout: output of the command substitution being expanded
+ * @rbuf: input the read builtin took ahead
+ * @coproc: the coprocesses running
+ * @ncoproc: number of @coproc
+ * @interactive: set while the shell reads commands from a terminal
+ */
+typedef struct state_s
+{
+	char *arg0;
+	int nparams;
+	char **params;
+	int funcnest;
+	int returning;
+	pid_t pid;
+	expand_t *xfree[XFREE_MAX];
+	int nxfree;
+	hist_t hist;
+	spawn_t spawn;
+	int tail;
+	htab_t vars;
+	htab_t aliases;
+	htab_t funcs;
+	htab_t cmds;
+	char *cmdpath;
+	jcent_t *jcache;
+	htab_t shebangs;
+	int snap;
+	int profile;
+	htab_t stats;
+	metrics_t *metrics;
+	trace_t *trace;
+	audit_t audit;
+	rec_t rec;
+	ahead_t ahead;
+	const char *spawned;
+	redir_t *redir;
+	int subfd;
+	wbuf_t subout;
+	rbuf_t rbuf;
+	coproc_t coproc[COPROC_MAX];
+	int ncoproc;
+	int interactive;
+} state_t;
+
+extern state_t g_sh;
+
+/**
+ * struct builtin_s - a builtin command
+ * @name: its name
+ * @fn: the handler, for builtins that only need their arguments
+ * @run: the handler, for builtins that run a command or need the status
+ */
+typedef struct builtin_s
+{
+	const char *name;
+	int (*fn)(char *args[], const char *shell_name, int command_count);
+	int (*run)(char *args[], const char *shell_name, int command_count,
+		int status, char *input);
+} builtin_t;
+
+/**
+ * struct cache_hdr_s - header of an on-disk compiled script
+ * @magic: CACHE_MAGIC, also encodes the record format
+ * @version: HSH_VERSION of the shell that wrote the file
+ * @size: size of the script when it was compiled
+ * @mtime_sec: mtime seconds of the script
+ * @mtime_nsec: mtime nanoseconds of the script
+ * @ctime_sec: ctime seconds of the script, which catches edits that put
+ * the mtime back
+ * @ctime_nsec: ctime nanoseconds of the script
+ * @ino: inode of the script
+ * @dev: device of the script
+ * @path_len: length of the script path following the header
+ * @ntop: number of top level commands in the index
+ * @nrecs: number of 32-bit words in the record area
+ * @str_len: size of the string area
+ */
+typedef struct cache_hdr_s
+{
+	char magic[8];
+	char version[16];
+	unsigned long size;
+	long mtime_sec;
+	long mtime_nsec;
+	long ctime_sec;
+	long ctime_nsec;
+	unsigned long ino;
+	unsigned long dev;
+	unsigned int path_len;
+	unsigned int ntop;
+	unsigned int nrecs;
+	unsigned int str_len;
+} cache_hdr_t;
+
+/**
+ * struct cache_s - a mapped compiled script
+ * @map: start of the mapping
+ * @len: length of the mapping
+ * @ntop: number of top level commands
+ * @index: record offset of each top level command
+ * @recs: the record area
+ * @nrecs: number of 32-bit words in @recs
+ * @strs: the string area
+ * @str_len: size of @strs
+ */
+typedef struct cache_s
+{
+	void *map;
+	size_t len;
+	unsigned int ntop;
+	const unsigned int *index;
+	const unsigned int *recs;
+	unsigned int nrecs;
+	const char *strs;
+	unsigned int str_len;
+} cache_t;
+
+/**
+ * struct cbuf_s - buffer a compiled script is serialised into
+ * @recs: the record area
+ * @nrecs: number of 32-bit words used in @recs
+ * @rcap: capacity of @recs
+ * @strs: the string area, every string stored once
+ * @slen: bytes used in @strs
+ * @scap: capacity of @strs
+ * @hash: open addressing table of string offsets plus one
+ * @hcap: number of slots in @hash, a power of two
+ * @hused: number of used slots in @hash
+ */
+typedef struct cbuf_s
+{
+	unsigned int *recs;
+	unsigned int nrecs;
+	unsigned int rcap;
+	char *strs;
+	unsigned int slen;
+	unsigned int scap;
+	unsigned int *hash;
+	unsigned int hcap;
+	unsigned int hused;
+} cbuf_t;
+
+int execute_command(const char *path, char *args[], const char *shell_name,
+int command_count);
 int search_n_exec_cmd(char *args[], const char *shell_name, int command_count);
 int handle_env(const char *shell_name, int command_count);
 int exiT(char *args[], const char *shell_name, int command_count,
@@ -30,5 +1220,268 @@ int fork_strtok(char *input);
 int _print(const char *str);
 size_t _strlen(const char *str);
 int check_for_non_digit(const char *str);
+size_t name_len(const char *str, const char *end);
+int is_name(const char *str);
+
+node_t *node_new(int type, int line);
+int node_add_word(node_t *n, char *word);
+int node_add_kid(node_t *n, node_t *kid);
+void node_free(node_t *n);
+node_t *node_copy(node_t *n);
+const char *node_name(node_t *n);
+int wbuf_grow(wbuf_t *b, size_t more);
+int wbuf_putc(wbuf_t *b, int c);
+int wbuf_put(wbuf_t *b, const char *s, size_t n);
+int wbuf_printf(wbuf_t *b, const char *fmt, ...);
+int json_put(wbuf_t *b, const char *s);
+void src_init(source_t *s, const char *buf, size_t len, FILE *fp);
+int src_peek(source_t *s);
+int src_next(source_t *s);
+void src_skip_line(source_t *s);
+int lex_token(source_t *s, token_t *t);
+int lex_redir(source_t *s, wbuf_t *b, token_t *t);
+int lex_subst(source_t *s, wbuf_t *b, int close);
+token_t *parse_peek(parser_t *p);
+void parse_drop(parser_t *p);
+node_t *parse_fail(parser_t *p, const char *msg);
+node_t *parse_unexpected(parser_t *p, const char *expecting);
+node_t *parse_list(parser_t *p, const char *close);
+node_t *parse_cmd(parser_t *p);
+node_t *parse_pipe(parser_t *p);
+node_t *parse_subshell(parser_t *p);
+int parse_end(token_t *t, const char *close);
+node_t *parse_while(parser_t *p);
+node_t *parse_command(source_t *s);
+node_t *parse_buffer(const char *buf, size_t len);
+int split_words(const char *s, node_t *n);
+char *unquote(const char *word);
+char **expand_words(expand_t *x, char **words, int nwords, int nassign);
+expand_t *expand_get(int status, const char *shell_name, int line);
+void expand_put(expand_t *x);
+char *expand_string(expand_t *x, const char *p, const char *end, int dq);
+int x_field(expand_t *x);
+int x_putc(expand_t *x, int c);
+int x_putq(expand_t *x, int c);
+char **x_finish(expand_t *x, int nassign);
+void x_break(expand_t *x);
+void x_value(expand_t *x, const char *v, size_t len, int quoted);
+const char *x_span(expand_t *x, const char *p, const char *end, int dq);
+const char *x_param(expand_t *x, const char *p, const char *end, int dq);
+const char *x_lookup(expand_t *x, const char *name, size_t len,
+char nb[32]);
+void x_emit(expand_t *x, const char *name, size_t len, int dq);
+const char *x_brace(expand_t *x, const char *p, const char *end, int dq);
+const char *x_close(const char *p, const char *end);
+const char *x_subst(expand_t *x, const char *p, const char *end, int dq);
+int subst_inproc(node_t *prog, expand_t *x, wbuf_t *out);
+int subst_fork(node_t *prog, expand_t *x, wbuf_t *out);
+int subst_run(node_t *prog, expand_t *x, wbuf_t *out);
+size_t unescape(char *s);
+int pat_compile(const char *s, gop_t *ops, int max);
+int pat_match(const gop_t *ops, int n, const char *name);
+int glob_cmp(const void *a, const void *b);
+dirlist_t *dir_list(const char *path);
+void glob_cache_clear(void);
+char **glob_expand(char *pattern, int *count, wbuf_t *store);
+int exec_top(node_t *n, const char *shell_name, int status, char *input);
+int dir_fresh(dirlist_t *d, struct stat *st);
+ssize_t le_read(const char *ps, char **linep, size_t *capp);
+void le_refresh(lined_t *e);
+int le_insert(lined_t *e, const char *s, size_t n);
+void le_erase(lined_t *e, size_t from, size_t to);
+int le_key(lined_t *e, int c);
+int le_edit(lined_t *e, int c);
+void le_complete(lined_t *e);
+int le_search(lined_t *e);
+int hist_add(const char *cmd, time_t when, long ms, int status);
+int hist_sync(void);
+const char *hist_rec(unsigned int i, size_t *len);
+const char *hist_text(unsigned int i);
+const char *hist_get(int back);
+void hx_index(hist_t *h);
+int hist_search(const char *q, int before);
+int spawn_cmd(const char *path, char *args[], spawn_t *sp,
+const char *shell_name, int line);
+pid_t spawn_start(const char *path, char *args[], spawn_t *sp,
+const char *shell_name, int line);
+int spawn_wait(pid_t *pid, spawn_t *sp);
+int cg_create(spawn_t *sp);
+void cg_finish(spawn_t *sp, const char *shell_name, int line);
+int spawn_watch(pid_t pid, spawn_t *sp, const char *shell_name, int line);
+int handle_timeout(char *args[], const char *shell_name, int command_count,
+int status, char *input);
+int place_list(const char *s, cpu_set_t *set);
+int place_rr(spawn_t *sp, int nodes);
+void place_next(spawn_t *sp);
+int place_child(spawn_t *sp, const char *shell_name, int line);
+int handle_place(char *args[], const char *shell_name, int command_count,
+int status, char *input);
+int handle_limit(char *args[], const char *shell_name, int command_count,
+int status, char *input);
+void repl_init(source_t *src, wbuf_t *rec);
+int repl_exec(node_t *cmd, source_t *src, const char *shell_name,
+int status);
+int trie_add(trie_t *t, const char *s, int delta);
+int trie_find(trie_t *t, const char *s, size_t len);
+int trie_lcp(trie_t *t, int at, wbuf_t *name);
+int trie_collect(trie_t *t, int at, wbuf_t *name, wbuf_t *out, int max);
+trie_t *comp_sync(void);
+int comp_cmds(const char *word, cands_t *c);
+int comp_files(const char *word, cands_t *c);
+void vars_import(void);
+var_t *var_lookup(const char *name);
+const char *var_get(const char *name);
+const char *var_getn(const char *name, size_t len);
+int var_set(const char *name, const char *value, int export);
+int var_unset(const char *name);
+size_t assign_len(const char *word);
+int handle_export(char *args[], const char *shell_name, int command_count);
+int handle_unset(char *args[], const char *shell_name, int command_count);
+int func_unset(const char *name);
+int exec_simple(node_t *n, const char *shell_name, int status, char *input);
+void var_save(const char *word, var_t *save);
+void assign_restore(char **words, var_t *save, int nassign);
+int node_pure(node_t *n, int ext, int depth);
+int exec_subshell(node_t *n, const char *shell_name, int status,
+char *input);
+void plan_elided(void);
+int exec_pipe(node_t *n, const char *shell_name, int status, char *input);
+int exec_while(node_t *n, const char *shell_name, int status, char *input);
+int redir_kids(node_t *n, int first, redir_t *r, const char *shell_name,
+int status);
+void redir_done(redir_t *r, int own);
+int wait_status(pid_t pid);
+pid_t shell_fork(void);
+void shell_exit(int status) __attribute__((noreturn));
+int redir_expand(expand_t *x, node_t *n);
+int redir_open(redir_t *r, node_t *n, char **vals, const char *shell_name);
+void redir_close(redir_t *r);
+int redir_apply(redir_t *r);
+void redir_restore(redir_t *r);
+void redir_child(redir_t *r);
+int cmd_inproc(const char *name);
+int parse_redir(parser_t *p, node_t *n);
+void parse_heredocs(parser_t *p);
+unsigned int ht_hash(const char *s);
+hent_t *ht_find(htab_t *t, const char *key);
+hent_t *ht_insert(htab_t *t, const char *key);
+void *ht_remove(htab_t *t, const char *key);
+alias_t *alias_lookup(const char *name);
+int alias_set(char *arg);
+void alias_print(const char *name, alias_t *a);
+char **alias_expand(char *args[]);
+int handle_alias(char *args[], const char *shell_name, int command_count);
+int handle_unalias(char *args[], const char *shell_name, int command_count);
+int func_define(const char *name, node_t *body);
+shfunc_t *func_find(const char *name);
+int func_call(shfunc_t *f, char *args[], const char *shell_name, int status,
+char *input);
+int handle_return(char *args[], const char *shell_name, int command_count,
+int status);
+int exec_node(node_t *n, const char *shell_name, int status, char *input);
+int run_script(const char *path, const char *shell_name);
+int script_exec(const char *path, char *args[], const char *shell_name);
+int shebang_self(const char *path);
+int run_string(const char *s, const char *shell_name);
+int shell_args(int argc, char *argv[], const char *shell_name);
+const builtin_t *builtin_find(const char *name);
+void rc_load(const char *shell_name, int interactive);
+void prof_mark(const char *what);
+void prof_report(void);
+void snap_pure(const char *name);
+void snap_begin(void);
+void snap_read(const char *name, var_t *v);
+int snap_state(cbuf_t *b);
+void snap_end(void);
+int snap_put(cbuf_t *b, const char *s);
+int snap_stamp(const char *path, char *out, size_t size);
+int snap_file(const char *key, char *file, size_t size);
+int snap_store(const char *rc, struct stat *st);
+int snap_load(const char *rc, struct stat *st);
+void cmd_clear(void);
+const char *cmd_add(const char *name, const char *path);
+const char *cmd_lookup(const char *name);
+void ahead_at(node_t **kids, struct cache_s *c, unsigned int n,
+unsigned int next);
+void ahead_run(void);
+int ahead_check(void);
+void jc_open(void);
+const char *jc_find(const char *name, const char *path);
+void jc_add(const char *name, const char *path, const char *full);
+int run_jobs(char *paths[], int n, int max, const char *shell_name);
+int jobs_args(int argc, char *argv[], const char *shell_name);
+int handle_hash(char *args[], const char *shell_name, int command_count);
+int handle_pwd(char *args[], const char *shell_name, int command_count);
+int handle_printf(char *args[], const char *shell_name, int command_count);
+int handle_read(char *args[], const char *shell_name, int command_count);
+int handle_batch(char *args[], const char *shell_name, int command_count);
+int batch_add(batch_t *b, const char *s, size_t len);
+int batch_run(batch_t *b);
+int batch_wait(batch_t *b);
+int batch_finish(batch_t *b);
+int handle_coproc(char *args[], const char *shell_name, int command_count);
+void coproc_close(coproc_t *c);
+void coproc_reap(void);
+int read_line(wbuf_t *line, int delim, int raw);
+void read_sync(void);
+int read_own(int fd);
+void read_disown(void);
+unsigned int stats_bucket(unsigned long us);
+unsigned long stats_value(unsigned int idx);
+void stats_add(const char *name, unsigned long us, int status);
+void stats_reset(void);
+int stats_run(char *args[], const char *shell_name, int command_count,
+int status, char *input);
+unsigned long stats_pct(const cstat_t *c, unsigned int permille);
+void stats_text(hent_t **ents, unsigned int n);
+int stats_json(hent_t **ents, unsigned int n);
+int handle_stats(char *args[], const char *shell_name, int command_count);
+int metrics_open(const char *file, const char *shell_name);
+uint64_t metrics_now(void);
+int trace_open(const char *file, const char *shell_name);
+wbuf_t *trace_head(int ph, const char *cat, const char *name, pid_t tid);
+void trace_begin(const char *cat, const char *name, pid_t tid, int line);
+void trace_end(const char *cat, const char *name, pid_t tid, int status);
+void trace_spawn(const char *name, pid_t pid);
+void trace_stage(const char *cat, const char *name, pid_t tid, int in,
+int out, int err);
+int audit_open(const char *file, const char *shell_name);
+void audit_close(void);
+void audit_cwd(void);
+long audit_futex(int *word, int op, int val, const struct timespec *ts);
+void audit_wake(audit_t *a);
+int audit_policy(const char *arg, const char *shell_name);
+void audit_cmd(char *args[], int status, unsigned long us, int line);
+int rec_open(const char *file, int how, const char *shell_name);
+int rec_stage(int stage);
+void rec_end(void);
+void rec_put(wbuf_t *b, const char *s, size_t n);
+void rec_input(int mode, const char *text, size_t len);
+void rec_cmd(char *args[], const char *path, int status);
+wbuf_t *rec_key(char *args[]);
+int rec_stub(char *args[], spawn_t *sp, const char *shell_name, int line);
+int rec_subst(node_t *prog, expand_t *x, const char *text, size_t len,
+wbuf_t *out);
+int replay_out(rec_t *r, char *f, int type);
+int rec_skip(const char *name);
+char *rec_unesc(char *s);
+int replay_load(int fd);
+int rec_replay(const char *shell_name);
+void rec_report(const char *const *name);
+int cache_file_name(const char *path, char *out, size_t size);
+int cache_map(const char *file, const char *key, struct stat *st,
+const char *magic, cache_t *c);
+int cache_load(const char *path, struct stat *st, cache_t *c);
+node_t *cache_rec(cache_t *c, unsigned int *pos);
+node_t *cache_node(cache_t *c, unsigned int i);
+void cache_close(cache_t *c);
+int cache_store(const char *path, struct stat *st, node_t *prog);
+int cbuf_node(cbuf_t *b, node_t *n);
+int cache_write(char *file, cache_hdr_t *h, const char *key,
+unsigned int *index, cbuf_t *b);
+int cache_mkdirs(char *file);
+int cbuf_rec(cbuf_t *b, unsigned int v);
+long cbuf_str(cbuf_t *b, const char *s);
+void cbuf_free(cbuf_t *b);
 
 #endif
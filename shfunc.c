@@ -0,0 +1,129 @@
+#include "shell.h"
+
+/**
+ * func_define - defines or replaces a shell function
+ * @name: name of the function
+ * @body: parsed body, copied into the function table
+ * Return: 0 on success, -1 on failure
+ */
+int func_define(const char *name, node_t *body)
+{
+	shfunc_t *f = malloc(sizeof(*f));
+	hent_t *e;
+
+	if (f == NULL)
+		return (-1);
+	f->body = node_copy(body);
+	f->refs = 0;
+	f->dead = 0;
+	if (f->body != NULL)
+		func_unset(name);
+	e = f->body != NULL ? ht_insert(&g_sh.funcs, name) : NULL;
+	if (e == NULL)
+	{
+		node_free(f->body);
+		free(f);
+		return (-1);
+	}
+	e->val = f;
+	return (0);
+}
+
+/**
+ * func_unset - removes a shell function
+ * @name: name of the function
+ * Return: 0 if the function existed, -1 otherwise
+ *
+ * A function that is still running is only freed once its last call
+ * returns.
+ */
+int func_unset(const char *name)
+{
+	shfunc_t *f = ht_remove(&g_sh.funcs, name);
+
+	if (f == NULL)
+		return (-1);
+	if (f->refs > 0)
+		f->dead = 1;
+	else
+	{
+		node_free(f->body);
+		free(f);
+	}
+	return (0);
+}
+
+/**
+ * func_find - looks up a shell function
+ * @name: name of the function
+ * Return: the function, or NULL
+ */
+shfunc_t *func_find(const char *name)
+{
+	hent_t *e = ht_find(&g_sh.funcs, name);
+
+	return (e != NULL ? e->val : NULL);
+}
+
+/**
+ * func_call - runs a shell function in the current process
+ * @f: the function
+ * @args: argument vector; args[1] onwards become the positional parameters
+ * @shell_name: name of shell executed
+ * @status: exit status of the previous command
+ * @input: the line buffer the command was read from
+ * Return: exit status of the function
+ */
+int func_call(shfunc_t *f, char *args[], const char *shell_name, int status,
+char *input)
+{
+	char **params = g_sh.params;
+	int nparams = g_sh.nparams;
+
+	g_sh.params = args + 1;
+	for (g_sh.nparams = 0; args[g_sh.nparams + 1] != NULL; g_sh.nparams++)
+		;
+	g_sh.funcnest++;
+	f->refs++;
+	status = exec_node(f->body, shell_name, status, input);
+	f->refs--;
+	g_sh.funcnest--;
+	g_sh.returning = 0;
+	g_sh.params = params;
+	g_sh.nparams = nparams;
+	if (f->dead && f->refs == 0)
+	{
+		node_free(f->body);
+		free(f);
+	}
+	return (status);
+}
+
+/**
+ * handle_return - handles the built-in "return" command
+ * @args: array of arguments for the command
+ * @shell_name: the name of the shell (e.g., "sh")
+ * @command_count: the count of commands entered since shell execution
+ * @status: exit status of the previous command, returned without argument
+ * Return: the status the function returns with
+ */
+int handle_return(char *args[], const char *shell_name, int command_count,
+int status)
+{
+	if (g_sh.funcnest == 0)
+	{
+		fprintf(stderr, "%s: %d: return: not in a function\n",
+			shell_name, command_count);
+		return (1);
+	}
+	if (args[1] != NULL && check_for_non_digit(args[1]) != 0)
+	{
+		fprintf(stderr, "%s: %d: return: Illegal number: %s\n",
+			shell_name, command_count, args[1]);
+		status = 2;
+	}
+	else if (args[1] != NULL)
+		status = atoi(args[1]) & 0xff;
+	g_sh.returning = 1;
+	return (status);
+}
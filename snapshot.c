@@ -0,0 +1,151 @@
+#include "shell.h"
+
+static htab_t reads, pre;
+
+/**
+ * snap_begin - starts recording the effects of an rc file
+ *
+ * Every variable is remembered as it was, so that only the ones the rc
+ * file changes end up in the snapshot.
+ */
+void snap_begin(void)
+{
+	unsigned int i;
+	hent_t *e, *p;
+	var_t *v;
+	char *s;
+
+	g_sh.snap = 1;
+	for (i = 0; i < g_sh.vars.nb; i++)
+		for (e = g_sh.vars.b[i]; e != NULL; e = e->next)
+		{
+			v = e->val;
+			s = malloc(strlen(v->value) + 2);
+			p = s != NULL ? ht_insert(&pre, e->key) : NULL;
+			if (p == NULL)
+			{
+				free(s);
+				g_sh.snap = -1;
+				return;
+			}
+			s[0] = '0' + !!v->exported;
+			strcpy(s + 1, v->value);
+			p->val = s;
+		}
+}
+
+/**
+ * snap_read - records a variable read while an rc file runs
+ * @name: the variable
+ * @v: the variable, NULL when it is unset
+ *
+ * The first value seen is kept; a snapshot is only used by shells that
+ * would have seen the same. Variables the rc file already changed are
+ * part of the snapshot instead.
+ */
+void snap_read(const char *name, var_t *v)
+{
+	hent_t *e = ht_find(&pre, name);
+
+	if ((e == NULL) != (v == NULL) || (e != NULL &&
+		strcmp((char *)e->val + 1, v->value) != 0) ||
+		ht_find(&reads, name) != NULL)
+		return;
+	e = ht_insert(&reads, name);
+	if (e == NULL)
+	{
+		g_sh.snap = -1;
+		return;
+	}
+	e->val = malloc(v != NULL ? strlen(v->value) + 2 : 2);
+	if (e->val == NULL)
+		g_sh.snap = -1;
+	else
+		sprintf(e->val, "%c%s", v != NULL ? '+' : '-',
+			v != NULL ? v->value : "");
+}
+
+/**
+ * snap_diff - serialises the variables an rc file changed
+ * @b: the buffer
+ * @count: incremented for each variable written
+ * Return: 0 on success, -1 on failure
+ */
+static int snap_diff(cbuf_t *b, unsigned int *count)
+{
+	unsigned int i;
+	hent_t *e, *p;
+	var_t *v;
+	char *was;
+	int r = 0;
+
+	for (i = 0; r == 0 && i < g_sh.vars.nb; i++)
+		for (e = g_sh.vars.b[i]; r == 0 && e != NULL; e = e->next)
+		{
+			v = e->val;
+			p = ht_find(&pre, e->key);
+			was = p != NULL ? p->val : NULL;
+			if (was != NULL && was[0] == '0' + !!v->exported &&
+				strcmp(was + 1, v->value) == 0)
+				continue;
+			r = snap_put(b, e->key) | snap_put(b, v->value) |
+				cbuf_rec(b, !!v->exported);
+			++*count;
+		}
+	for (i = 0; r == 0 && i < pre.nb; i++)
+		for (e = pre.b[i]; r == 0 && e != NULL; e = e->next)
+			if (ht_find(&g_sh.vars, e->key) == NULL)
+			{
+				r = snap_put(b, e->key) | snap_put(b, NULL) |
+					cbuf_rec(b, 0);
+				++*count;
+			}
+	return (r);
+}
+
+/**
+ * snap_state - serialises the variables an rc file read and changed
+ * @b: the buffer
+ * Return: 0 on success, -1 on failure
+ *
+ * Reads are name and value pairs, changes are name, value and export
+ * flag triples, each list after its length.
+ */
+int snap_state(cbuf_t *b)
+{
+	unsigned int i, at, n = 0;
+	hent_t *e;
+	char *v;
+	int r = cbuf_rec(b, reads.n);
+
+	for (i = 0; r == 0 && i < reads.nb; i++)
+		for (e = reads.b[i]; r == 0 && e != NULL; e = e->next)
+		{
+			v = e->val;
+			r = snap_put(b, e->key) |
+				snap_put(b, *v == '+' ? v + 1 : NULL);
+		}
+	at = b->nrecs;
+	if (r != 0 || cbuf_rec(b, 0) != 0 || snap_diff(b, &n) != 0)
+		return (-1);
+	b->recs[at] = n;
+	return (0);
+}
+
+/**
+ * snap_end - stops recording the effects of an rc file
+ */
+void snap_end(void)
+{
+	unsigned int i;
+	htab_t *t[2];
+	int k;
+
+	t[0] = &reads;
+	t[1] = &pre;
+	for (k = 0; k < 2; k++)
+		for (i = 0; i < t[k]->nb; i++)
+			while (t[k]->b[i] != NULL)
+				free(ht_remove(t[k], t[k]->b[i]->key));
+	g_sh.snap = 0;
+}
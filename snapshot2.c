@@ -0,0 +1,133 @@
+#include "shell.h"
+
+/**
+ * snap_put - appends the string offset of a value to a snapshot
+ * @b: the buffer
+ * @s: the value, NULL for none
+ * Return: 0 on success, -1 on failure
+ */
+int snap_put(cbuf_t *b, const char *s)
+{
+	long off = s != NULL ? cbuf_str(b, s) : (long)SNAP_NONE;
+
+	return (off < 0 ? -1 : cbuf_rec(b, off));
+}
+
+/**
+ * snap_stamp - describes the version of a file a snapshot depends on
+ * @path: the file
+ * @out: buffer for the description
+ * @size: size of @out
+ * Return: 0 on success, -1 if the file cannot be examined
+ */
+int snap_stamp(const char *path, char *out, size_t size)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0)
+		return (-1);
+	snprintf(out, size, "%lu:%lu:%ld:%ld.%09ld", (unsigned long)st.st_dev,
+		(unsigned long)st.st_ino, (long)st.st_size,
+		(long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec);
+	return (0);
+}
+
+/**
+ * snap_file - builds the name of the startup snapshot of an rc file
+ * @key: resolved path of the rc file
+ * @file: buffer for the name
+ * @size: size of @file
+ * Return: 0 on success, -1 when caching is disabled
+ *
+ * The snapshot sits next to the compiled form of the same file, with a
+ * ".hshs" suffix in place of ".hshc".
+ */
+int snap_file(const char *key, char *file, size_t size)
+{
+	if (cache_file_name(key, file, size) != 0)
+		return (-1);
+	file[strlen(file) - 1] = 's';
+	return (0);
+}
+
+/**
+ * snap_defs - serialises the aliases, cached commands and functions
+ * @b: the buffer
+ * Return: 0 on success, -1 on failure
+ *
+ * The cached commands follow the PATH they were found with; functions
+ * are a name followed by the records of their body.
+ */
+static int snap_defs(cbuf_t *b)
+{
+	htab_t *t[3];
+	unsigned int i, k;
+	hent_t *e;
+	void *v;
+	int r = snap_put(b, g_sh.cmdpath);
+
+	t[0] = &g_sh.aliases;
+	t[1] = &g_sh.cmds;
+	t[2] = &g_sh.funcs;
+	for (k = 0; r == 0 && k < 3; k++)
+	{
+		r = cbuf_rec(b, t[k]->n);
+		for (i = 0; r == 0 && i < t[k]->nb; i++)
+			for (e = t[k]->b[i]; r == 0 && e != NULL; e = e->next)
+			{
+				v = e->val;
+				r = snap_put(b, e->key);
+				if (k == 0)
+					r |= snap_put(b, ((alias_t *)v)->value);
+				else if (k == 1)
+					r |= snap_put(b, v);
+				else
+					r |= cbuf_node(b,
+						((shfunc_t *)v)->body);
+			}
+	}
+	return (r);
+}
+
+/**
+ * snap_store - writes the startup snapshot of an rc file that just ran
+ * @rc: path of the rc file
+ * @st: stat of the rc file from before it ran
+ * Return: 0 on success, -1 on failure
+ *
+ * The image holds the files it depends on besides the rc file, the
+ * variables the rc file read, and then its definitions.
+ */
+int snap_store(const char *rc, struct stat *st)
+{
+	char key[PATH_MAX], file[PATH_MAX + 64], stamp[128];
+	cache_hdr_t h;
+	cbuf_t b;
+	int r = -1;
+
+	if (realpath(rc, key) == NULL || snap_file(key, file, sizeof(file)) ||
+		snap_stamp("/proc/self/exe", stamp, sizeof(stamp)) != 0)
+		return (-1);
+	memset(&b, 0, sizeof(b));
+	if (cbuf_rec(&b, 1) == 0 && snap_put(&b, "/proc/self/exe") == 0 &&
+		snap_put(&b, stamp) == 0 && snap_state(&b) == 0 &&
+		snap_defs(&b) == 0)
+	{
+		memset(&h, 0, sizeof(h));
+		memcpy(h.magic, SNAP_MAGIC, 8);
+		strncpy(h.version, HSH_VERSION, sizeof(h.version));
+		h.size = st->st_size;
+		h.mtime_sec = st->st_mtim.tv_sec;
+		h.mtime_nsec = st->st_mtim.tv_nsec;
+		h.ctime_sec = st->st_ctim.tv_sec;
+		h.ctime_nsec = st->st_ctim.tv_nsec;
+		h.ino = st->st_ino;
+		h.dev = st->st_dev;
+		h.path_len = strlen(key);
+		h.nrecs = b.nrecs;
+		h.str_len = b.slen;
+		r = cache_write(file, &h, key, NULL, &b);
+	}
+	cbuf_free(&b);
+	return (r);
+}
@@ -0,0 +1,160 @@
+#include "shell.h"
+
+/**
+ * snap_word - reads the next record of a snapshot
+ * @c: the mapped snapshot
+ * @pos: position in the record area, advanced
+ * @v: receives the record
+ * @s: when not NULL, receives the string the record refers to, NULL for
+ * SNAP_NONE
+ * Return: 0 on success, -1 if the record is missing or damaged
+ */
+static int snap_word(cache_t *c, unsigned int *pos, unsigned int *v,
+const char **s)
+{
+	if (*pos >= c->nrecs)
+		return (-1);
+	*v = c->recs[(*pos)++];
+	if (s == NULL)
+		return (0);
+	*s = *v != SNAP_NONE ? c->strs + *v : NULL;
+	return (*v != SNAP_NONE && *v >= c->str_len ? -1 : 0);
+}
+
+/**
+ * snap_check - checks that a snapshot still describes this shell
+ * @c: the mapped snapshot
+ * @pos: position in the record area, advanced past the checks
+ * Return: 0 when every input file and variable read is unchanged
+ */
+static int snap_check(cache_t *c, unsigned int *pos)
+{
+	char stamp[128];
+	const char *a, *b, *cur;
+	unsigned int n, k, v;
+
+	for (k = 0; k < 2; k++)
+	{
+		if (snap_word(c, pos, &n, NULL) != 0)
+			return (-1);
+		for (; n > 0; n--)
+		{
+			if (snap_word(c, pos, &v, &a) || a == NULL ||
+				snap_word(c, pos, &v, &b))
+				return (-1);
+			if (k == 0 && (b == NULL || snap_stamp(a, stamp,
+				sizeof(stamp)) != 0 || strcmp(b, stamp) != 0))
+				return (-1);
+			cur = k == 1 ? var_get(a) : NULL;
+			if (k == 1 && (cur == NULL ? b != NULL : b == NULL ||
+				strcmp(b, cur) != 0))
+				return (-1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * snap_vars - replays the variables an rc file changed
+ * @c: the mapped snapshot
+ * @pos: position in the record area, advanced
+ * Return: 0 on success, -1 if the snapshot is damaged
+ */
+static int snap_vars(cache_t *c, unsigned int *pos)
+{
+	const char *a, *b;
+	unsigned int n, v, ex;
+
+	if (snap_word(c, pos, &n, NULL) != 0)
+		return (-1);
+	for (; n > 0; n--)
+	{
+		if (snap_word(c, pos, &v, &a) || a == NULL ||
+			snap_word(c, pos, &v, &b) ||
+			snap_word(c, pos, &ex, NULL))
+			return (-1);
+		if (b == NULL || !ex)
+			var_unset(a);
+		if (b != NULL)
+			var_set(a, b, ex);
+	}
+	return (0);
+}
+
+/**
+ * snap_replay - replays the aliases and cached commands of a snapshot
+ * @c: the mapped snapshot
+ * @pos: position in the record area, advanced to the functions
+ * Return: 0 on success, -1 if the snapshot is damaged
+ *
+ * The cached commands are only used when PATH is the one they were
+ * found with.
+ */
+static int snap_replay(cache_t *c, unsigned int *pos)
+{
+	const char *a, *b, *path, *now = var_get("PATH");
+	unsigned int n, k, v;
+	char *def;
+
+	if (snap_word(c, pos, &v, &path) != 0)
+		return (-1);
+	if (path != NULL && now != NULL && strcmp(path, now) == 0)
+	{
+		cmd_clear();
+		g_sh.cmdpath = strdup(path);
+	}
+	for (k = 0; k < 2; k++)
+	{
+		if (snap_word(c, pos, &n, NULL) != 0)
+			return (-1);
+		for (; n > 0; n--)
+		{
+			if (snap_word(c, pos, &v, &a) || a == NULL ||
+				snap_word(c, pos, &v, &b) || b == NULL)
+				return (-1);
+			def = k == 0 ? malloc(strlen(a) + strlen(b) + 2) : NULL;
+			if (def != NULL && sprintf(def, "%s=%s", a, b) > 0)
+				alias_set(def);
+			free(def);
+			if (k == 1 && g_sh.cmdpath != NULL &&
+				strcmp(g_sh.cmdpath, path) == 0)
+				cmd_add(a, b);
+		}
+	}
+	return (0);
+}
+
+/**
+ * snap_load - restores the state an rc file left, from its snapshot
+ * @rc: path of the rc file
+ * @st: stat of the rc file
+ * Return: 0 on success, -1 when the rc file has to be run
+ *
+ * A snapshot is used only if it was written by this version of the
+ * shell, for this rc file and shell binary unchanged, and every
+ * variable the rc file read still has the value it had.
+ */
+int snap_load(const char *rc, struct stat *st)
+{
+	char key[PATH_MAX], file[PATH_MAX + 64];
+	cache_t c;
+	unsigned int pos = 0, n, v;
+	const char *name;
+	node_t *body;
+	int r;
+
+	if (realpath(rc, key) == NULL || snap_file(key, file, sizeof(file)) ||
+		cache_map(file, key, st, SNAP_MAGIC, &c) != 0)
+		return (-1);
+	r = snap_check(&c, &pos) || snap_vars(&c, &pos) ||
+		snap_replay(&c, &pos) || snap_word(&c, &pos, &n, NULL) ? -1 : 0;
+	for (; r == 0 && n > 0; n--)
+	{
+		body = snap_word(&c, &pos, &v, &name) || name == NULL ? NULL :
+			cache_rec(&c, &pos);
+		r = body != NULL ? func_define(name, body) : -1;
+		node_free(body);
+	}
+	cache_close(&c);
+	return (r);
+}
@@ -0,0 +1,102 @@
+#include "shell.h"
+
+/**
+ * src_init - sets up a source
+ * @s: the source
+ * @buf: fixed text to read, or NULL when reading @fp
+ * @len: length of @buf
+ * @fp: stream to read line by line when @buf is NULL
+ */
+void src_init(source_t *s, const char *buf, size_t len, FILE *fp)
+{
+	s->buf = buf;
+	s->len = buf != NULL ? len : 0;
+	s->pos = 0;
+	s->fp = buf != NULL ? NULL : fp;
+	s->line = NULL;
+	s->cap = 0;
+	s->lineno = 1;
+	s->ps = NULL;
+	s->edit = 0;
+	s->rec = NULL;
+}
+
+/**
+ * src_peek - returns the next character without consuming it
+ * @s: the source
+ * Return: the character, or EOF
+ *
+ * A stream source is only refilled here, once the current line has been
+ * consumed, so the lexer never reads ahead of the command it is building.
+ * An interactive source reads through the line editor. Each line read is
+ * recorded for --record.
+ */
+int src_peek(source_t *s)
+{
+	const char *ps = s->ps;
+	ssize_t r;
+	int stage;
+
+	if (s->pos < s->len)
+		return ((unsigned char)s->buf[s->pos]);
+	if (s->fp == NULL)
+		return (EOF);
+	if (ps != NULL)
+		s->ps = "> ";
+	stage = REC_STAGE(REC_INPUT);
+	if (s->edit)
+		r = le_read(ps, &s->line, &s->cap);
+	else
+	{
+		if (ps != NULL)
+		{
+			printf("%s", ps);
+			fflush(stdout);
+		}
+		r = getline(&s->line, &s->cap, s->fp);
+	}
+	REC_STAGE(stage);
+	if (r <= 0)
+	{
+		s->len = 0;
+		s->pos = 0;
+		return (EOF);
+	}
+	if (s->rec != NULL)
+		wbuf_put(s->rec, s->line, r);
+	rec_input('i', s->line, r);
+	s->buf = s->line;
+	s->len = r;
+	s->pos = 0;
+	return ((unsigned char)s->buf[0]);
+}
+
+/**
+ * src_next - consumes and returns the next character
+ * @s: the source
+ * Return: the character, or EOF
+ */
+int src_next(source_t *s)
+{
+	int c = src_peek(s);
+
+	if (c == EOF)
+		return (EOF);
+	s->pos++;
+	if (c == '\n')
+		s->lineno++;
+	return (c);
+}
+
+/**
+ * src_skip_line - discards the rest of the current line
+ * @s: the source
+ *
+ * Used after a syntax error so the next command starts on a fresh line.
+ */
+void src_skip_line(source_t *s)
+{
+	while (s->pos < s->len)
+		if (src_next(s) == '\n')
+			return;
+}
@@ -0,0 +1,191 @@
+#include "shell.h"
+
+/**
+ * spawn_level - maps a cgroup weight onto a priority scale
+ * @weight: the weight, 1 to 10000 with 100 the default
+ * @step: ratio, in percent, between the weights of adjacent levels
+ * @lo: most favoured level
+ * @hi: least favoured level
+ * @mid: level of the default weight
+ * Return: the level
+ */
+static int spawn_level(long weight, long step, int lo, int hi, int mid)
+{
+	long w = 100;
+	int level = mid;
+
+	while (weight >= w * step / 100 && level > lo)
+	{
+		w = w * step / 100;
+		level--;
+	}
+	while (weight < w && level < hi)
+	{
+		w = w * 100 / step;
+		level++;
+	}
+	return (level);
+}
+
+/**
+ * spawn_exec - applies the settings of a child and execs the command
+ * @path: where the command was found
+ * @args: the command and its arguments
+ * @sp: the settings
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ *
+ * Limits the cgroup could not take are approximated: memory with
+ * RLIMIT_AS, processes with RLIMIT_NPROC, CPU weight with nice (a step of
+ * 1.25 per level) and I/O weight with the best-effort ionice levels.
+ * An explicit placement comes last, so its nice and ionice win. A cached
+ * path that has gone away falls back to a search of PATH. The
+ * redirections of the command are applied first, and SIGPIPE, which a
+ * pipeline stage run by the shell ignores, is restored.
+ */
+static void spawn_exec(const char *path, char *args[], spawn_t *sp,
+const char *shell_name, int line)
+{
+	struct rlimit rl;
+
+	redir_child(g_sh.redir);
+	signal(SIGPIPE, SIG_DFL);
+	if (sp->fallback & LIM_MEM)
+	{
+		rl.rlim_cur = rl.rlim_max = sp->mem;
+		setrlimit(RLIMIT_AS, &rl);
+	}
+	if (sp->fallback & LIM_PIDS)
+	{
+		rl.rlim_cur = rl.rlim_max = sp->pids;
+		setrlimit(RLIMIT_NPROC, &rl);
+	}
+	if (sp->fallback & LIM_CPU)
+		setpriority(PRIO_PROCESS, 0,
+			spawn_level(sp->cpu_weight, 125, -20, 19, 0));
+	if (sp->fallback & LIM_IO)
+		syscall(SYS_ioprio_set, 1, 0, (2 << 13) |
+			spawn_level(sp->io_weight, 200, 0, 7, 4));
+	if (sp->place != 0 && place_child(sp, shell_name, line) != 0)
+		_exit(126);
+	execv(path, args);
+	if (errno == ENOEXEC || errno == ENOENT)
+		execvp(errno == ENOEXEC ? path : args[0], args);
+	_exit(errno == ENOENT ? 127 : 126);
+}
+
+/**
+ * spawn_fork - creates a child, inside the cgroup leaf if there is one
+ * @sp: the settings
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: as for fork
+ *
+ * clone3 with CLONE_INTO_CGROUP starts the child in its cgroup, so it is
+ * never charged to the shell's; older kernels get a fork after which the
+ * child moves itself, and exits with 126 rather than run unlimited when
+ * it cannot.
+ */
+static pid_t spawn_fork(spawn_t *sp, const char *shell_name, int line)
+{
+	clone3_t ca;
+	pid_t pid;
+	int fd, err = 0;
+
+	if (sp->cgroup != NULL)
+	{
+		memset(&ca, 0, sizeof(ca));
+		ca.flags = CLONE_INTO_CGROUP;
+		ca.exit_signal = SIGCHLD;
+		ca.cgroup = sp->cgfd;
+		pid = syscall(SYS_clone3, &ca, sizeof(ca));
+		if (pid >= 0)
+			return (pid);
+	}
+	pid = fork();
+	if (pid != 0 || sp->cgroup == NULL)
+		return (pid);
+	fd = openat(sp->cgfd, "cgroup.procs", O_WRONLY | O_CLOEXEC);
+	if (fd < 0 || write(fd, "0", 1) != 1)
+		err = errno != 0 ? errno : EIO;
+	if (fd >= 0)
+		close(fd);
+	if (err == 0)
+		return (0);
+	fprintf(stderr, "%s: %d: limit: cannot join %s: %s\n", shell_name,
+		line, sp->cgroup, strerror(err));
+	_exit(126);
+}
+
+/**
+ * spawn_start - starts an external command without waiting for it
+ * @path: where the command was found
+ * @args: the command and its arguments
+ * @sp: the settings to start it with
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: the child, -1 if it could not be created
+ */
+pid_t spawn_start(const char *path, char *args[], spawn_t *sp,
+const char *shell_name, int line)
+{
+	uint64_t t = metrics_now();
+	pid_t pid = spawn_fork(sp, shell_name, line);
+
+	if (pid < 0)
+	{
+		fprintf(stderr, "Fork failed\n");
+		return (-1);
+	}
+	if (pid == 0)
+		spawn_exec(path, args, sp, shell_name, line);
+	METRIC_ADD(spawn_ns, metrics_now() - t);
+	METRIC_ADD(jobs, 1);
+	trace_spawn(args[0], pid);
+	return (pid);
+}
+
+/**
+ * spawn_cmd - runs an external command and waits for it
+ * @path: where the command was found
+ * @args: the command and its arguments
+ * @sp: the settings to start it with
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: its exit status, -1 if it could not be started, 124 if it ran
+ * out of time, or 137 if it then had to be killed
+ *
+ * Only a command with a timeout is watched before the wait. The last
+ * command of a script or -c string replaces the shell instead, unless
+ * the shell still has to report on it, time it, trace it, log it or
+ * record it, or reap a coprocess after it.
+ */
+int spawn_cmd(const char *path, char *args[], spawn_t *sp,
+const char *shell_name, int line)
+{
+	pid_t pid;
+	int timed = 0, status;
+	uint64_t t;
+
+	fflush(stdout);
+	read_sync();
+	METRIC_ADD(externals, 1);
+	if (g_sh.tail && sp->lim == 0 && sp->timeout_ms == 0 &&
+		g_sh.trace == NULL && !g_sh.audit.on && g_sh.ncoproc == 0 &&
+		!g_sh.rec.on)
+		spawn_exec(path, args, sp, shell_name, line);
+	pid = spawn_start(path, args, sp, shell_name, line);
+	if (pid < 0)
+		return (-1);
+	ahead_run();
+	t = metrics_now();
+	if (sp->timeout_ms > 0)
+		timed = spawn_watch(pid, sp, shell_name, line);
+	status = spawn_wait(&pid, sp);
+	ahead_check();
+	METRIC_ADD(wait_ns, metrics_now() - t);
+	METRIC_ADD(jobs, -1);
+	status = timed == 0 ? status : timed == 1 ? 124 : 137;
+	trace_end("proc", args[0], pid, status);
+	return (status);
+}
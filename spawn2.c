@@ -0,0 +1,91 @@
+#include "shell.h"
+
+/**
+ * spawn_arm - starts a one shot timer
+ * @fd: the timerfd
+ * @ms: milliseconds until it fires
+ * Return: 0 on success, -1 on failure
+ */
+static int spawn_arm(int fd, long ms)
+{
+	struct itimerspec its;
+
+	memset(&its, 0, sizeof(its));
+	its.it_value.tv_sec = ms / 1000;
+	its.it_value.tv_nsec = ms % 1000 * 1000000L;
+	return (timerfd_settime(fd, 0, &its, NULL));
+}
+
+/**
+ * spawn_watch - signals a child that outlives its timeout
+ * @pid: the child
+ * @sp: the settings
+ * @shell_name: name of the shell, for messages
+ * @line: line number, for messages
+ * Return: 0 if it exited in time, 1 if it was sent the timeout signal,
+ * 2 if it was sent SIGKILL; the child is left for the caller to reap
+ *
+ * A pidfd and a timerfd are polled together, so neither a helper process
+ * nor a SIGALRM handler is needed. Only the child itself is signalled.
+ */
+int spawn_watch(pid_t pid, spawn_t *sp, const char *shell_name, int line)
+{
+	struct pollfd pf[2];
+	uint64_t n;
+	int timed = 0;
+
+	pf[0].fd = syscall(SYS_pidfd_open, pid, 0);
+	pf[1].fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	pf[0].events = pf[1].events = POLLIN;
+	if (pf[0].fd < 0 || pf[1].fd < 0 || spawn_arm(pf[1].fd, sp->timeout_ms))
+		fprintf(stderr, "%s: %d: timeout: cannot watch the command: "
+			"%s\n", shell_name, line, strerror(errno));
+	while (pf[0].fd >= 0 && pf[1].fd >= 0)
+	{
+		if (poll(pf, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (pf[0].revents != 0 ||
+			read(pf[1].fd, &n, sizeof(n)) != sizeof(n))
+			break;
+		timed = timed != 0 || sp->tsig == SIGKILL ? 2 : 1;
+		syscall(SYS_pidfd_send_signal, pf[0].fd,
+			timed == 2 ? SIGKILL : sp->tsig, NULL, 0);
+		if (timed == 2 || sp->kill_ms == 0 ||
+			spawn_arm(pf[1].fd, sp->kill_ms) != 0)
+			break;
+	}
+	if (pf[0].fd >= 0)
+		close(pf[0].fd);
+	if (pf[1].fd >= 0)
+		close(pf[1].fd);
+	return (timed);
+}
+
+/**
+ * spawn_wait - waits for a child and accounts for its resource usage
+ * @pid: the child, or -1 for any; set to the child reaped
+ * @sp: the settings, whose usage counters are updated
+ * Return: the exit status, 128 plus the signal number if it was killed
+ */
+int spawn_wait(pid_t *pid, spawn_t *sp)
+{
+	struct rusage ru;
+	int status;
+	pid_t got;
+
+	while ((got = wait4(*pid, &status, 0, &ru)) < 0)
+		if (errno != EINTR)
+			return (-1);
+	*pid = got;
+	if (ru.ru_maxrss > sp->maxrss)
+		sp->maxrss = ru.ru_maxrss;
+	sp->cpu_us += (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000L +
+		ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+	if (WIFSIGNALED(status))
+		return (128 + WTERMSIG(status));
+	return (WIFEXITED(status) ? WEXITSTATUS(status) : status);
+}
@@ -0,0 +1,99 @@
+#include "shell.h"
+
+static struct timespec marks[16];
+static const char *names[16];
+static int nmarks;
+
+/**
+ * prof_mark - notes the end of a startup phase
+ * @what: name of the phase
+ *
+ * Marks are always taken, as clock_gettime does not enter the kernel, so
+ * that --startup-profile can include the phases before it was parsed.
+ */
+void prof_mark(const char *what)
+{
+	if (nmarks == 16)
+		return;
+	clock_gettime(CLOCK_MONOTONIC, &marks[nmarks]);
+	names[nmarks++] = what;
+}
+
+/**
+ * prof_report - prints where startup time went, for --startup-profile
+ *
+ * The first mark is the start of main; each line is the time spent in
+ * one phase, and the last the time until the shell is ready.
+ */
+void prof_report(void)
+{
+	double ms, total = 0;
+	int i;
+
+	for (i = 1; g_sh.profile && i < nmarks; i++)
+	{
+		ms = (marks[i].tv_sec - marks[i - 1].tv_sec) * 1e3 +
+			(marks[i].tv_nsec - marks[i - 1].tv_nsec) / 1e6;
+		total += ms;
+		fprintf(stderr, "startup: %-16s %9.3f ms\n", names[i], ms);
+	}
+	if (g_sh.profile)
+		fprintf(stderr, "startup: %-16s %9.3f ms\n", "total", total);
+	g_sh.profile = 0;
+	nmarks = 0;
+}
+
+/**
+ * snap_pure - checks that a command run by an rc file can be snapshotted
+ * @name: the command
+ *
+ * Only definitions can be replayed from a snapshot; anything else, such
+ * as an external command or cd, stops the rc file from being snapshotted.
+ */
+void snap_pure(const char *name)
+{
+	const char *ok = ":alias:unalias:export:unset:return:hash:", *p;
+	size_t n = strlen(name);
+
+	for (p = strstr(ok, name); n > 0 && p != NULL; p = strstr(p + 1, name))
+		if (p[-1] == ':' && p[n] == ':')
+			return;
+	if (func_find(name) == NULL)
+		g_sh.snap = -1;
+}
+
+/**
+ * rc_load - runs the rc file, or restores its effects from a snapshot
+ * @shell_name: name of the shell
+ * @interactive: nonzero when the shell reads commands from a terminal
+ *
+ * The rc file is $HSHRC, or ~/.hshrc for interactive shells. When it only
+ * defines variables, aliases, functions and cached commands, what it left
+ * is written to a snapshot that later shells load instead of running it.
+ */
+void rc_load(const char *shell_name, int interactive)
+{
+	const char *rc = getenv("HSHRC"), *home = getenv("HOME");
+	char path[PATH_MAX];
+	struct stat st;
+	int ok;
+
+	if (rc == NULL && interactive && home != NULL &&
+		snprintf(path, sizeof(path), "%s/.hshrc", home) < PATH_MAX)
+		rc = path;
+	if (rc == NULL || *rc == '\0' || stat(rc, &st) != 0)
+		return;
+	if (snap_load(rc, &st) == 0)
+	{
+		prof_mark("rc snapshot");
+		return;
+	}
+	snap_begin();
+	run_script(rc, shell_name);
+	prof_mark("rc file");
+	ok = g_sh.snap > 0;
+	g_sh.snap = 0;
+	if (ok && snap_store(rc, &st) == 0)
+		prof_mark("snapshot write");
+	snap_end();
+}
@@ -0,0 +1,127 @@
+#include "shell.h"
+
+/**
+ * stats_bucket - maps a duration to its histogram bucket
+ * @us: the duration in microseconds
+ * Return: the bucket index
+ *
+ * Durations below 2 << STATS_SUB_BITS get a bucket each; above that every
+ * power of two is split into 1 << STATS_SUB_BITS equal buckets, so a
+ * bucket is never wider than about 6% of the values it holds.
+ */
+unsigned int stats_bucket(unsigned long us)
+{
+	int shift;
+	unsigned long idx;
+
+	if (us < (1UL << STATS_SUB_BITS))
+		return (us);
+	shift = (int)(sizeof(us) * CHAR_BIT - 1) - __builtin_clzl(us) -
+		STATS_SUB_BITS;
+	idx = ((unsigned long)(shift + 1) << STATS_SUB_BITS) +
+		(us >> shift) - (1UL << STATS_SUB_BITS);
+	return (idx < STATS_BUCKETS ? idx : STATS_BUCKETS - 1);
+}
+
+/**
+ * stats_value - gives the largest duration that falls into a bucket
+ * @idx: the bucket index
+ * Return: the duration in microseconds
+ */
+unsigned long stats_value(unsigned int idx)
+{
+	int shift = (int)(idx >> STATS_SUB_BITS) - 1;
+	unsigned long sub = idx & ((1U << STATS_SUB_BITS) - 1);
+
+	if (shift <= 0)
+		return (idx);
+	return (((sub + (1UL << STATS_SUB_BITS)) << shift) +
+		(1UL << shift) - 1);
+}
+
+/**
+ * stats_add - records one run of a command
+ * @name: the command name
+ * @us: its wall time in microseconds
+ * @status: its exit status
+ *
+ * Only the first run of a command allocates. Past STATS_MAX distinct
+ * names, new commands are counted together as "(other)".
+ */
+void stats_add(const char *name, unsigned long us, int status)
+{
+	hent_t *e = ht_find(&g_sh.stats, name);
+	cstat_t *c;
+
+	if (e == NULL)
+		e = ht_insert(&g_sh.stats,
+			g_sh.stats.n < STATS_MAX ? name : "(other)");
+	if (e != NULL && e->val == NULL)
+		e->val = calloc(1, sizeof(cstat_t));
+	if (e == NULL || e->val == NULL)
+		return;
+	c = e->val;
+	c->count++;
+	c->fails += status != 0;
+	c->total_us += us;
+	if (us > c->max_us)
+		c->max_us = us;
+	c->hist[stats_bucket(us)]++;
+}
+
+/**
+ * stats_reset - forgets every recorded run
+ */
+void stats_reset(void)
+{
+	unsigned int i;
+	hent_t *e, *next;
+
+	for (i = 0; i < g_sh.stats.nb; i++)
+		for (e = g_sh.stats.b[i]; e != NULL; e = next)
+		{
+			next = e->next;
+			free(e->val);
+			free(e->key);
+			free(e);
+		}
+	free(g_sh.stats.b);
+	memset(&g_sh.stats, 0, sizeof(g_sh.stats));
+}
+
+/**
+ * stats_run - runs a command and records how long it took
+ * @args: NULL terminated arguments of the command
+ * @shell_name: name of shell executed
+ * @command_count: line number, for messages
+ * @status: exit status of the previous command
+ * @input: the line buffer, freed by exit
+ * Return: exit status of the command
+ */
+int stats_run(char *args[], const char *shell_name, int command_count,
+int status, char *input)
+{
+	struct timespec a, b;
+	const char *name = args[0], *spawned = g_sh.spawned;
+	unsigned long us;
+
+	METRIC_ADD(started, 1);
+	trace_begin("cmd", name, g_sh.pid, command_count);
+	g_sh.spawned = NULL;
+	clock_gettime(CLOCK_MONOTONIC, &a);
+	status = chK(args, shell_name, command_count, status, input);
+	clock_gettime(CLOCK_MONOTONIC, &b);
+	trace_end("cmd", name, g_sh.pid, status);
+	METRIC_ADD(finished, 1);
+	METRIC_ADD(failed, status != 0);
+	us = (b.tv_sec - a.tv_sec) * 1000000UL + b.tv_nsec / 1000 -
+		a.tv_nsec / 1000;
+	if (name != NULL)
+		stats_add(name, us, status);
+	if (g_sh.audit.on)
+		audit_cmd(args, status, us, command_count);
+	if (g_sh.rec.on)
+		rec_cmd(args, g_sh.spawned, status);
+	g_sh.spawned = spawned;
+	return (status);
+}
@@ -0,0 +1,109 @@
+#include "shell.h"
+
+/**
+ * stats_pct - finds a percentile of the run times of a command
+ * @c: the command's timings
+ * @permille: the percentile, in tenths of a percent
+ * Return: the duration in microseconds, never more than the longest run
+ */
+unsigned long stats_pct(const cstat_t *c, unsigned int permille)
+{
+	unsigned long want = (c->count * permille + 999) / 1000, seen = 0;
+	unsigned int i;
+
+	for (i = 0; i < STATS_BUCKETS; i++)
+	{
+		seen += c->hist[i];
+		if (seen >= want && seen > 0)
+			break;
+	}
+	return (i < STATS_BUCKETS && stats_value(i) < c->max_us ?
+		stats_value(i) : c->max_us);
+}
+
+/**
+ * stats_time - formats a duration in the unit that suits it
+ * @buf: output buffer of at least 32 bytes
+ * @us: the duration in microseconds
+ * Return: @buf
+ */
+static char *stats_time(char *buf, unsigned long us)
+{
+	if (us < 1000)
+		sprintf(buf, "%luus", us);
+	else if (us < 1000000)
+		sprintf(buf, "%.2fms", us / 1e3);
+	else
+		sprintf(buf, "%.2fs", us / 1e6);
+	return (buf);
+}
+
+/**
+ * stats_text - prints a table of command timings
+ * @ents: the entries of the stats table to print
+ * @n: number of @ents
+ */
+void stats_text(hent_t **ents, unsigned int n)
+{
+	char t[5][32];
+	cstat_t *c;
+	unsigned int i;
+
+	if (n > 0)
+		printf("%-20s %8s %6s %10s %10s %10s %10s %10s\n", "command",
+			"count", "fail%", "total", "p50", "p90", "p99", "max");
+	for (i = 0; i < n; i++)
+	{
+		c = ents[i]->val;
+		printf("%-20s %8lu %6.1f %10s %10s %10s %10s %10s\n",
+			ents[i]->key, c->count, 100.0 * c->fails / c->count,
+			stats_time(t[0], c->total_us),
+			stats_time(t[1], stats_pct(c, 500)),
+			stats_time(t[2], stats_pct(c, 900)),
+			stats_time(t[3], stats_pct(c, 990)),
+			stats_time(t[4], c->max_us));
+	}
+}
+
+/**
+ * stats_json - prints command timings as a JSON array
+ * @ents: the entries of the stats table to print
+ * @n: number of @ents
+ * Return: 0 on success, 1 on failure
+ *
+ * Durations are whole microseconds.
+ */
+int stats_json(hent_t **ents, unsigned int n)
+{
+	wbuf_t b = {NULL, 0, 0};
+	cstat_t *c;
+	unsigned int i;
+	int r = wbuf_putc(&b, '[');
+
+	for (i = 0; r == 0 && i < n; i++)
+	{
+		c = ents[i]->val;
+		r = wbuf_printf(&b, "%s{\"command\":", i > 0 ? "," : "") |
+			json_put(&b, ents[i]->key);
+		r |= wbuf_printf(&b, ",\"count\":%lu,\"fails\":%lu,"
+			"\"total_us\":%lu,\"p50_us\":%lu,\"p90_us\":%lu,"
+			"\"p99_us\":%lu,\"max_us\":%lu}", c->count, c->fails,
+			c->total_us, stats_pct(c, 500), stats_pct(c, 900),
+			stats_pct(c, 990), c->max_us);
+	}
+	r |= wbuf_put(&b, "]\n", 2);
+	if (r == 0)
+		fwrite(b.s, 1, b.len, stdout);
+	free(b.s);
+	return (r != 0);
+}
+
+/**
+ * plan_elided - counts a fork the shell did without
+ *
+ * The count shows in the stats builtin as the "(fork elided)" line.
+ */
+void plan_elided(void)
+{
+	stats_add("(fork elided)", 0, 0);
+}
@@ -0,0 +1,68 @@
+#include "shell.h"
+
+/**
+ * stats_cmp - orders stats entries by total time, longest first
+ * @a: pointer to the first entry
+ * @b: pointer to the second entry
+ * Return: negative, zero or positive as for qsort
+ */
+static int stats_cmp(const void *a, const void *b)
+{
+	const hent_t *x = *(hent_t * const *)a, *y = *(hent_t * const *)b;
+	const cstat_t *cx = x->val, *cy = y->val;
+
+	if (cx->total_us != cy->total_us)
+		return (cx->total_us < cy->total_us ? 1 : -1);
+	return (strcmp(x->key, y->key));
+}
+
+/**
+ * handle_stats - handles the built-in "stats" command
+ * @args: "stats" and its options
+ * @shell_name: the name of the shell
+ * @command_count: line number, for messages
+ * Return: 0 on success, 1 on failure, 2 on a usage error
+ *
+ * Prints the count, failure rate, total and p50/p90/p99/max wall time of
+ * every command run so far, the longest running first. -j prints JSON
+ * instead and -r forgets the timings, after printing them with -j.
+ */
+int handle_stats(char *args[], const char *shell_name, int command_count)
+{
+	int json = 0, reset = 0, r = 0;
+	hent_t **ents, *e;
+	unsigned int i, n = 0;
+
+	for (; *++args != NULL && **args == '-'; )
+		if (strcmp(*args, "-j") == 0 || strcmp(*args, "-r") == 0)
+			*(args[0][1] == 'j' ? &json : &reset) = 1;
+		else
+			break;
+	if (*args != NULL)
+	{
+		fprintf(stderr, "%s: %d: stats: usage: stats [-j] [-r]\n",
+			shell_name, command_count);
+		return (2);
+	}
+	if (reset && !json)
+	{
+		stats_reset();
+		return (0);
+	}
+	ents = malloc((g_sh.stats.n + 1) * sizeof(*ents));
+	if (ents == NULL)
+		return (1);
+	for (i = 0; i < g_sh.stats.nb; i++)
+		for (e = g_sh.stats.b[i]; e != NULL; e = e->next)
+			if (e->val != NULL)
+				ents[n++] = e;
+	qsort(ents, n, sizeof(*ents), stats_cmp);
+	if (json)
+		r = stats_json(ents, n);
+	else
+		stats_text(ents, n);
+	free(ents);
+	if (reset)
+		stats_reset();
+	return (r);
+}
@@ -0,0 +1,107 @@
+#include "shell.h"
+
+/**
+ * subst_close - finds the end of a command substitution
+ * @p: the "(" of a $(...) or the opening backquote
+ * @end: end of the text
+ * Return: the closing ")" or backquote, or @end when there is none
+ *
+ * Scans the same way lex_subst does.
+ */
+static const char *subst_close(const char *p, const char *end)
+{
+	int close = *p == '(' ? ')' : '`', q = 0, depth = 0;
+
+	for (p++; p < end; p++)
+		if (*p == '\\' && q != '\'' && p + 1 < end)
+			p++;
+		else if (close == '`' && *p == close)
+			return (p);
+		else if (close == '`')
+			continue;
+		else if (q != 0 && *p == q)
+			q = 0;
+		else if (q == 0 && (*p == '\'' || *p == '"'))
+			q = *p;
+		else if (q != '\'' && *p == '$' && p + 1 < end && p[1] == '(')
+		{
+			p = subst_close(p + 1, end);
+			if (p == end)
+				break;
+		}
+		else if (q == 0 && *p == '(')
+			depth++;
+		else if (q == 0 && *p == ')' && depth-- == 0)
+			return (p);
+	return (end);
+}
+
+/**
+ * subst_parse - parses the command of a substitution
+ * @p: the "(" or the opening backquote
+ * @close: the end found by subst_close
+ * @dq: nonzero inside double quotes
+ * Return: the parsed command, or NULL on failure
+ *
+ * Inside backquotes a backslash only escapes "$", "`" and "\", and also
+ * a double quote when the substitution is itself double quoted.
+ */
+static node_t *subst_parse(const char *p, const char *close, int dq)
+{
+	char *text, *t;
+	node_t *prog;
+
+	if (*p == '(')
+		return (parse_buffer(p + 1, close - p - 1));
+	text = malloc(close - p);
+	if (text == NULL)
+		return (NULL);
+	for (t = text, p++; p < close; p++)
+	{
+		if (*p == '\\' && p + 1 < close &&
+			strchr(dq ? "$`\\\"" : "$`\\", p[1]) != NULL)
+			p++;
+		*t++ = *p;
+	}
+	prog = parse_buffer(text, t - text);
+	free(text);
+	return (prog);
+}
+
+/**
+ * x_subst - expands a command substitution
+ * @x: the expansion buffer
+ * @p: the "(" of a $(...) or the opening backquote
+ * @end: end of the text
+ * @dq: nonzero inside double quotes
+ * Return: the position after the substitution
+ *
+ * The output, less its trailing newlines, is split like the value of a
+ * parameter. Under --record and --replay, see rec_subst.
+ */
+const char *x_subst(expand_t *x, const char *p, const char *end, int dq)
+{
+	const char *close = subst_close(p, end);
+	wbuf_t *out = &g_sh.subout;
+	node_t *prog;
+
+	if (close == end)
+	{
+		fprintf(stderr, "%s: %d: Syntax error: Unterminated command "
+			"substitution\n", x->shell_name, x->line);
+		x->err = 2;
+		return (end);
+	}
+	prog = g_sh.rec.on == REC_REPLAY ? NULL : subst_parse(p, close, dq);
+	out->len = 0;
+	if (g_sh.rec.on)
+		x->subst = rec_subst(prog, x, p + 1, close - p - 1, out);
+	else
+		x->subst = subst_run(prog, x, out);
+	node_free(prog);
+	while (out->len > 0 && out->s[out->len - 1] == '\n')
+		out->len--;
+	if (out->len > 0)
+		x_value(x, out->s, out->len, dq);
+	return (close + 1);
+}
@@ -0,0 +1,140 @@
+#include "shell.h"
+
+/**
+ * subst_read - reads a descriptor to its end
+ * @fd: the descriptor
+ * @out: buffer the bytes are appended to
+ * Return: 0 on success, -1 on failure
+ */
+static int subst_read(int fd, wbuf_t *out)
+{
+	ssize_t n;
+
+	while (1)
+	{
+		if (out->cap - out->len < 4096 && wbuf_grow(out, 4096) != 0)
+			return (-1);
+		n = read(fd, out->s + out->len, out->cap - out->len - 1);
+		if (n == 0)
+			return (0);
+		if (n < 0 && errno != EINTR)
+			return (-1);
+		out->len += n > 0 ? n : 0;
+	}
+}
+
+/**
+ * subst_inproc - runs a command substitution inside the shell
+ * @prog: the parsed command, which cannot change the shell
+ * @x: the expansion buffer, for $? and diagnostics
+ * @out: receives the output
+ * Return: exit status of the command
+ *
+ * Standard output goes to a memfd for the duration, so the command never
+ * blocks on a reader and no child is needed. The memfd is kept for the
+ * next substitution; nested ones make their own, and also use @out while
+ * the command runs.
+ */
+int subst_inproc(node_t *prog, expand_t *x, wbuf_t *out)
+{
+	redir_t r, *outer = g_sh.redir;
+	int fd = g_sh.subfd, tail = g_sh.tail, status;
+
+	g_sh.subfd = 0;
+	if (fd == 0)
+	{
+		fd = memfd_create("hsh-subst", MFD_CLOEXEC);
+		r.src[0] = fd;
+		fd = fd >= 0 ? fcntl(fd, F_DUPFD_CLOEXEC, 10) : -1;
+		if (r.src[0] >= 0)
+			close(r.src[0]);
+	}
+	if (fd < 0)
+		return (subst_fork(prog, x, out));
+	r.n = 1, r.fd[0] = 1, r.src[0] = fd, r.own = 0;
+	if (redir_apply(&r) != 0)
+	{
+		close(fd);
+		return (subst_fork(prog, x, out));
+	}
+	g_sh.redir = NULL;
+	g_sh.tail = 0;
+	plan_elided();
+	status = exec_node(prog, x->shell_name, x->status, NULL);
+	g_sh.tail = tail;
+	g_sh.redir = outer;
+	redir_restore(&r);
+	out->len = 0;
+	if (lseek(fd, 0, SEEK_SET) != 0 || subst_read(fd, out) != 0 ||
+		ftruncate(fd, 0) != 0 || lseek(fd, 0, SEEK_SET) != 0)
+	{
+		close(fd);
+		return (status);
+	}
+	if (g_sh.subfd == 0)
+		g_sh.subfd = fd;
+	else
+		close(fd);
+	return (status);
+}
+
+/**
+ * subst_fork - runs a command substitution in a child
+ * @prog: the parsed command
+ * @x: the expansion buffer, for $? and diagnostics
+ * @out: receives the output, read through a pipe as it is written
+ * Return: exit status of the command
+ *
+ * The child runs its last command as the tail of a script, so a lone
+ * external command replaces it instead of being forked again. With
+ * --trace-events it gets a "subst" event on its own track.
+ */
+int subst_fork(node_t *prog, expand_t *x, wbuf_t *out)
+{
+	int p[2], status;
+	pid_t pid;
+
+	if (pipe2(p, O_CLOEXEC) != 0)
+		return (1);
+	pid = shell_fork();
+	if (pid == 0)
+	{
+		close(p[0]);
+		if (p[1] != 1 && (dup2(p[1], 1) < 0 || close(p[1]) != 0))
+			_exit(1);
+		g_sh.tail = 1;
+		status = exec_node(prog, x->shell_name, x->status, NULL);
+		shell_exit(status);
+	}
+	if (pid > 0)
+		trace_stage("subst", node_name(prog), pid, -1, p[1], -1);
+	close(p[1]);
+	if (pid > 0)
+		subst_read(p[0], out);
+	close(p[0]);
+	if (pid < 0)
+		return (1);
+	status = wait_status(pid);
+	trace_end("subst", node_name(prog), pid, status);
+	return (status);
+}
+
+/**
+ * subst_run - runs a command substitution
+ * @prog: the parsed command, NULL when it could not be parsed
+ * @x: the expansion buffer, for $? and diagnostics
+ * @out: receives the output
+ * Return: exit status of the command
+ *
+ * A command that cannot change the shell runs in it, with its output
+ * going to a memfd; anything else runs in a child and is read through a
+ * pipe.
+ */
+int subst_run(node_t *prog, expand_t *x, wbuf_t *out)
+{
+	if (prog == NULL)
+		return (1);
+	if (node_pure(prog, 0, 0))
+		return (subst_inproc(prog, x, out));
+	return (subst_fork(prog, x, out));
+}
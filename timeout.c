@@ -0,0 +1,133 @@
+#include "shell.h"
+
+/**
+ * timeout_dur - parses a duration such as "10", "1.5m" or "2h"
+ * @s: the duration, in seconds unless it ends in s, m, h or d
+ * Return: the duration in milliseconds, -1 if it is malformed
+ */
+static long timeout_dur(const char *s)
+{
+	char *end;
+	double v;
+	const char *units = "smhd", *u;
+	double scale[4] = {1, 60, 3600, 86400};
+
+	errno = 0;
+	v = strtod(s, &end);
+	if (end == s || v < 0 || errno != 0 || *s == '-')
+		return (-1);
+	u = *end != '\0' ? strchr(units, *end) : units;
+	if (u == NULL || (*end != '\0' && end[1] != '\0'))
+		return (-1);
+	v *= scale[u - units] * 1000;
+	if (v >= LONG_MAX / 2)
+		return (-1);
+	return (v > 0 && v < 1 ? 1 : (long)v);
+}
+
+/**
+ * timeout_sig - parses a signal name or number
+ * @s: the signal, such as "TERM", "SIGKILL" or "9"
+ * Return: the signal number, -1 if it is not known
+ */
+static int timeout_sig(const char *s)
+{
+	const char *names = ":HUP:INT:QUIT:ILL:TRAP:ABRT:BUS:FPE:KILL:USR1:"
+		"SEGV:USR2:PIPE:ALRM:TERM:", *p;
+	char key[16], *end;
+	long n;
+	int sig = 1;
+
+	n = strtol(s, &end, 10);
+	if (end != s)
+		return (*end == '\0' && n > 0 && n < NSIG ? (int)n : -1);
+	s += strncmp(s, "SIG", 3) == 0 ? 3 : 0;
+	if (strlen(s) + 3 > sizeof(key) || strchr(s, ':') != NULL)
+		return (-1);
+	sprintf(key, ":%s:", s);
+	p = strstr(names, key);
+	if (p == NULL)
+		return (-1);
+	for (; p > names; p--)
+		sig += *p == ':';
+	return (sig);
+}
+
+/**
+ * timeout_opts - parses the arguments of the timeout builtin
+ * @args: the arguments, args[0] being "timeout"
+ * @sp: the settings
+ * Return: index of the command, -1 on a usage error
+ *
+ * The options may come before or after the duration.
+ */
+static int timeout_opts(char **args, spawn_t *sp)
+{
+	const char *arg;
+	int i, dur = 0, dd;
+
+	for (i = 1; args[i] != NULL; i++)
+	{
+		dd = strcmp(args[i], "--") == 0;
+		i += dd;
+		if (args[i] == NULL || (dur && (dd || args[i][0] != '-')))
+			break;
+		if (dd || args[i][0] != '-')
+		{
+			sp->timeout_ms = timeout_dur(args[i]);
+			if (sp->timeout_ms < 0)
+				return (-1);
+			dur = 1;
+			continue;
+		}
+		arg = args[i][2] != '\0' ? args[i] + 2 : args[i + 1];
+		if (arg == NULL)
+			return (-1);
+		if (args[i][1] == 's' && (sp->tsig = timeout_sig(arg)) < 0)
+			return (-1);
+		if (args[i][1] == 'k' && (sp->kill_ms = timeout_dur(arg)) < 0)
+			return (-1);
+		if (args[i][1] != 's' && args[i][1] != 'k')
+			return (-1);
+		i += arg == args[i + 1];
+	}
+	return (dur && args[i] != NULL ? i : -1);
+}
+
+/**
+ * handle_timeout - runs a command with a time limit
+ * @args: "timeout", the duration, the options and the command
+ * @shell_name: name of the shell
+ * @command_count: line number, for messages
+ * @status: exit status of the last command
+ * @input: the input line, for exit
+ * Return: exit status of the command, 124 if it ran out of time, 137 if
+ * it then had to be killed, 125 on a usage error
+ *
+ * Usage: timeout DURATION [-s SIG] [-k KILLAFTER] [--] command
+ * The time limit applies to each external command the builtin runs; a
+ * duration of 0 runs the command without one.
+ */
+int handle_timeout(char *args[], const char *shell_name, int command_count,
+int status, char *input)
+{
+	spawn_t saved = g_sh.spawn, *sp = &g_sh.spawn;
+	int i;
+
+	sp->tsig = SIGTERM;
+	sp->kill_ms = 0;
+	i = timeout_opts(args, sp);
+	if (i < 0)
+	{
+		fprintf(stderr, "%s: %d: timeout: usage: timeout DURATION "
+			"[-s SIG] [-k KILLAFTER] [--] command\n",
+			shell_name, command_count);
+		g_sh.spawn = saved;
+		return (125);
+	}
+	status = chK(args + i, shell_name, command_count, status, input);
+	saved.maxrss = sp->maxrss;
+	saved.cpu_us = sp->cpu_us;
+	g_sh.spawn = saved;
+	return (status);
+}
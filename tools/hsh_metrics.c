@@ -0,0 +1,148 @@
+#include "../shell.h"
+
+/**
+ * struct family_s - a metric exported from the metrics block
+ * @name: Prometheus name of the metric
+ * @type: "counter" or "gauge"
+ * @help: description
+ * @off: offset of the counter in metrics_t
+ * @scale: divisor applied to the counter, 1 for plain counts
+ */
+typedef struct family_s
+{
+	const char *name;
+	const char *type;
+	const char *help;
+	size_t off;
+	double scale;
+} family_t;
+
+static const family_t families[] = {
+	{"hsh_commands_started_total", "counter", "Commands started.",
+		offsetof(metrics_t, started), 1},
+	{"hsh_commands_finished_total", "counter",
+		"Commands that returned to the shell.",
+		offsetof(metrics_t, finished), 1},
+	{"hsh_commands_failed_total", "counter",
+		"Commands that finished with a nonzero status.",
+		offsetof(metrics_t, failed), 1},
+	{"hsh_builtins_total", "counter", "Commands run by the shell itself.",
+		offsetof(metrics_t, builtins), 1},
+	{"hsh_externals_total", "counter", "External commands started.",
+		offsetof(metrics_t, externals), 1},
+	{"hsh_spawn_seconds_total", "counter",
+		"Time spent creating children.",
+		offsetof(metrics_t, spawn_ns), 1e9},
+	{"hsh_wait_seconds_total", "counter",
+		"Time spent waiting for children.",
+		offsetof(metrics_t, wait_ns), 1e9},
+	{"hsh_jobs", "gauge", "Children currently running.",
+		offsetof(metrics_t, jobs), 1},
+	{"hsh_lookups_total", "counter", "Command lookups in PATH.",
+		offsetof(metrics_t, lookups), 1},
+	{"hsh_lookup_hits_total", "counter",
+		"Command lookups answered by the lookup cache.",
+		offsetof(metrics_t, hits), 1},
+	{NULL, NULL, NULL, 0, 0}
+};
+
+/**
+ * metrics_map - maps the metrics block of a shell
+ * @file: the file given to --metrics; a bare name is looked up in /dev/shm
+ * Return: the block, or NULL with a message on failure
+ */
+static metrics_t *metrics_map(const char *file)
+{
+	char path[PATH_MAX];
+	struct stat st;
+	metrics_t *m = MAP_FAILED;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s%s",
+		strchr(file, '/') != NULL ? "" : "/dev/shm/", file);
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0 && fstat(fd, &st) == 0 &&
+		st.st_size >= (off_t)sizeof(*m))
+		m = mmap(NULL, sizeof(*m), PROT_READ, MAP_SHARED, fd, 0);
+	if (fd >= 0)
+		close(fd);
+	if (m != MAP_FAILED && (memcmp(m->magic, METRICS_MAGIC, 8) != 0 ||
+		m->size != sizeof(*m)))
+	{
+		munmap(m, sizeof(*m));
+		m = MAP_FAILED;
+	}
+	if (m == MAP_FAILED)
+		fprintf(stderr, "hsh_metrics: %s: %s\n", file,
+			fd < 0 ? strerror(errno) : "not a metrics block");
+	return (m == MAP_FAILED ? NULL : m);
+}
+
+/**
+ * print_family - prints one metric for every shell
+ * @f: the metric
+ * @m: the mapped blocks
+ * @n: number of @m
+ */
+static void print_family(const family_t *f, metrics_t **m, int n)
+{
+	uint64_t v;
+	int i;
+
+	printf("# HELP %s %s\n# TYPE %s %s\n", f->name, f->help, f->name,
+		f->type);
+	for (i = 0; i < n; i++)
+	{
+		v = __atomic_load_n((uint64_t *)((char *)m[i] + f->off),
+			__ATOMIC_RELAXED);
+		if (f->off == offsetof(metrics_t, jobs))
+			printf("%s{pid=\"%d\"} %ld\n", f->name, (int)m[i]->pid,
+				(long)(int64_t)v);
+		else if (f->scale != 1)
+			printf("%s{pid=\"%d\"} %.9f\n", f->name, (int)m[i]->pid,
+				v / f->scale);
+		else
+			printf("%s{pid=\"%d\"} %lu\n", f->name, (int)m[i]->pid,
+				(unsigned long)v);
+	}
+}
+
+/**
+ * main - dumps the metrics blocks of running shells for Prometheus
+ * @argc: number of arguments
+ * @argv: the files given to "hsh --metrics"
+ * Return: 0 on success, 1 if a block could not be read, 2 on usage errors
+ *
+ * Usage: hsh_metrics file...
+ * Build: gcc -std=gnu89 -o hsh_metrics tools/hsh_metrics.c
+ */
+int main(int argc, char *argv[])
+{
+	metrics_t **m = calloc(argc, sizeof(*m));
+	uint64_t look, hits;
+	int i, n = 0, status = 0;
+
+	if (argc < 2 || m == NULL)
+	{
+		fprintf(stderr, "usage: hsh_metrics file...\n");
+		return (2);
+	}
+	for (i = 1; i < argc; i++)
+		if ((m[n] = metrics_map(argv[i])) != NULL)
+			n++;
+		else
+			status = 1;
+	for (i = 0; families[i].name != NULL; i++)
+		print_family(&families[i], m, n);
+	printf("# HELP hsh_lookup_hit_ratio Share of command lookups "
+		"answered by the lookup cache.\n"
+		"# TYPE hsh_lookup_hit_ratio gauge\n");
+	for (i = 0; i < n; i++)
+	{
+		look = __atomic_load_n(&m[i]->lookups, __ATOMIC_RELAXED);
+		hits = __atomic_load_n(&m[i]->hits, __ATOMIC_RELAXED);
+		printf("hsh_lookup_hit_ratio{pid=\"%d\"} %.4f\n",
+			(int)m[i]->pid, look ? (double)hits / look : 0.0);
+	}
+	return (status);
+}
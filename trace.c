@@ -0,0 +1,109 @@
+#include "shell.h"
+
+/**
+ * trace_flush - writes out the buffered events
+ */
+static void trace_flush(void)
+{
+	trace_t *t = g_sh.trace;
+	size_t off = 0;
+	ssize_t w;
+
+	if (t == NULL)
+		return;
+	while (off < t->buf.len)
+	{
+		w = write(t->fd, t->buf.s + off, t->buf.len - off);
+		if (w < 0 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			break;
+		off += w;
+	}
+	t->buf.len = 0;
+}
+
+/**
+ * trace_close - writes the rest of the trace and ends its JSON array
+ *
+ * Registered with atexit, so forked children that exit instead of
+ * exec'ing leave the trace of their parent alone.
+ */
+static void trace_close(void)
+{
+	trace_t *t = g_sh.trace;
+
+	if (t == NULL || t->pid != getpid())
+		return;
+	wbuf_put(&t->buf, "\n]\n", 3);
+	trace_flush();
+	close(t->fd);
+	free(t->buf.s);
+	g_sh.trace = NULL;
+}
+
+/**
+ * trace_open - starts recording a Chrome trace for --trace-events
+ * @file: the trace file
+ * @shell_name: name of the shell, for messages
+ * Return: 0 on success, -1 on failure
+ *
+ * Events are kept in memory and written TRACE_CHUNK bytes at a time, so
+ * tracing barely slows down the commands it times.
+ */
+int trace_open(const char *file, const char *shell_name)
+{
+	static trace_t t;
+
+	t.fd = open(file, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (t.fd < 0 || wbuf_put(&t.buf, "[\n", 2) != 0)
+	{
+		fprintf(stderr, "%s: 0: --trace-events: %s: %s\n", shell_name,
+			file, strerror(errno));
+		return (-1);
+	}
+	t.pid = getpid();
+	g_sh.trace = &t;
+	atexit(trace_close);
+	return (0);
+}
+
+/**
+ * trace_head - starts an event with the fields every event has
+ * @ph: the event phase, 'B', 'E' or 'M'
+ * @cat: category of the event
+ * @name: name of the event
+ * @tid: track of the event, a process id
+ * Return: the buffer, for the caller to add the args and close the event
+ */
+wbuf_t *trace_head(int ph, const char *cat, const char *name, pid_t tid)
+{
+	trace_t *t = g_sh.trace;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	if (t->buf.len >= TRACE_CHUNK)
+		trace_flush();
+	wbuf_printf(&t->buf, "%s{\"ph\":\"%c\",\"cat\":\"%s\",\"name\":",
+		t->n++ > 0 ? ",\n" : "", ph, cat);
+	json_put(&t->buf, name);
+	wbuf_printf(&t->buf, ",\"pid\":%d,\"tid\":%d,\"ts\":%lu.%03lu,"
+		"\"args\":{", (int)g_sh.pid, (int)tid,
+		(unsigned long)ts.tv_sec * 1000000UL + ts.tv_nsec / 1000,
+		(unsigned long)ts.tv_nsec % 1000);
+	return (&t->buf);
+}
+
+/**
+ * trace_begin - records the start of a command, stage or job
+ * @cat: category, such as "cmd" or "job"
+ * @name: name of the event, usually argv[0]
+ * @tid: track of the event, a process id
+ * @line: line number the command is on
+ */
+void trace_begin(const char *cat, const char *name, pid_t tid, int line)
+{
+	if (g_sh.trace != NULL)
+		wbuf_printf(trace_head('B', cat, name, tid), "\"line\":%d}}",
+			line);
+}
@@ -0,0 +1,80 @@
+#include "shell.h"
+
+/**
+ * trace_end - records the end of a command, stage or job
+ * @cat: category given to trace_begin
+ * @name: name given to trace_begin
+ * @tid: track given to trace_begin
+ * @status: its exit status
+ */
+void trace_end(const char *cat, const char *name, pid_t tid, int status)
+{
+	if (g_sh.trace != NULL)
+		wbuf_printf(trace_head('E', cat, name, tid),
+			"\"status\":%d}}", status);
+}
+
+/**
+ * trace_fd - adds what a standard descriptor of the shell is connected to
+ * @b: the buffer
+ * @fd: the descriptor
+ * @key: name of the field
+ */
+static void trace_fd(wbuf_t *b, int fd, const char *key)
+{
+	char link[32], to[PATH_MAX];
+	ssize_t n;
+
+	sprintf(link, "/proc/self/fd/%d", fd);
+	n = readlink(link, to, sizeof(to) - 1);
+	to[n > 0 ? n : 0] = '\0';
+	wbuf_printf(b, ",\"%s\":", key);
+	json_put(b, n > 0 ? to : "closed");
+}
+
+/**
+ * trace_stage - records the start of a process, or of a pipeline stage
+ * @cat: category of the event, such as "proc" or "stage"
+ * @name: name of the event
+ * @tid: the process; the shell's own pid for a stage it runs itself
+ * @in: standard input of the process, -1 for that of the shell
+ * @out: standard output of the process, -1 for that of the shell
+ * @err: standard error of the process, -1 for that of the shell
+ *
+ * A child gets a track of its own. What its standard descriptors are
+ * connected to is recorded with the event, so the pipes between stages
+ * can be matched up. trace_end closes the event once it is reaped.
+ */
+void trace_stage(const char *cat, const char *name, pid_t tid, int in,
+int out, int err)
+{
+	wbuf_t *b;
+
+	if (g_sh.trace == NULL)
+		return;
+	if (tid != g_sh.pid)
+	{
+		wbuf_put(trace_head('M', cat, "thread_name", tid),
+			"\"name\":", 7);
+		json_put(&g_sh.trace->buf, name);
+		wbuf_put(&g_sh.trace->buf, "}}", 2);
+	}
+	wbuf_printf(b = trace_head('B', cat, name, tid), "\"pid\":%d",
+		(int)tid);
+	trace_fd(b, in >= 0 ? in : 0, "stdin");
+	trace_fd(b, out >= 0 ? out : 1, "stdout");
+	trace_fd(b, err >= 0 ? err : 2, "stderr");
+	wbuf_put(b, "}}", 2);
+}
+
+/**
+ * trace_spawn - records the start of a child on a track of its own
+ * @name: argv[0] of the child
+ * @pid: the child
+ *
+ * The child inherits the standard descriptors of the shell.
+ */
+void trace_spawn(const char *name, pid_t pid)
+{
+	trace_stage("proc", name, pid, -1, -1, -1);
+}
@@ -0,0 +1,92 @@
+#include "shell.h"
+
+/**
+ * trie_node - allocates a trie node
+ * @t: the trie
+ * @c: the byte leading to the node
+ * Return: index of the node, -1 on failure
+ */
+static int trie_node(trie_t *t, unsigned char c)
+{
+	tnode_t *n;
+	int cap;
+
+	if (t->len == t->cap)
+	{
+		cap = t->cap ? t->cap * 2 : 1024;
+		n = realloc(t->n, cap * sizeof(*n));
+		if (n == NULL)
+			return (-1);
+		t->n = n;
+		t->cap = cap;
+	}
+	n = &t->n[t->len];
+	n->kid = -1;
+	n->next = -1;
+	n->nterm = 0;
+	n->nsub = 0;
+	n->c = c;
+	return (t->len++);
+}
+
+/**
+ * trie_child - finds the child of a node for a byte
+ * @t: the trie
+ * @at: the node
+ * @c: the byte
+ * @make: nonzero to add the child when it is missing
+ * Return: index of the child, -1 if missing or on failure
+ *
+ * Siblings are kept in byte order so that names come out sorted.
+ */
+static int trie_child(trie_t *t, int at, unsigned char c, int make)
+{
+	int prev = -1, k = t->n[at].kid, nk;
+
+	while (k >= 0 && t->n[k].c < c)
+	{
+		prev = k;
+		k = t->n[k].next;
+	}
+	if (k >= 0 && t->n[k].c == c)
+		return (k);
+	if (!make)
+		return (-1);
+	nk = trie_node(t, c);
+	if (nk < 0)
+		return (-1);
+	t->n[nk].next = k;
+	if (prev < 0)
+		t->n[at].kid = nk;
+	else
+		t->n[prev].next = nk;
+	return (nk);
+}
+
+/**
+ * trie_add - adds or removes one source of a name
+ * @t: the trie
+ * @s: the name
+ * @delta: 1 to add a source, -1 to remove one
+ * Return: 0 on success, -1 on failure or when removing a missing name
+ */
+int trie_add(trie_t *t, const char *s, int delta)
+{
+	const char *p;
+	int at = 0;
+
+	if (t->len == 0 && trie_node(t, 0) < 0)
+		return (-1);
+	for (p = s; *p && at >= 0; p++)
+		at = trie_child(t, at, *p, delta > 0);
+	if (at < 0 || t->n[at].nterm + delta < 0)
+		return (-1);
+	t->n[at].nterm += delta;
+	t->n[0].nsub += delta;
+	for (at = 0, p = s; *p; p++)
+	{
+		at = trie_child(t, at, *p, 0);
+		t->n[at].nsub += delta;
+	}
+	return (0);
+}
@@ -0,0 +1,84 @@
+#include "shell.h"
+
+/**
+ * trie_find - finds the node a prefix leads to
+ * @t: the trie
+ * @s: the prefix
+ * @len: length of @s
+ * Return: the node, -1 when no name starts with @s
+ */
+int trie_find(trie_t *t, const char *s, size_t len)
+{
+	int at = 0, k;
+	size_t i;
+	unsigned char c;
+
+	if (t->len == 0)
+		return (-1);
+	for (i = 0; i < len && at >= 0; i++)
+	{
+		c = s[i];
+		for (k = t->n[at].kid; k >= 0 && t->n[k].c < c;)
+			k = t->n[k].next;
+		at = k >= 0 && t->n[k].c == c ? k : -1;
+	}
+	return (at >= 0 && t->n[at].nsub > 0 ? at : -1);
+}
+
+/**
+ * trie_lcp - extends a prefix as long as every name shares the extension
+ * @t: the trie
+ * @at: node of the prefix
+ * @name: the prefix, extended in place
+ * Return: the node the extended prefix leads to
+ */
+int trie_lcp(trie_t *t, int at, wbuf_t *name)
+{
+	int k, only;
+
+	while (t->n[at].nterm == 0)
+	{
+		only = -1;
+		for (k = t->n[at].kid; k >= 0; k = t->n[k].next)
+			if (t->n[k].nsub > 0)
+			{
+				if (only >= 0)
+					return (at);
+				only = k;
+			}
+		if (only < 0 || wbuf_putc(name, t->n[only].c) != 0)
+			return (at);
+		at = only;
+	}
+	return (at);
+}
+
+/**
+ * trie_collect - lists the names below a node in byte order
+ * @t: the trie
+ * @at: the node
+ * @name: the name of @at; restored before returning
+ * @out: receives the names, NUL terminated back to back
+ * @max: most names to list
+ * Return: number of names listed
+ */
+int trie_collect(trie_t *t, int at, wbuf_t *name, wbuf_t *out, int max)
+{
+	size_t len = name->len;
+	int n = 0, k;
+
+	if (t->n[at].nterm > 0 && max > 0)
+	{
+		if (wbuf_put(out, name->s, len) != 0 || wbuf_putc(out, '\0'))
+			return (0);
+		n++;
+	}
+	for (k = t->n[at].kid; k >= 0 && n < max; k = t->n[k].next)
+	{
+		if (t->n[k].nsub == 0 || wbuf_putc(name, t->n[k].c) != 0)
+			continue;
+		n += trie_collect(t, k, name, out, max - n);
+		name->len = len;
+	}
+	return (n);
+}
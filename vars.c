@@ -0,0 +1,96 @@
+#include "shell.h"
+
+/**
+ * var_lookup - looks up a variable
+ * @name: name of the variable
+ * Return: the variable, or NULL when it is unset
+ */
+var_t *var_lookup(const char *name)
+{
+	hent_t *e = ht_find(&g_sh.vars, name);
+
+	if (g_sh.snap > 0)
+		snap_read(name, e != NULL ? e->val : NULL);
+	return (e != NULL ? e->val : NULL);
+}
+
+/**
+ * var_get - looks up the value of a variable
+ * @name: name of the variable
+ * Return: the value, or NULL when the variable is unset
+ */
+const char *var_get(const char *name)
+{
+	var_t *v = var_lookup(name);
+
+	return (v != NULL ? v->value : NULL);
+}
+
+/**
+ * var_getn - looks up a variable whose name is not NUL terminated
+ * @name: start of the name
+ * @len: length of the name
+ * Return: the value, or NULL when the variable is unset
+ */
+const char *var_getn(const char *name, size_t len)
+{
+	char key[256];
+
+	if (len >= sizeof(key))
+		return (NULL);
+	memcpy(key, name, len);
+	key[len] = '\0';
+	return (var_get(key));
+}
+
+/**
+ * var_set - assigns a variable, keeping the environment in step
+ * @name: name of the variable
+ * @value: the value, copied
+ * @export: nonzero to also export the variable
+ * Return: 0 on success, -1 on failure
+ */
+int var_set(const char *name, const char *value, int export)
+{
+	hent_t *e = ht_insert(&g_sh.vars, name);
+	var_t *v;
+	char *copy = strdup(value);
+
+	if (e == NULL || copy == NULL)
+	{
+		free(copy);
+		return (-1);
+	}
+	v = e->val;
+	if (v == NULL && (v = calloc(1, sizeof(*v))) == NULL)
+	{
+		free(copy);
+		ht_remove(&g_sh.vars, name);
+		return (-1);
+	}
+	free(v->value);
+	v->value = copy;
+	v->exported |= export;
+	e->val = v;
+	if (v->exported)
+		setenv(name, copy, 1);
+	return (0);
+}
+
+/**
+ * var_unset - removes a variable and its environment entry
+ * @name: name of the variable
+ * Return: 0 if the variable existed, -1 otherwise
+ */
+int var_unset(const char *name)
+{
+	var_t *v = ht_remove(&g_sh.vars, name);
+
+	if (v == NULL)
+		return (-1);
+	if (v->exported)
+		unsetenv(name);
+	free(v->value);
+	free(v);
+	return (0);
+}
@@ -0,0 +1,100 @@
+#include "shell.h"
+
+/**
+ * vars_import - loads the environment into the variable store
+ */
+void vars_import(void)
+{
+	char **env, *eq;
+	var_t *v;
+
+	for (env = environ; *env != NULL; env++)
+	{
+		eq = strchr(*env, '=');
+		if (eq == NULL)
+			continue;
+		*eq = '\0';
+		if (var_lookup(*env) == NULL && var_set(*env, eq + 1, 0) == 0)
+		{
+			v = var_lookup(*env);
+			v->exported = 1;
+		}
+		*eq = '=';
+	}
+}
+
+/**
+ * assign_len - checks if a word is an assignment
+ * @word: the word as read by the lexer
+ * Return: length of the variable name if @word is NAME=value, else 0
+ */
+size_t assign_len(const char *word)
+{
+	size_t n = name_len(word, word + strlen(word));
+
+	return (n > 0 && word[n] == '=' ? n : 0);
+}
+
+/**
+ * handle_export - handles the built-in "export" command
+ * @args: array of arguments for the command
+ * @shell_name: the name of the shell (e.g., "sh")
+ * @command_count: the count of commands entered since shell execution
+ * Return: 0 on success, 2 on a bad variable name
+ */
+int handle_export(char *args[], const char *shell_name, int command_count)
+{
+	char **env, *eq;
+	const char *v;
+	int status = 0;
+
+	for (env = environ; args[1] == NULL && *env != NULL; env++)
+		printf("export %s\n", *env);
+	while (*++args != NULL)
+	{
+		eq = strchr(*args, '=');
+		if (eq != NULL)
+			*eq = '\0';
+		if (!is_name(*args))
+		{
+			fprintf(stderr, "%s: %d: export: %s: %s\n", shell_name,
+				command_count, *args, "bad variable name");
+			status = 2;
+		}
+		else if (eq != NULL)
+			var_set(*args, eq + 1, 1);
+		else if ((v = var_get(*args)) != NULL)
+			var_set(*args, v, 1);
+		if (eq != NULL)
+			*eq = '=';
+	}
+	return (status);
+}
+
+/**
+ * handle_unset - handles the built-in "unset" command
+ * @args: array of arguments for the command
+ * @shell_name: the name of the shell (e.g., "sh")
+ * @command_count: the count of commands entered since shell execution
+ * Return: 0 on success, 2 on a bad variable name
+ */
+int handle_unset(char *args[], const char *shell_name, int command_count)
+{
+	int funcs = 0, status = 0;
+
+	if (args[1] != NULL && (strcmp(args[1], "-f") == 0 ||
+		strcmp(args[1], "-v") == 0))
+		funcs = (args++)[1][1] == 'f';
+	while (*++args != NULL)
+		if (funcs)
+			func_unset(*args);
+		else if (!is_name(*args))
+		{
+			fprintf(stderr, "%s: %d: unset: %s: %s\n", shell_name,
+				command_count, *args, "bad variable name");
+			status = 2;
+		}
+		else
+			var_unset(*args);
+	return (status);
+}
@@ -0,0 +1,99 @@
+#include "shell.h"
+
+/**
+ * wbuf_grow - makes room for more bytes plus a terminating NUL
+ * @b: the buffer
+ * @more: number of bytes about to be appended
+ * Return: 0 on success, -1 on failure
+ */
+int wbuf_grow(wbuf_t *b, size_t more)
+{
+	size_t cap = b->cap ? b->cap : 64;
+	char *p;
+
+	while (cap < b->len + more + 1)
+		cap *= 2;
+	if (cap == b->cap)
+		return (0);
+	p = realloc(b->s, cap);
+	if (p == NULL)
+		return (-1);
+	b->s = p;
+	b->cap = cap;
+	return (0);
+}
+
+/**
+ * wbuf_putc - appends one byte
+ * @b: the buffer
+ * @c: the byte
+ * Return: 0 on success, -1 on failure
+ */
+int wbuf_putc(wbuf_t *b, int c)
+{
+	if (b->len + 1 >= b->cap && wbuf_grow(b, 1) != 0)
+		return (-1);
+	b->s[b->len++] = c;
+	b->s[b->len] = '\0';
+	return (0);
+}
+
+/**
+ * wbuf_put - appends bytes
+ * @b: the buffer
+ * @s: the bytes
+ * @n: number of bytes
+ * Return: 0 on success, -1 on failure
+ */
+int wbuf_put(wbuf_t *b, const char *s, size_t n)
+{
+	if (wbuf_grow(b, n) != 0)
+		return (-1);
+	memcpy(b->s + b->len, s, n);
+	b->len += n;
+	b->s[b->len] = '\0';
+	return (0);
+}
+
+/**
+ * wbuf_printf - appends formatted text
+ * @b: the buffer
+ * @fmt: printf format
+ * Return: 0 on success, -1 on failure
+ */
+int wbuf_printf(wbuf_t *b, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	va_start(ap, fmt);
+	n = vsnprintf(NULL, 0, fmt, ap);
+	va_end(ap);
+	if (n < 0 || wbuf_grow(b, n) != 0)
+		return (-1);
+	va_start(ap, fmt);
+	vsnprintf(b->s + b->len, n + 1, fmt, ap);
+	va_end(ap);
+	b->len += n;
+	return (0);
+}
+
+/**
+ * json_put - appends a string as a JSON string literal
+ * @b: the buffer
+ * @s: the string
+ * Return: 0 on success, -1 on failure
+ */
+int json_put(wbuf_t *b, const char *s)
+{
+	int r = wbuf_putc(b, '"');
+
+	for (; r == 0 && *s != '\0'; s++)
+		if (*s == '"' || *s == '\\')
+			r = wbuf_putc(b, '\\') | wbuf_putc(b, *s);
+		else if ((unsigned char)*s < 0x20)
+			r = wbuf_printf(b, "\\u%04x", (unsigned char)*s);
+		else
+			r = wbuf_putc(b, *s);
+	return (r | wbuf_putc(b, '"'));
+}